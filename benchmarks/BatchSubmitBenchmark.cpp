@@ -0,0 +1,116 @@
+/**
+ * @file BatchSubmitBenchmark.cpp
+ * @brief Compares per-job submit with submitBatch for batch sizes from 1 to 1M jobs.
+ *
+ * Each measurement submits the same total number of jobs to a running direct-dispatch
+ * scheduler whose workers are idle and whose queue already holds a backlog of delayed jobs.
+ * The submitted jobs are due shortly after the measurement ends, so the reported rate covers
+ * locking, heap insertion and worker wake-ups, but not execution.
+ */
+
+#include "JobScheduler.hpp"
+#include "ThreadPool.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <thread>
+#include <vector>
+
+using namespace scheduleit;
+using namespace std::chrono;
+
+namespace {
+
+constexpr size_t kTotalJobs = 1 << 20;
+constexpr size_t kBacklog = 100000;
+
+double submitThroughput(size_t batch_size, bool batched) {
+    SchedulerOptions options;
+    options.dispatch = DispatchMode::Direct;
+    JobScheduler scheduler(4, options);
+    auto noop = []() {};
+
+    // A backlog that stays queued for the whole measurement.
+    std::vector<std::shared_ptr<Job>> backlog;
+    for (size_t i = 0; i < kBacklog; ++i) {
+        backlog.push_back(Job::create("", noop, nullptr, seconds(3), 0));
+    }
+    scheduler.submitBatch(std::move(backlog));
+    scheduler.start();
+    std::this_thread::sleep_for(milliseconds(50));  // let the workers go idle
+
+    // Jobs due soon after submission ends, in random order so that heap inserts do not get
+    // the best case of ascending deadlines.
+    std::mt19937 rng(42);
+    std::uniform_int_distribution<int> delay_ms(1000, 1999);
+    std::vector<std::shared_ptr<Job>> jobs;
+    jobs.reserve(kTotalJobs);
+    for (size_t i = 0; i < kTotalJobs; ++i) {
+        jobs.push_back(Job::create("", noop, nullptr, milliseconds(delay_ms(rng)), 0));
+    }
+
+    auto start = steady_clock::now();
+    if (batched) {
+        std::vector<std::shared_ptr<Job>> batch;
+        for (size_t offset = 0; offset < kTotalJobs; offset += batch_size) {
+            batch.assign(jobs.begin() + static_cast<std::ptrdiff_t>(offset),
+                         jobs.begin() + static_cast<std::ptrdiff_t>(std::min(kTotalJobs, offset + batch_size)));
+            scheduler.submitBatch(std::move(batch));
+            batch.clear();
+        }
+    } else {
+        for (auto& job : jobs) {
+            scheduler.submit(job);
+        }
+    }
+    double elapsed = duration<double>(steady_clock::now() - start).count();
+    scheduler.shutdown();
+    return kTotalJobs / elapsed;
+}
+
+double poolThroughput(size_t batch_size, bool bulk) {
+    ThreadPool pool(4);
+    std::atomic<size_t> done{0};
+    auto start = steady_clock::now();
+    if (bulk) {
+        std::vector<UniqueFunction<void()>> batch;
+        for (size_t offset = 0; offset < kTotalJobs; offset += batch_size) {
+            size_t end = std::min(kTotalJobs, offset + batch_size);
+            for (size_t i = offset; i < end; ++i) {
+                batch.emplace_back([&done]() { done.fetch_add(1, std::memory_order_relaxed); });
+            }
+            pool.submitBulk(batch.begin(), batch.end());
+            batch.clear();
+        }
+    } else {
+        for (size_t i = 0; i < kTotalJobs; ++i) {
+            pool.submitDetached([&done]() { done.fetch_add(1, std::memory_order_relaxed); });
+        }
+    }
+    while (done.load() < kTotalJobs) {
+        std::this_thread::yield();
+    }
+    double seconds = duration<double>(steady_clock::now() - start).count();
+    return kTotalJobs / seconds;
+}
+
+}
+
+int main() {
+    std::cout << "JobScheduler, " << kTotalJobs << " jobs on a backlog of " << kBacklog << " (Mjobs/s submitted)\n";
+    std::cout << "  submit           " << submitThroughput(1, false) / 1e6 << "\n";
+    for (size_t batch : {size_t{1}, size_t{64}, size_t{4096}, kTotalJobs}) {
+        std::cout << "  submitBatch " << batch << "  " << submitThroughput(batch, true) / 1e6 << "\n";
+    }
+
+    std::cout << "ThreadPool, " << kTotalJobs << " tasks (Mtasks/s submitted and run)\n";
+    std::cout << "  submitDetached   " << poolThroughput(1, false) / 1e6 << "\n";
+    for (size_t batch : {size_t{1}, size_t{64}, size_t{4096}, kTotalJobs}) {
+        std::cout << "  submitBulk " << batch << "  " << poolThroughput(batch, true) / 1e6 << "\n";
+    }
+    return 0;
+}
@@ -0,0 +1,584 @@
+/**
+ * @file BenchmarkSuite.cpp
+ * @brief Micro-benchmarks of the scheduler's hot paths, reported as JSON for regression tracking.
+ *
+ * Each case runs a fixed workload several times and reports the median of every metric, so
+ * one noisy repetition does not move the result. The cases are:
+ *   job_queue/...          enqueue and dequeue of due jobs on a JobQueue, per backend,
+ *   thread_pool/...        ThreadPool::submit, submitDetached and work-stealing submit cost,
+ *   latency/...            submit-to-start latency percentiles of a paced stream of jobs,
+ *   throughput/noop        end-to-end throughput of no-op jobs submitted before start(),
+ *   throughput/noop_ids    the same with a distinct id per job, which the completion tracker indexes,
+ *   delayed/...            many jobs delayed over a second: submit cost and firing lateness,
+ *   retry_storm/...        every job fails a few times and retries with a short backoff,
+ *   contention/...         several producer threads submitting to one scheduler, the _ids cases
+ *                          with a distinct id per job.
+ *
+ * The JSON document goes to stdout, or to --out; a readable summary goes to stderr. Times are
+ * in nanoseconds unless a metric's name says otherwise. --scale multiplies every job count
+ * and delay window, so --scale=0.01 is a quick smoke run.
+ *
+ * Usage: benchmarks [--filter=substring] [--repetitions=3] [--scale=1] [--workers=N]
+ *                   [--label=text] [--out=file.json] [--list]
+ */
+
+#include "FixedRetryStrategy.hpp"
+#include "JobQueue.hpp"
+#include "JobScheduler.hpp"
+#include "ThreadPool.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <ctime>
+#include <fstream>
+#include <functional>
+#include <future>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+using namespace scheduleit;
+using namespace std::chrono;
+
+namespace {
+
+using Metrics = std::map<std::string, double>;
+using Params = std::map<std::string, double>;  // workload sizes, all numeric
+
+struct Settings {
+    std::string filter;
+    int repetitions = 3;
+    double scale = 1;
+    size_t workers = std::max(2u, std::thread::hardware_concurrency());
+    std::string label;
+    std::string out;
+    bool list = false;
+
+    size_t scaled(size_t count) const {
+        return std::max<size_t>(1, static_cast<size_t>(count * scale));
+    }
+};
+
+struct Case {
+    std::string name;
+    Params params;
+    std::function<Metrics()> run;
+};
+
+struct Result {
+    const Case* source;
+    Metrics median;
+    Metrics min;
+    Metrics max;
+};
+
+double nanosPer(steady_clock::duration elapsed, size_t count) {
+    return duration<double, std::nano>(elapsed).count() / std::max<size_t>(count, 1);
+}
+
+double perSecond(size_t count, steady_clock::duration elapsed) {
+    return count / std::max(duration<double>(elapsed).count(), 1e-9);
+}
+
+double percentile(std::vector<double>& values, double p) {
+    if (values.empty()) {
+        return 0;
+    }
+    std::sort(values.begin(), values.end());
+    return values[static_cast<size_t>(p * (values.size() - 1))];
+}
+
+std::shared_ptr<Job> noopJob(std::chrono::milliseconds delay = milliseconds(0), std::string id = "") {
+    return Job::create(std::move(id), []() {}, nullptr, delay, 0);
+}
+
+// --- job_queue ---------------------------------------------------------------------------
+
+Metrics queueEnqueueDequeue(QueueOptions options, size_t jobs) {
+    JobQueue queue(options);
+    std::vector<std::shared_ptr<Job>> prepared;
+    prepared.reserve(jobs);
+    for (size_t i = 0; i < jobs; ++i) {
+        prepared.push_back(noopJob());
+    }
+    auto start = steady_clock::now();
+    for (auto& job : prepared) {
+        queue.enqueue(std::move(job));
+    }
+    auto filled = steady_clock::now();
+    size_t popped = 0;
+    while (queue.dequeueReady()) {
+        ++popped;
+    }
+    auto drained = steady_clock::now();
+    if (popped != jobs) {
+        throw std::runtime_error("JobQueue returned " + std::to_string(popped) + " of " + std::to_string(jobs) + " jobs");
+    }
+    return {{"enqueue_ns", nanosPer(filled - start, jobs)}, {"dequeue_ns", nanosPer(drained - filled, jobs)}};
+}
+
+Metrics queueBatch(size_t jobs) {
+    JobQueue queue;
+    std::vector<std::shared_ptr<Job>> prepared;
+    prepared.reserve(jobs);
+    for (size_t i = 0; i < jobs; ++i) {
+        prepared.push_back(noopJob());
+    }
+    auto start = steady_clock::now();
+    queue.enqueueBatch(prepared);
+    auto filled = steady_clock::now();
+    while (queue.dequeueReady()) {
+    }
+    auto drained = steady_clock::now();
+    return {{"enqueue_ns", nanosPer(filled - start, jobs)}, {"dequeue_ns", nanosPer(drained - filled, jobs)}};
+}
+
+// --- thread_pool -------------------------------------------------------------------------
+
+Metrics poolSubmit(size_t workers, bool futures, bool stealing, size_t tasks) {
+    ThreadPoolOptions options;
+    options.work_stealing = stealing;
+    ThreadPool pool(workers, options);
+    std::atomic<size_t> done{0};
+    std::vector<std::future<void>> results;
+    if (futures) {
+        results.reserve(tasks);
+    }
+    auto start = steady_clock::now();
+    for (size_t i = 0; i < tasks; ++i) {
+        if (futures) {
+            results.push_back(pool.submit([&done]() { done.fetch_add(1, std::memory_order_relaxed); }));
+        } else {
+            pool.submitDetached([&done]() { done.fetch_add(1, std::memory_order_relaxed); });
+        }
+    }
+    auto submitted = steady_clock::now();
+    while (done.load() < tasks) {
+        std::this_thread::yield();
+    }
+    auto finished = steady_clock::now();
+    pool.shutdown();
+    return {{"submit_ns", nanosPer(submitted - start, tasks)}, {"tasks_per_s", perSecond(tasks, finished - start)}};
+}
+
+// --- latency -----------------------------------------------------------------------------
+
+Metrics submitToStart(size_t workers, DispatchMode mode, size_t jobs, microseconds interval) {
+    SchedulerOptions options;
+    options.dispatch = mode;
+    JobScheduler scheduler(workers, options);
+    scheduler.start();
+    std::vector<double> start_ns(jobs);
+    std::atomic<size_t> done{0};
+    for (size_t i = 0; i < jobs; ++i) {
+        double* slot = &start_ns[i];
+        auto submitted = steady_clock::now();
+        scheduler.submit(Job::create("", [slot, submitted, &done]() {
+            *slot = duration<double, std::nano>(steady_clock::now() - submitted).count();
+            done.fetch_add(1, std::memory_order_release);
+        }, nullptr, milliseconds(0), 0));
+        std::this_thread::sleep_for(interval);
+    }
+    while (done.load(std::memory_order_acquire) < jobs) {
+        std::this_thread::sleep_for(microseconds(100));
+    }
+    scheduler.shutdown();
+    return {{"p50_ns", percentile(start_ns, 0.5)},
+            {"p90_ns", percentile(start_ns, 0.9)},
+            {"p99_ns", percentile(start_ns, 0.99)},
+            {"p999_ns", percentile(start_ns, 0.999)},
+            {"max_ns", start_ns.empty() ? 0 : start_ns.back()}};
+}
+
+// --- throughput --------------------------------------------------------------------------
+
+Metrics noopThroughput(size_t workers, size_t jobs, bool ids) {
+    JobScheduler scheduler(workers);
+    std::vector<std::shared_ptr<Job>> prepared;
+    prepared.reserve(jobs);
+    for (size_t i = 0; i < jobs; ++i) {
+        prepared.push_back(noopJob(milliseconds(0), ids ? "job-" + std::to_string(i) : ""));
+    }
+    auto start = steady_clock::now();
+    for (auto& job : prepared) {
+        scheduler.submit(std::move(job));
+    }
+    auto submitted = steady_clock::now();
+    scheduler.start();
+    scheduler.waitForIdle();
+    auto finished = steady_clock::now();
+    scheduler.shutdown();
+    return {{"submit_ns", nanosPer(submitted - start, jobs)},
+            {"run_jobs_per_s", perSecond(jobs, finished - submitted)},
+            {"jobs_per_s", perSecond(jobs, finished - start)}};
+}
+
+// --- delayed -----------------------------------------------------------------------------
+
+Metrics delayedJobs(size_t workers, QueueBackend backend, size_t jobs, milliseconds window) {
+    SchedulerOptions options;
+    options.queue.backend = backend;
+    JobScheduler scheduler(workers, options);
+    scheduler.start();
+    std::mt19937_64 rng(42);
+    std::uniform_int_distribution<long> delay_ms(1, std::max<long>(1, window.count()));
+    std::vector<std::shared_ptr<Job>> prepared;
+    prepared.reserve(jobs);
+    for (size_t i = 0; i < jobs; ++i) {
+        prepared.push_back(noopJob(milliseconds(delay_ms(rng))));
+    }
+    auto start = steady_clock::now();
+    for (auto& job : prepared) {
+        scheduler.submit(std::move(job));
+    }
+    auto submitted = steady_clock::now();
+    scheduler.waitForIdle();
+    MetricsSnapshot metrics = scheduler.getMetrics();
+    scheduler.shutdown();
+    return {{"submit_ns", nanosPer(submitted - start, jobs)},
+            {"lateness_p50_ns", static_cast<double>(metrics.dispatch_lag.percentile(50))},
+            {"lateness_p99_ns", static_cast<double>(metrics.dispatch_lag.percentile(99))},
+            {"lateness_max_ns", static_cast<double>(metrics.dispatch_lag.max)}};
+}
+
+// --- retry_storm -------------------------------------------------------------------------
+
+Metrics retryStorm(size_t workers, size_t jobs, int failures, milliseconds backoff) {
+    JobScheduler scheduler(workers);
+    auto retry_strategy = std::make_shared<FixedRetryStrategy>(backoff);
+    std::atomic<size_t> attempts{0};
+    std::vector<std::shared_ptr<Job>> prepared;
+    prepared.reserve(jobs);
+    for (size_t i = 0; i < jobs; ++i) {
+        auto failed = std::make_shared<int>(0);
+        prepared.push_back(Job::create("", [&attempts, failed, failures]() {
+            attempts.fetch_add(1, std::memory_order_relaxed);
+            if ((*failed)++ < failures) {
+                throw std::runtime_error("transient failure");
+            }
+        }, retry_strategy, milliseconds(0), failures));
+    }
+    scheduler.start();
+    auto start = steady_clock::now();
+    scheduler.submitBatch(std::move(prepared));
+    scheduler.waitForIdle();
+    auto finished = steady_clock::now();
+    MetricsSnapshot metrics = scheduler.getMetrics();
+    scheduler.shutdown();
+    size_t expected = jobs * static_cast<size_t>(failures + 1);
+    if (attempts.load() != expected) {
+        throw std::runtime_error("retry storm ran " + std::to_string(attempts.load()) + " of " +
+                                 std::to_string(expected) + " attempts");
+    }
+    return {{"total_ms", duration<double, std::milli>(finished - start).count()},
+            {"attempts_per_s", perSecond(expected, finished - start)},
+            {"retry_lateness_p99_ns", static_cast<double>(metrics.dispatch_lag.percentile(99))}};
+}
+
+// --- contention --------------------------------------------------------------------------
+
+Metrics multiProducer(size_t workers, size_t producers, size_t shards, size_t jobs, bool ids) {
+    SchedulerOptions options;
+    options.queue.shards = shards;
+    JobScheduler scheduler(workers, options);
+    scheduler.start();
+    size_t per_producer = std::max<size_t>(1, jobs / producers);
+    std::vector<std::vector<std::shared_ptr<Job>>> prepared(producers);
+    size_t next_id = 0;
+    for (auto& jobs_of_producer : prepared) {
+        jobs_of_producer.reserve(per_producer);
+        for (size_t i = 0; i < per_producer; ++i) {
+            jobs_of_producer.push_back(noopJob(milliseconds(0), ids ? "job-" + std::to_string(next_id++) : ""));
+        }
+    }
+    std::atomic<size_t> ready{0};
+    std::atomic<bool> go{false};
+    std::vector<std::thread> threads;
+    for (auto& jobs_of_producer : prepared) {
+        threads.emplace_back([&scheduler, &ready, &go, &jobs_of_producer]() {
+            ready++;
+            while (!go.load()) {
+                std::this_thread::yield();
+            }
+            for (auto& job : jobs_of_producer) {
+                scheduler.submit(std::move(job));
+            }
+        });
+    }
+    while (ready.load() < producers) {
+        std::this_thread::yield();
+    }
+    auto start = steady_clock::now();
+    go = true;
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    auto submitted = steady_clock::now();
+    scheduler.waitForIdle();
+    auto finished = steady_clock::now();
+    scheduler.shutdown();
+    size_t total = per_producer * producers;
+    return {{"submit_ns", nanosPer(submitted - start, total)},
+            {"submits_per_s", perSecond(total, submitted - start)},
+            {"jobs_per_s", perSecond(total, finished - start)}};
+}
+
+std::vector<Case> makeCases(const Settings& settings) {
+    std::vector<Case> cases;
+    size_t workers = settings.workers;
+    auto count = [&settings](size_t jobs) { return settings.scaled(jobs); };
+
+    size_t queue_jobs = count(200000);
+    const std::pair<const char*, QueueOptions> queues[] = {
+        {"heap", QueueOptions{}},
+        {"wheel", [] { QueueOptions o; o.backend = QueueBackend::TimingWheel; return o; }()},
+        {"sharded4", [] { QueueOptions o; o.shards = 4; return o; }()},
+        {"weighted_fair", [] { QueueOptions o; o.priority_policy = PriorityPolicy::WeightedFair; return o; }()},
+    };
+    for (const auto& [name, options] : queues) {
+        cases.push_back({std::string("job_queue/") + name, {{"jobs", queue_jobs}},
+                         [options = options, queue_jobs]() { return queueEnqueueDequeue(options, queue_jobs); }});
+    }
+    cases.push_back({"job_queue/batch", {{"jobs", queue_jobs}}, [queue_jobs]() { return queueBatch(queue_jobs); }});
+
+    size_t tasks = count(200000);
+    cases.push_back({"thread_pool/submit_future", {{"tasks", tasks}, {"workers", workers}},
+                     [=]() { return poolSubmit(workers, true, false, tasks); }});
+    cases.push_back({"thread_pool/submit_detached", {{"tasks", tasks}, {"workers", workers}},
+                     [=]() { return poolSubmit(workers, false, false, tasks); }});
+    cases.push_back({"thread_pool/submit_stealing", {{"tasks", tasks}, {"workers", workers}},
+                     [=]() { return poolSubmit(workers, false, true, tasks); }});
+
+    size_t paced = count(5000);
+    microseconds interval(100);
+    const std::pair<const char*, DispatchMode> modes[] = {{"dispatcher", DispatchMode::Dispatcher},
+                                                          {"direct", DispatchMode::Direct}};
+    for (const auto& [name, mode] : modes) {
+        cases.push_back({std::string("latency/") + name,
+                         {{"jobs", paced}, {"interval_us", interval.count()}, {"workers", workers}},
+                         [=, mode = mode]() { return submitToStart(workers, mode, paced, interval); }});
+    }
+
+    size_t noop = count(500000);
+    cases.push_back({"throughput/noop", {{"jobs", noop}, {"workers", workers}},
+                     [=]() { return noopThroughput(workers, noop, false); }});
+    cases.push_back({"throughput/noop_ids", {{"jobs", noop}, {"workers", workers}},
+                     [=]() { return noopThroughput(workers, noop, true); }});
+
+    size_t delayed = count(200000);
+    milliseconds window(std::max<long>(10, static_cast<long>(1000 * std::min(settings.scale, 1.0))));
+    const std::pair<const char*, QueueBackend> backends[] = {{"heap", QueueBackend::Heap},
+                                                             {"wheel", QueueBackend::TimingWheel}};
+    for (const auto& [name, backend] : backends) {
+        cases.push_back({std::string("delayed/") + name,
+                         {{"jobs", delayed}, {"window_ms", window.count()}, {"workers", workers}},
+                         [=, backend = backend]() { return delayedJobs(workers, backend, delayed, window); }});
+    }
+
+    size_t storm = count(20000);
+    int failures = 3;
+    milliseconds backoff(1);
+    cases.push_back({"retry_storm/fixed_1ms",
+                     {{"jobs", storm}, {"failures", failures}, {"workers", workers}},
+                     [=]() { return retryStorm(workers, storm, failures, backoff); }});
+
+    size_t contended = count(200000);
+    for (size_t producers : {1, 2, 4, 8}) {
+        // One shared shard, and with several producers also one shard per producer.
+        std::vector<size_t> shard_counts{1};
+        if (producers > 1) {
+            shard_counts.push_back(producers);
+        }
+        for (size_t shards : shard_counts) {
+            cases.push_back({"contention/p" + std::to_string(producers) + "_s" + std::to_string(shards),
+                             {{"jobs", contended}, {"producers", producers}, {"shards", shards}, {"workers", workers}},
+                             [=]() { return multiProducer(workers, producers, shards, contended, false); }});
+        }
+    }
+    for (size_t producers : {1, 8}) {
+        cases.push_back({"contention/p" + std::to_string(producers) + "_s" + std::to_string(producers) + "_ids",
+                         {{"jobs", contended}, {"producers", producers}, {"shards", producers}, {"workers", workers}},
+                         [=]() { return multiProducer(workers, producers, producers, contended, true); }});
+    }
+    return cases;
+}
+
+Result runCase(const Case& benchmark, int repetitions) {
+    std::map<std::string, std::vector<double>> samples;
+    for (int i = 0; i < repetitions; ++i) {
+        for (const auto& [metric, value] : benchmark.run()) {
+            samples[metric].push_back(value);
+        }
+    }
+    Result result{&benchmark, {}, {}, {}};
+    for (auto& [metric, values] : samples) {
+        std::sort(values.begin(), values.end());
+        result.median[metric] = values[values.size() / 2];
+        result.min[metric] = values.front();
+        result.max[metric] = values.back();
+    }
+    return result;
+}
+
+std::string quoted(const std::string& text) {
+    std::string out = "\"";
+    for (char c : text) {
+        if (c == '"' || c == '\\') {
+            out += '\\';
+            out += c;
+        } else if (static_cast<unsigned char>(c) < 0x20) {
+            out += ' ';
+        } else {
+            out += c;
+        }
+    }
+    return out + "\"";
+}
+
+void writeMetrics(std::ostream& out, const Metrics& metrics) {
+    out << "{";
+    const char* separator = "";
+    for (const auto& [metric, value] : metrics) {
+        out << separator << quoted(metric) << ": " << value;
+        separator = ", ";
+    }
+    out << "}";
+}
+
+std::string timestamp() {
+    std::time_t now = std::time(nullptr);
+    char text[32];
+    std::strftime(text, sizeof(text), "%Y-%m-%dT%H:%M:%SZ", std::gmtime(&now));
+    return text;
+}
+
+void writeJson(std::ostream& out, const Settings& settings, const std::vector<Result>& results) {
+#if defined(__clang__)
+    const char* compiler = "clang " __clang_version__;
+#elif defined(__GNUC__)
+    const char* compiler = "gcc " __VERSION__;
+#else
+    const char* compiler = "unknown";
+#endif
+#ifdef NDEBUG
+    const char* build = "release";
+#else
+    const char* build = "debug";
+#endif
+    out.precision(6);
+    out << "{\n"
+        << "  \"schema_version\": 1,\n"
+        << "  \"label\": " << quoted(settings.label) << ",\n"
+        << "  \"timestamp\": " << quoted(timestamp()) << ",\n"
+        << "  \"context\": {\"hardware_concurrency\": " << std::thread::hardware_concurrency()
+        << ", \"workers\": " << settings.workers << ", \"compiler\": " << quoted(compiler)
+        << ", \"build\": " << quoted(build) << ", \"cxx_standard\": " << __cplusplus
+        << ", \"repetitions\": " << settings.repetitions << ", \"scale\": " << settings.scale << "},\n"
+        << "  \"benchmarks\": [";
+    const char* separator = "\n";
+    for (const auto& result : results) {
+        out << separator << "    {\"name\": " << quoted(result.source->name) << ", \"params\": {";
+        const char* param_separator = "";
+        for (const auto& [param, value] : result.source->params) {
+            out << param_separator << quoted(param) << ": " << value;
+            param_separator = ", ";
+        }
+        out << "},\n     \"metrics\": ";
+        writeMetrics(out, result.median);
+        out << ",\n     \"min\": ";
+        writeMetrics(out, result.min);
+        out << ",\n     \"max\": ";
+        writeMetrics(out, result.max);
+        out << "}";
+        separator = ",\n";
+    }
+    out << "\n  ]\n}\n";
+}
+
+bool parseArgs(int argc, char** argv, Settings& settings) {
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        auto value = [&arg](const char* prefix) -> const char* {
+            size_t length = std::char_traits<char>::length(prefix);
+            return arg.compare(0, length, prefix) == 0 ? arg.c_str() + length : nullptr;
+        };
+        if (const char* v = value("--filter=")) {
+            settings.filter = v;
+        } else if (const char* v = value("--repetitions=")) {
+            settings.repetitions = std::max(1, std::atoi(v));
+        } else if (const char* v = value("--scale=")) {
+            settings.scale = std::atof(v);
+        } else if (const char* v = value("--workers=")) {
+            settings.workers = std::max<size_t>(1, std::strtoul(v, nullptr, 10));
+        } else if (const char* v = value("--label=")) {
+            settings.label = v;
+        } else if (const char* v = value("--out=")) {
+            settings.out = v;
+        } else if (arg == "--list") {
+            settings.list = true;
+        } else {
+            std::cerr << "[Benchmarks] Unknown argument: " << arg << "\n";
+            return false;
+        }
+    }
+    if (!(settings.scale > 0)) {
+        std::cerr << "[Benchmarks] --scale must be positive\n";
+        return false;
+    }
+    return true;
+}
+
+}
+
+int main(int argc, char** argv) {
+    Settings settings;
+    if (!parseArgs(argc, argv, settings)) {
+        return 2;
+    }
+    std::vector<Case> cases = makeCases(settings);
+    if (settings.list) {
+        for (const auto& benchmark : cases) {
+            std::cout << benchmark.name << "\n";
+        }
+        return 0;
+    }
+
+    std::vector<Result> results;
+    for (const auto& benchmark : cases) {
+        if (benchmark.name.find(settings.filter) == std::string::npos) {
+            continue;
+        }
+        std::cerr << benchmark.name << ":";
+        try {
+            results.push_back(runCase(benchmark, settings.repetitions));
+        } catch (const std::exception& e) {
+            std::cerr << " failed: " << e.what() << "\n";
+            return 1;
+        }
+        for (const auto& [metric, value] : results.back().median) {
+            std::cerr << " " << metric << "=" << value;
+        }
+        std::cerr << "\n";
+    }
+
+    if (settings.out.empty()) {
+        writeJson(std::cout, settings, results);
+        return 0;
+    }
+    std::ofstream file(settings.out);
+    writeJson(file, settings, results);
+    if (!file) {
+        std::cerr << "[Benchmarks] Could not write " << settings.out << "\n";
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,76 @@
+/**
+ * @file CancelBenchmark.cpp
+ * @brief Measures cancelling and rescheduling a large number of pending jobs through JobHandle.
+ *
+ * One million jobs are submitted an hour into the future, then all of them are moved or
+ * cancelled from the submitting thread. Cancellation includes the completion accounting, so
+ * waitForIdle() returns right after the last cancel.
+ */
+
+#include "JobScheduler.hpp"
+
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace scheduleit;
+using namespace std::chrono;
+
+namespace {
+
+double millisSince(steady_clock::time_point start) {
+    return duration<double, std::milli>(steady_clock::now() - start).count();
+}
+
+void run(const std::string& name, const SchedulerOptions& options, int jobs) {
+    JobScheduler scheduler(1, options);
+    scheduler.start();
+    auto noop = []() {};
+
+    std::vector<JobHandle> handles;
+    handles.reserve(static_cast<size_t>(jobs));
+    auto start = steady_clock::now();
+    for (int i = 0; i < jobs; ++i) {
+        handles.push_back(scheduler.submit(Job::create("", noop, nullptr, hours(1), 0)));
+    }
+    double submit_ms = millisSince(start);
+
+    start = steady_clock::now();
+    for (int i = 0; i < jobs; ++i) {
+        handles[static_cast<size_t>(i)].reschedule(hours(2) + milliseconds(i % 1000));
+    }
+    double reschedule_ms = millisSince(start);
+
+    start = steady_clock::now();
+    size_t cancelled = 0;
+    for (auto& handle : handles) {
+        cancelled += handle.cancel();
+    }
+    bool idle = scheduler.waitForIdle(milliseconds(0));
+    double cancel_ms = millisSince(start);
+
+    std::cout << name << ": submit " << submit_ms << " ms, reschedule all " << reschedule_ms
+              << " ms, cancel all " << cancel_ms << " ms (" << cancelled << " cancelled, idle="
+              << (idle ? "yes" : "no") << ")\n";
+    scheduler.shutdown();
+}
+
+}
+
+int main() {
+    constexpr int kJobs = 1000000;
+    SchedulerOptions heap;
+    SchedulerOptions wheel;
+    wheel.queue.backend = QueueBackend::TimingWheel;
+    SchedulerOptions priority;
+    priority.queue.priority_policy = PriorityPolicy::WeightedFair;
+    SchedulerOptions sharded;
+    sharded.queue.shards = 4;
+
+    run("heap", heap, kJobs);
+    run("timing wheel", wheel, kJobs);
+    run("heap + weighted-fair", priority, kJobs);
+    run("heap, 4 shards", sharded, kJobs);
+    return 0;
+}
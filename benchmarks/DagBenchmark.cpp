@@ -0,0 +1,205 @@
+/**
+ * @file DagBenchmark.cpp
+ * @brief Compares JobGraph execution with stage-by-stage waitForIdle() barriers.
+ *
+ * Two synthetic DAGs of sleeping nodes (standing in for I/O-bound work with uneven
+ * durations) are run on 8 workers:
+ *   - wide: 20 stages of 50 nodes, each node depending on 2 random nodes of the stage before;
+ *   - deep: 16 independent chains of 100 nodes.
+ * The barrier version submits one stage (one chain level) at a time and waits for it, which is
+ * how pipelines were built before JobGraph, so every stage waits for its slowest node. A third
+ * part measures the per-node cost of the graph machinery itself with no-op nodes.
+ */
+
+#include "JobScheduler.hpp"
+#include "JobGraph.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace scheduleit;
+using namespace std::chrono;
+
+namespace {
+
+constexpr size_t kWorkers = 8;
+
+double millisSince(steady_clock::time_point start) {
+    return duration<double, std::milli>(steady_clock::now() - start).count();
+}
+
+/// Stages of node durations plus, per node, the indices of its parents in the stage before.
+struct Layered {
+    std::vector<std::vector<microseconds>> work;
+    std::vector<std::vector<std::vector<size_t>>> parents;
+};
+
+Layered makeWide(std::mt19937& rng) {
+    std::uniform_int_distribution<int> duration(100, 3000);
+    Layered dag;
+    for (size_t stage = 0; stage < 20; ++stage) {
+        dag.work.emplace_back();
+        dag.parents.emplace_back();
+        for (size_t i = 0; i < 50; ++i) {
+            dag.work.back().push_back(microseconds(duration(rng)));
+            std::vector<size_t> parents;
+            if (stage > 0) {
+                std::uniform_int_distribution<size_t> pick(0, 49);
+                parents = {pick(rng), pick(rng)};
+            }
+            dag.parents.back().push_back(parents);
+        }
+    }
+    return dag;
+}
+
+Layered makeDeep(std::mt19937& rng) {
+    std::uniform_int_distribution<int> duration(100, 3000);
+    Layered dag;
+    for (size_t level = 0; level < 100; ++level) {
+        dag.work.emplace_back();
+        dag.parents.emplace_back();
+        for (size_t chain = 0; chain < 16; ++chain) {
+            dag.work.back().push_back(microseconds(duration(rng)));
+            dag.parents.back().push_back(level > 0 ? std::vector<size_t>{chain} : std::vector<size_t>{});
+        }
+    }
+    return dag;
+}
+
+std::shared_ptr<Job> sleeper(microseconds work) {
+    return Job::create("", [work]() { std::this_thread::sleep_for(work); }, nullptr);
+}
+
+double runGraph(const Layered& dag) {
+    JobScheduler scheduler(kWorkers);
+    scheduler.start();
+    JobGraph graph;
+    std::vector<JobGraph::NodeId> previous;
+    for (size_t stage = 0; stage < dag.work.size(); ++stage) {
+        std::vector<JobGraph::NodeId> current;
+        for (size_t i = 0; i < dag.work[stage].size(); ++i) {
+            current.push_back(graph.add(sleeper(dag.work[stage][i])));
+            for (size_t parent : dag.parents[stage][i]) {
+                graph.addEdge(previous[parent], current.back());
+            }
+        }
+        previous = std::move(current);
+    }
+    auto start = steady_clock::now();
+    scheduler.submitGraph(std::move(graph));
+    scheduler.waitForIdle();
+    double ms = millisSince(start);
+    scheduler.shutdown();
+    return ms;
+}
+
+double runBarriers(const Layered& dag) {
+    JobScheduler scheduler(kWorkers);
+    scheduler.start();
+    auto start = steady_clock::now();
+    for (const auto& stage : dag.work) {
+        std::vector<std::shared_ptr<Job>> jobs;
+        for (auto work : stage) {
+            jobs.push_back(sleeper(work));
+        }
+        scheduler.submitBatch(std::move(jobs));
+        scheduler.waitForIdle();
+    }
+    double ms = millisSince(start);
+    scheduler.shutdown();
+    return ms;
+}
+
+void compare(const std::string& name, const Layered& dag) {
+    // No schedule beats the longest path or the total work spread over all workers.
+    microseconds total{0};
+    std::vector<microseconds> finish;
+    for (size_t stage = 0; stage < dag.work.size(); ++stage) {
+        std::vector<microseconds> current;
+        for (size_t i = 0; i < dag.work[stage].size(); ++i) {
+            microseconds ready{0};
+            for (size_t parent : dag.parents[stage][i]) {
+                ready = std::max(ready, finish[parent]);
+            }
+            current.push_back(ready + dag.work[stage][i]);
+            total += dag.work[stage][i];
+        }
+        finish = std::move(current);
+    }
+    microseconds bound = std::max(*std::max_element(finish.begin(), finish.end()),
+                                  total / static_cast<int64_t>(kWorkers));
+
+    double graph_ms = runGraph(dag);
+    double barrier_ms = runBarriers(dag);
+    std::cout << name << ": graph " << graph_ms << " ms, barriers " << barrier_ms << " ms ("
+              << barrier_ms / graph_ms << "x), lower bound " << bound.count() / 1000.0 << " ms\n";
+}
+
+void overhead(size_t nodes) {
+    auto noop = []() {};
+    {
+        JobScheduler scheduler(1);
+        scheduler.start();
+        JobGraph graph;
+        auto previous = graph.add(Job::create("", noop, nullptr));
+        for (size_t i = 1; i < nodes; ++i) {
+            auto next = graph.add(Job::create("", noop, nullptr));
+            graph.addEdge(previous, next);
+            previous = next;
+        }
+        auto start = steady_clock::now();
+        scheduler.submitGraph(std::move(graph));
+        scheduler.waitForIdle();
+        double ms = millisSince(start);
+        std::cout << "no-op chain of " << nodes << ": graph " << ms * 1e6 / static_cast<double>(nodes)
+                  << " ns/node";
+        scheduler.shutdown();
+    }
+    {
+        JobScheduler scheduler(1);
+        scheduler.start();
+        auto start = steady_clock::now();
+        for (size_t i = 0; i < nodes; ++i) {
+            scheduler.submit(Job::create("", noop, nullptr));
+            scheduler.waitForIdle();
+        }
+        double ms = millisSince(start);
+        std::cout << ", submit+waitForIdle " << ms * 1e6 / static_cast<double>(nodes) << " ns/node\n";
+        scheduler.shutdown();
+    }
+    {
+        JobScheduler scheduler(kWorkers);
+        scheduler.start();
+        JobGraph graph;
+        auto source = graph.add(Job::create("", noop, nullptr));
+        auto sink = graph.add(Job::create("", noop, nullptr));
+        for (size_t i = 0; i < nodes; ++i) {
+            auto middle = graph.add(Job::create("", noop, nullptr));
+            graph.addEdge(source, middle);
+            graph.addEdge(middle, sink);
+        }
+        auto start = steady_clock::now();
+        scheduler.submitGraph(std::move(graph));
+        scheduler.waitForIdle();
+        double ms = millisSince(start);
+        std::cout << "no-op fan-out/fan-in of " << nodes << ": " << ms * 1e6 / static_cast<double>(nodes)
+                  << " ns/node\n";
+        scheduler.shutdown();
+    }
+}
+
+}
+
+int main() {
+    std::mt19937 rng(42);
+    compare("wide (20 x 50, fan-in 2)", makeWide(rng));
+    compare("deep (16 chains x 100)", makeDeep(rng));
+    overhead(100000);
+    return 0;
+}
@@ -0,0 +1,126 @@
+/**
+ * @file DeadlineBenchmark.cpp
+ * @brief Measures goodput, jobs finished by their deadline per second, under 2x overload.
+ *
+ * The benchmark first measures how many short CPU jobs the workers finish per second, then
+ * offers twice that rate for a few seconds, and then 0.9 times that rate in 10 ms bursts.
+ * Each job must finish within 5 to 50 ms of its submission. It compares:
+ *   (1) FIFO order, deadlines unknown to the scheduler (every job runs, however late),
+ *   (2) FIFO order with Job::setDeadline(), so jobs that are already late are dropped,
+ *   (3) PriorityPolicy::EarliestDeadlineFirst with deadlines and dropping,
+ *   (4) the same, with the job length as expected run time, so jobs that could no longer
+ *       finish in time are dropped too.
+ * It reports goodput over the offered period, how many jobs finished late (CPU spent on
+ * useless results), how many were dropped, and how long the backlog took to drain.
+ *
+ * Usage: deadline_benchmark [workers] [seconds] [job_us]   (default: 2 2 200)
+ */
+
+#include "JobScheduler.hpp"
+#include "Utils.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <thread>
+#include <utility>
+#include <vector>
+
+using namespace scheduleit;
+using namespace std::chrono;
+
+namespace {
+
+void spin(microseconds length) {
+    auto end = steady_clock::now() + length;
+    while (steady_clock::now() < end) {
+    }
+}
+
+double measureCapacity(size_t workers, microseconds job_length) {
+    JobScheduler scheduler(workers);
+    scheduler.start();
+    constexpr int kJobs = 5000;
+    std::vector<std::shared_ptr<Job>> jobs;
+    for (int i = 0; i < kJobs; ++i) {
+        jobs.push_back(Job::create("", [job_length]() { spin(job_length); }, nullptr, milliseconds(0), 0));
+    }
+    auto start = steady_clock::now();
+    scheduler.submitBatch(std::move(jobs));
+    scheduler.waitForIdle();
+    double seconds = duration<double>(steady_clock::now() - start).count();
+    scheduler.shutdown();
+    return kJobs / seconds;
+}
+
+void run(const char* label, size_t workers, PriorityPolicy policy, bool drop, microseconds expected_run, double rate,
+         milliseconds burst, seconds length, microseconds job_length) {
+    SchedulerOptions options;
+    options.queue.priority_policy = policy;
+    JobScheduler scheduler(workers, options);
+    scheduler.start();
+
+    std::atomic<uint64_t> in_time{0};
+    std::atomic<uint64_t> late{0};
+    uint64_t offered = 0;
+    auto start = steady_clock::now();
+    auto end = start + length;
+    // Jobs arrive in a batch every burst interval, at the offered rate on average.
+    double owed = 0;
+    for (auto tick = start; tick < end; tick += burst) {
+        std::this_thread::sleep_until(tick);
+        owed += rate * duration<double>(burst).count();
+        std::vector<std::shared_ptr<Job>> batch;
+        for (; owed >= 1; owed -= 1, ++offered) {
+            Job::TimePoint deadline = utils::now() + milliseconds(5 + 5 * (offered % 10));
+            auto job = Job::create("", [&in_time, &late, deadline, job_length]() {
+                spin(job_length);
+                (utils::now() <= deadline ? in_time : late).fetch_add(1, std::memory_order_relaxed);
+            }, nullptr, milliseconds(0), 0);
+            if (drop) {
+                job->setDeadline(deadline, expected_run);
+            }
+            batch.push_back(std::move(job));
+        }
+        scheduler.submitBatch(std::move(batch));
+    }
+    uint64_t good = in_time.load();
+    auto produced = steady_clock::now();
+    scheduler.waitForIdle();
+    double drain_ms = duration<double, std::milli>(steady_clock::now() - produced).count();
+    double window = duration<double>(length).count();
+
+    std::cout << label << good / window << " in time/s (" << 100.0 * good / offered << "% of offered), "
+              << late.load() << " late, " << scheduler.getExecutor()->getJobsExpired() << " dropped, drained in "
+              << drain_ms << " ms\n";
+    scheduler.shutdown();
+}
+
+}
+
+int main(int argc, char** argv) {
+    size_t workers = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 2;
+    seconds length(argc > 2 ? std::atoi(argv[2]) : 2);
+    microseconds job_length(argc > 3 ? std::atoi(argv[3]) : 200);
+
+    double capacity = measureCapacity(workers, job_length);
+    std::cout << workers << " workers finish " << capacity << " jobs/s of " << job_length.count()
+              << " us; deadlines 5-50 ms after submission\n";
+    const std::pair<double, milliseconds> loads[] = {{2.0, milliseconds(1)}, {0.9, milliseconds(10)}};
+    for (const auto& [load, burst] : loads) {
+        double rate = load * capacity;
+        std::cout << load << "x load (" << rate << " jobs/s in " << burst.count() << " ms bursts) for "
+                  << length.count() << " s:\n";
+        const microseconds none(0);
+        run("  fifo, no deadlines:   ", workers, PriorityPolicy::None, false, none, rate, burst, length, job_length);
+        run("  fifo + drop:          ", workers, PriorityPolicy::None, true, none, rate, burst, length, job_length);
+        run("  edf + drop:           ", workers, PriorityPolicy::EarliestDeadlineFirst, true, none, rate, burst,
+            length, job_length);
+        run("  edf + drop, expected: ", workers, PriorityPolicy::EarliestDeadlineFirst, true, job_length, rate,
+            burst, length, job_length);
+    }
+    return 0;
+}
@@ -0,0 +1,68 @@
+/**
+ * @file DispatchLatencyBenchmark.cpp
+ * @brief Measures submit-to-start latency for the dispatcher and direct dispatch modes.
+ *
+ * Usage: dispatch_latency_benchmark [jobs] [workers] [interval_us]   (default: 5000 4 200)
+ */
+
+#include "JobScheduler.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <thread>
+#include <vector>
+
+using namespace scheduleit;
+using namespace std::chrono;
+
+namespace {
+
+void run(const char* name, DispatchMode mode, int job_count, size_t workers, microseconds interval) {
+    SchedulerOptions options;
+    options.dispatch = mode;
+    JobScheduler scheduler(workers, options);
+    scheduler.start();
+
+    std::vector<long long> latencies_ns(job_count);
+    std::atomic<int> done{0};
+    for (int i = 0; i < job_count; ++i) {
+        auto submitted = steady_clock::now();
+        scheduler.submit(std::make_shared<Job>(
+            "",
+            [&latencies_ns, &done, submitted, i]() {
+                latencies_ns[i] = duration_cast<nanoseconds>(steady_clock::now() - submitted).count();
+                done.fetch_add(1);
+            },
+            nullptr,
+            milliseconds(0),
+            0));
+        std::this_thread::sleep_for(interval);
+    }
+    while (done.load() < job_count) {
+        std::this_thread::sleep_for(milliseconds(1));
+    }
+    scheduler.shutdown();
+
+    std::sort(latencies_ns.begin(), latencies_ns.end());
+    auto percentile = [&](double p) {
+        return latencies_ns[static_cast<size_t>(p * (latencies_ns.size() - 1))] / 1000.0;
+    };
+    std::cout << name << " p50=" << percentile(0.50) << "us p99=" << percentile(0.99)
+              << "us max=" << latencies_ns.back() / 1000.0 << "us\n";
+}
+
+}
+
+int main(int argc, char** argv) {
+    int job_count = argc > 1 ? std::atoi(argv[1]) : 5000;
+    size_t workers = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 4;
+    microseconds interval(argc > 3 ? std::atoi(argv[3]) : 200);
+
+    run("dispatcher", DispatchMode::Dispatcher, job_count, workers, interval);
+    run("direct    ", DispatchMode::Direct, job_count, workers, interval);
+    return 0;
+}
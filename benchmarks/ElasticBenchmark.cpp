@@ -0,0 +1,91 @@
+/**
+ * @file ElasticBenchmark.cpp
+ * @brief Compares fixed-size pools with an elastic one on CPU-bound, sleep-heavy and mixed
+ *        workloads.
+ *
+ * Each workload runs on (1) a pool sized to the CPUs, (2) a pool sized for blocking work,
+ * and (3) an elastic pool that starts at the CPU count and may grow to the large size. The
+ * benchmark reports wall time, the elastic pool's peak size and decisions, and its size after
+ * three idle seconds; a fixed large pool keeps all its threads.
+ *
+ * Usage: elastic_benchmark [tasks] [large_pool]   (default: 2000 64)
+ */
+
+#include "ThreadPool.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <utility>
+
+using namespace scheduleit;
+using namespace std::chrono;
+
+namespace {
+
+enum class Workload { Cpu, Sleep, Mixed };
+
+void spin(microseconds length) {
+    auto end = steady_clock::now() + length;
+    while (steady_clock::now() < end) {
+    }
+}
+
+void run(const std::string& label, Workload workload, int tasks, size_t workers, const ThreadPoolOptions& options) {
+    ThreadPool pool(workers, options);
+    std::atomic<int> done{0};
+    auto start = steady_clock::now();
+    for (int i = 0; i < tasks; ++i) {
+        bool sleeps = workload == Workload::Sleep || (workload == Workload::Mixed && i % 2 == 1);
+        pool.submitDetached([&done, sleeps]() {
+            if (sleeps) {
+                std::this_thread::sleep_for(milliseconds(2));
+            } else {
+                spin(microseconds(200));
+            }
+            done.fetch_add(1);
+        });
+    }
+    while (done.load() < tasks) {
+        std::this_thread::sleep_for(microseconds(200));
+    }
+    double ms = duration<double, std::milli>(steady_clock::now() - start).count();
+    std::cout << label << ms << " ms";
+
+    if (options.elastic.max_threads > 0) {
+        ElasticStats busy = pool.getElasticStats();
+        std::this_thread::sleep_for(seconds(3));
+        ElasticStats idle = pool.getElasticStats();
+        std::cout << ", peak " << busy.peak_workers << " workers, " << busy.grow_decisions << " grow / "
+                  << idle.shrink_decisions << " shrink decisions, " << idle.workers << " workers after 3 s idle";
+    }
+    std::cout << "\n";
+    pool.shutdown();
+}
+
+}
+
+int main(int argc, char** argv) {
+    int tasks = argc > 1 ? std::atoi(argv[1]) : 2000;
+    size_t large = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 64;
+    size_t cpus = std::max(1u, std::thread::hardware_concurrency());
+
+    ThreadPoolOptions fixed;
+    ThreadPoolOptions elastic;
+    elastic.elastic.min_threads = 1;
+    elastic.elastic.max_threads = large;
+
+    const std::pair<const char*, Workload> workloads[] = {
+        {"cpu-bound", Workload::Cpu}, {"sleep-heavy", Workload::Sleep}, {"mixed", Workload::Mixed}};
+    for (const auto& [name, workload] : workloads) {
+        std::cout << name << " (" << tasks << " tasks):\n";
+        run("  fixed " + std::to_string(cpus) + ":   ", workload, tasks, cpus, fixed);
+        run("  fixed " + std::to_string(large) + ":  ", workload, tasks, large, fixed);
+        run("  elastic:    ", workload, tasks, cpus, elastic);
+    }
+    return 0;
+}
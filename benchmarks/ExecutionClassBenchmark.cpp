@@ -0,0 +1,96 @@
+/**
+ * @file ExecutionClassBenchmark.cpp
+ * @brief Measures how blocking jobs delay short compute jobs, with one shared pool and with
+ *        a separate blocking pool.
+ *
+ * A burst of blocking jobs (each sleeping, as a file or network call would) is submitted
+ * together with a steady stream of short CPU jobs. With one pool, the blocking jobs take every
+ * worker and the compute jobs queue behind them. With ExecutionClass::Blocking routed to its
+ * own pool, the compute workers stay free. The benchmark reports the compute jobs' dispatch
+ * lag (from their scheduled time to starting) and how long the run took. Both setups get the
+ * same number of threads in total.
+ *
+ * Usage: execution_class_benchmark [compute_jobs] [blocking_jobs] [compute_workers] [blocking_workers]
+ *        (default: 20000 64 2 8)
+ */
+
+#include "JobScheduler.hpp"
+#include "Utils.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace scheduleit;
+using namespace std::chrono;
+
+namespace {
+
+void run(bool separate, int compute_jobs, int blocking_jobs, size_t compute_workers, size_t blocking_workers) {
+    SchedulerOptions options;
+    size_t workers = compute_workers;
+    if (separate) {
+        options.blocking.workers = blocking_workers;
+    } else {
+        workers += blocking_workers;
+    }
+    JobScheduler scheduler(workers, options);
+    scheduler.start();
+
+    std::vector<int64_t> lag_us(compute_jobs);  // each compute job's wait from ready to started
+    auto start = steady_clock::now();
+    std::vector<std::shared_ptr<Job>> blocking;
+    for (int i = 0; i < blocking_jobs; ++i) {
+        auto job = Job::create("", []() { std::this_thread::sleep_for(milliseconds(20)); }, nullptr,
+                               milliseconds(0), 0);
+        job->setExecutionClass(ExecutionClass::Blocking);
+        blocking.push_back(std::move(job));
+    }
+    scheduler.submitBatch(std::move(blocking));
+
+    // Compute jobs arrive in small batches over the length of the blocking burst.
+    constexpr int kBatch = 100;
+    for (int submitted = 0; submitted < compute_jobs; submitted += kBatch) {
+        std::vector<std::shared_ptr<Job>> batch;
+        for (int i = 0; i < kBatch && submitted + i < compute_jobs; ++i) {
+            int64_t* slot = &lag_us[submitted + i];
+            batch.push_back(Job::create("", [slot]() {
+                *slot = duration_cast<microseconds>(utils::now() - Job::current()->getScheduledTime()).count();
+                auto end = steady_clock::now() + microseconds(5);
+                while (steady_clock::now() < end) {
+                }
+            }, nullptr, milliseconds(0), 0));
+        }
+        scheduler.submitBatch(std::move(batch));
+        std::this_thread::sleep_for(microseconds(500));
+    }
+    scheduler.waitForIdle();
+    double ms = duration<double, std::milli>(steady_clock::now() - start).count();
+
+    std::sort(lag_us.begin(), lag_us.end());
+    std::cout << (separate ? "separate pools (" : "one pool (") << workers
+              << (separate ? " + " + std::to_string(blocking_workers) : std::string())
+              << " workers): compute dispatch lag p50 " << lag_us[lag_us.size() / 2] << " us, p99 "
+              << lag_us[lag_us.size() * 99 / 100] << " us, max " << lag_us.back() << " us, " << ms
+              << " ms in total\n";
+    scheduler.shutdown();
+}
+
+}
+
+int main(int argc, char** argv) {
+    int compute_jobs = argc > 1 ? std::atoi(argv[1]) : 20000;
+    int blocking_jobs = argc > 2 ? std::atoi(argv[2]) : 64;
+    size_t compute_workers = argc > 3 ? std::strtoul(argv[3], nullptr, 10) : 2;
+    size_t blocking_workers = argc > 4 ? std::strtoul(argv[4], nullptr, 10) : 8;
+
+    run(false, compute_jobs, blocking_jobs, compute_workers, blocking_workers);
+    run(true, compute_jobs, blocking_jobs, compute_workers, blocking_workers);
+    return 0;
+}
@@ -0,0 +1,122 @@
+/**
+ * @file JobAllocationBenchmark.cpp
+ * @brief Counts heap allocations per job and peak RSS for make_shared versus Job::create.
+ *
+ * Usage: job_allocation_benchmark                       (allocation churn, both factories)
+ *        job_allocation_benchmark <shared|pool> <dispatcher|direct> [jobs]
+ *                                                       (end-to-end run, one configuration)
+ */
+
+#include "JobScheduler.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <new>
+#include <string>
+#include <vector>
+
+using namespace scheduleit;
+using namespace std::chrono;
+
+namespace {
+
+std::atomic<size_t> g_allocations{0};
+
+long peakRssKb() {
+    std::ifstream status("/proc/self/status");
+    std::string line;
+    while (std::getline(status, line)) {
+        if (line.rfind("VmHWM:", 0) == 0) {
+            return std::strtol(line.c_str() + 6, nullptr, 10);
+        }
+    }
+    return -1;
+}
+
+template <class Factory>
+void churn(const char* name, Factory make) {
+    constexpr int kRounds = 1000;
+    constexpr int kLive = 1000;
+    std::vector<std::shared_ptr<Job>> live;
+    live.reserve(kLive);
+    auto noop = []() {};
+
+    size_t before = g_allocations.load();
+    auto start = steady_clock::now();
+    for (int round = 0; round < kRounds; ++round) {
+        for (int i = 0; i < kLive; ++i) {
+            live.push_back(make("", noop));
+        }
+        live.clear();
+    }
+    double ns = duration<double, std::nano>(steady_clock::now() - start).count() / (kRounds * kLive);
+    double allocs = static_cast<double>(g_allocations.load() - before) / (kRounds * kLive);
+    std::cout << name << " create+destroy: " << ns << " ns/job, " << allocs << " allocations/job\n";
+}
+
+void endToEnd(bool pooled, DispatchMode mode, int job_count) {
+    SchedulerOptions options;
+    options.dispatch = mode;
+    JobScheduler scheduler(4, options);
+    auto noop = []() {};
+
+    size_t before = g_allocations.load();
+    auto start = steady_clock::now();
+    scheduler.start();
+    for (int i = 0; i < job_count; ++i) {
+        if (pooled) {
+            scheduler.submit(Job::create("", noop, nullptr, milliseconds(0), 0));
+        } else {
+            scheduler.submit(std::make_shared<Job>("", noop, nullptr, milliseconds(0), 0));
+        }
+    }
+    scheduler.waitForIdle();
+    auto elapsed = duration_cast<milliseconds>(steady_clock::now() - start).count();
+    double allocs = static_cast<double>(g_allocations.load() - before) / job_count;
+    scheduler.shutdown();
+
+    std::cout << (pooled ? "pool  " : "shared") << ' '
+              << (mode == DispatchMode::Direct ? "direct    " : "dispatcher")
+              << " jobs=" << job_count << " time=" << elapsed << "ms"
+              << " allocations/job=" << allocs << " peak_rss=" << peakRssKb() << "kB\n";
+}
+
+}
+
+void* operator new(size_t size) {
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* pointer = std::malloc(size ? size : 1)) {
+        return pointer;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* pointer) noexcept {
+    std::free(pointer);
+}
+
+void operator delete(void* pointer, size_t) noexcept {
+    std::free(pointer);
+}
+
+int main(int argc, char** argv) {
+    if (argc >= 3) {
+        bool pooled = std::strcmp(argv[1], "pool") == 0;
+        DispatchMode mode = std::strcmp(argv[2], "direct") == 0 ? DispatchMode::Direct : DispatchMode::Dispatcher;
+        endToEnd(pooled, mode, argc > 3 ? std::atoi(argv[3]) : 500000);
+        return 0;
+    }
+
+    churn("make_shared", [](const char* id, auto task) {
+        return std::make_shared<Job>(id, task, nullptr, milliseconds(0), 0);
+    });
+    churn("Job::create", [](const char* id, auto task) {
+        return Job::create(id, task, nullptr, milliseconds(0), 0);
+    });
+    return 0;
+}
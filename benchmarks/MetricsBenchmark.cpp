@@ -0,0 +1,116 @@
+/**
+ * @file MetricsBenchmark.cpp
+ * @brief Measures the cost of recording scheduler metrics and what the histograms report.
+ *
+ * First times the recording calls a worker makes per run (recordStart, recordExecution and
+ * recordRetries) on one thread and on several at once, without the clock reads. Then runs
+ * no-op jobs through a JobScheduler with metrics on and off and prints the percentiles.
+ *
+ * Usage: metrics_benchmark [jobs] [workers]   (default: 1000000 2)
+ */
+
+#include "JobScheduler.hpp"
+#include "SchedulerMetrics.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <ctime>
+#include <iostream>
+#include <memory>
+#include <thread>
+#include <vector>
+
+using namespace scheduleit;
+using namespace std::chrono;
+
+namespace {
+
+double threadCpuNanos() {
+    timespec now{};
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &now);
+    return now.tv_sec * 1e9 + now.tv_nsec;
+}
+
+/// Returns the CPU nanoseconds one run's recording costs, with every thread recording at once.
+double recordCost(int threads) {
+    constexpr int kRuns = 5000000;
+    SchedulerMetrics metrics;
+    auto job = Job::create("", []() {}, nullptr);
+    auto started = job->getScheduledTime() + microseconds(3);
+    std::vector<double> cpu(threads);
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; ++t) {
+        workers.emplace_back([&, t]() {
+            double begin = threadCpuNanos();
+            for (int i = 0; i < kRuns; ++i) {
+                metrics.recordStart(*job, started + nanoseconds(i & 1023));
+                metrics.recordExecution(nanoseconds(i & 4095));
+                metrics.recordRetries(0);
+            }
+            cpu[t] = threadCpuNanos() - begin;
+        });
+    }
+    double total = 0;
+    for (int t = 0; t < threads; ++t) {
+        workers[t].join();
+        total += cpu[t];
+    }
+    return total / (static_cast<double>(kRuns) * threads);
+}
+
+void printHistogram(const char* name, const HistogramSnapshot& histogram, double unit, const char* suffix) {
+    std::cout << "  " << name << " n=" << histogram.count << " mean=" << histogram.mean() / unit << suffix
+              << " p50=" << histogram.percentile(50) / unit << suffix
+              << " p99=" << histogram.percentile(99) / unit << suffix
+              << " max=" << histogram.max / unit << suffix << "\n";
+}
+
+double throughput(int job_count, size_t workers, bool collect, bool print) {
+    SchedulerOptions options;
+    options.collect_metrics = collect;
+    JobScheduler scheduler(workers, options);
+    scheduler.start();
+    auto begin = steady_clock::now();
+    for (int submitted = 0; submitted < job_count; submitted += 1000) {
+        std::vector<std::shared_ptr<Job>> batch;
+        for (int i = 0; i < 1000; ++i) {
+            batch.push_back(Job::create("", []() {}, nullptr, milliseconds(0), 0));
+        }
+        scheduler.submitBatch(std::move(batch));
+    }
+    scheduler.waitForIdle();
+    double seconds = duration<double>(steady_clock::now() - begin).count();
+    if (print) {
+        auto metrics = scheduler.getMetrics();
+        printHistogram("queue_wait  ", metrics.queue_wait, 1000.0, "us");
+        printHistogram("dispatch_lag", metrics.dispatch_lag, 1000.0, "us");
+        printHistogram("execution   ", metrics.execution, 1.0, "ns");
+        printHistogram("retries     ", metrics.retries, 1.0, "");
+        std::cout << "  recorded by " << scheduler.getWorkerMetrics().size() << " worker threads\n";
+    }
+    scheduler.shutdown();
+    return job_count / seconds;
+}
+
+}
+
+int main(int argc, char** argv) {
+    int job_count = argc > 1 ? std::atoi(argv[1]) : 1000000;
+    size_t workers = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 2;
+
+    for (int threads : {1, 4}) {
+        std::cout << "record cost, " << threads << " thread(s): " << recordCost(threads)
+                  << " ns of CPU per run (all three calls, clock reads excluded)\n";
+    }
+
+    std::cout << "scheduler, " << job_count << " no-op jobs on " << workers << " workers, metrics on:\n";
+    double with = throughput(job_count, workers, true, true);
+    double without = 0;
+    for (int round = 0; round < 3; ++round) {  // best of three, alternating
+        without = std::max(without, throughput(job_count, workers, false, false));
+        with = std::max(with, throughput(job_count, workers, true, false));
+    }
+    std::cout << "throughput (best of 3): " << with << " jobs/s with metrics, " << without << " jobs/s without\n";
+    return 0;
+}
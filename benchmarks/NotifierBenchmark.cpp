@@ -0,0 +1,90 @@
+/**
+ * @file NotifierBenchmark.cpp
+ * @brief Measures scheduler throughput with no observer, a synchronous logger and the Notifier.
+ *
+ * The synchronous logger does what Notifier used to do on the worker thread: iostream output
+ * and a localtime/strftime timestamp per event. All output goes to /dev/null, so the numbers
+ * show the cost on the workers rather than the terminal's speed.
+ *
+ * Usage: notifier_benchmark [jobs] [workers]   (default: 500000 4)
+ */
+
+#include "JobScheduler.hpp"
+#include "Notifier.hpp"
+#include "Utils.hpp"
+
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <vector>
+
+using namespace scheduleit;
+using namespace std::chrono;
+
+namespace {
+
+class SynchronousLogger : public Observer {
+public:
+    explicit SynchronousLogger(std::ostream& out) : out_(out) {}
+
+    void onJobFailed(const Job& job, int attempt) override {
+        out_ << "[Notifier] Job failed: " << job.getId() << " | Attempt: " << attempt << " | Time: "
+             << utils::timestampToString(duration_cast<milliseconds>(utils::now().time_since_epoch())) << '\n';
+    }
+
+    void onJobSuccess(const Job& job) override {
+        out_ << "[Notifier] Job succeeded: " << job.getId() << " | Time: "
+             << utils::timestampToString(duration_cast<milliseconds>(utils::now().time_since_epoch())) << '\n';
+    }
+
+private:
+    std::ostream& out_;
+};
+
+double run(int job_count, size_t workers, const std::shared_ptr<Observer>& observer) {
+    JobScheduler scheduler(workers);
+    if (observer) {
+        scheduler.getExecutor()->registerObserver(observer);
+    }
+    scheduler.start();
+    auto start = steady_clock::now();
+    for (int submitted = 0; submitted < job_count; submitted += 1000) {
+        std::vector<std::shared_ptr<Job>> batch;
+        for (int i = 0; i < 1000; ++i) {
+            batch.push_back(Job::create("job-" + std::to_string(submitted + i), []() {}, nullptr, milliseconds(0), 0));
+        }
+        scheduler.submitBatch(std::move(batch));
+    }
+    scheduler.waitForIdle();
+    double seconds = duration<double>(steady_clock::now() - start).count();
+    scheduler.shutdown();
+    return job_count / seconds;
+}
+
+}
+
+int main(int argc, char** argv) {
+    int job_count = argc > 1 ? std::atoi(argv[1]) : 500000;
+    size_t workers = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 4;
+    std::ofstream null_out("/dev/null");
+
+    std::cout << "no observer:        " << run(job_count, workers, nullptr) << " jobs/s\n";
+    std::cout << "synchronous logger: " << run(job_count, workers, std::make_shared<SynchronousLogger>(null_out))
+              << " jobs/s\n";
+
+    for (auto policy : {NotifierDropPolicy::DropNewest, NotifierDropPolicy::Block}) {
+        NotifierOptions options;
+        options.drop_policy = policy;
+        options.out = &null_out;
+        options.err = &null_out;
+        auto notifier = std::make_shared<Notifier>(options);
+        double rate = run(job_count, workers, notifier);
+        notifier->flush();
+        std::cout << (policy == NotifierDropPolicy::Block ? "Notifier, Block:    " : "Notifier, DropNewest:")
+                  << " " << rate << " jobs/s, " << notifier->getWrittenCount() << " written, "
+                  << notifier->getDroppedCount() << " dropped\n";
+    }
+    return 0;
+}
@@ -0,0 +1,100 @@
+/**
+ * @file PriorityBenchmark.cpp
+ * @brief Measures queueing delay of critical jobs behind a flood of low-priority work.
+ *
+ * A backlog of low-priority jobs (about 20us of work each) is submitted up front, overloading
+ * the workers for several seconds; meanwhile a critical job is submitted every 2ms. The
+ * reported delay is the time from a critical job's submission to the start of its task.
+ *
+ * Usage: priority_benchmark [low_jobs] [critical_jobs] [workers]   (default: 100000 500 2)
+ */
+
+#include "JobScheduler.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <thread>
+#include <vector>
+
+using namespace scheduleit;
+using namespace std::chrono;
+
+namespace {
+
+void spinFor(microseconds duration) {
+    auto until = steady_clock::now() + duration;
+    while (steady_clock::now() < until) {
+    }
+}
+
+void run(const char* name, DispatchMode mode, PriorityPolicy policy, int low_jobs, int critical_jobs, size_t workers) {
+    SchedulerOptions options;
+    options.dispatch = mode;
+    options.queue.priority_policy = policy;
+    JobScheduler scheduler(workers, options);
+    scheduler.start();
+
+    std::vector<std::shared_ptr<Job>> flood;
+    for (int i = 0; i < low_jobs; ++i) {
+        auto job = Job::create("", []() { spinFor(microseconds(20)); }, nullptr, milliseconds(0), 0);
+        job->setPriority(JobPriority::Low);
+        flood.push_back(std::move(job));
+    }
+    scheduler.submitBatch(std::move(flood));
+
+    std::vector<long long> delays_ns(critical_jobs);
+    std::atomic<int> done{0};
+    for (int i = 0; i < critical_jobs; ++i) {
+        auto submitted = steady_clock::now();
+        auto job = Job::create(
+            "",
+            [&delays_ns, &done, submitted, i]() {
+                delays_ns[i] = duration_cast<nanoseconds>(steady_clock::now() - submitted).count();
+                done.fetch_add(1);
+            },
+            nullptr, milliseconds(0), 0);
+        job->setPriority(JobPriority::Critical);
+        scheduler.submit(std::move(job));
+        std::this_thread::sleep_for(milliseconds(2));
+    }
+    while (done.load() < critical_jobs) {
+        std::this_thread::sleep_for(milliseconds(1));
+    }
+    auto stats = scheduler.getPriorityStats();
+    scheduler.shutdown();
+
+    std::sort(delays_ns.begin(), delays_ns.end());
+    auto percentile = [&](double p) {
+        return delays_ns[static_cast<size_t>(p * (delays_ns.size() - 1))] / 1e6;
+    };
+    std::cout << name << " critical delay p50=" << percentile(0.50) << "ms p99=" << percentile(0.99)
+              << "ms max=" << delays_ns.back() / 1e6 << "ms";
+    if (policy != PriorityPolicy::None) {
+        const auto& low = stats[static_cast<size_t>(JobPriority::Low)];
+        std::cout << " (low: dequeued=" << low.dequeued << " still queued=" << low.queued << ")";
+    }
+    std::cout << "\n";
+}
+
+}
+
+int main(int argc, char** argv) {
+    int low_jobs = argc > 1 ? std::atoi(argv[1]) : 100000;
+    int critical_jobs = argc > 2 ? std::atoi(argv[2]) : 500;
+    size_t workers = argc > 3 ? std::strtoul(argv[3], nullptr, 10) : 2;
+
+    for (auto mode : {DispatchMode::Dispatcher, DispatchMode::Direct}) {
+        const char* mode_name = mode == DispatchMode::Direct ? "direct    " : "dispatcher";
+        std::cout << mode_name << " none            ";
+        run("", mode, PriorityPolicy::None, low_jobs, critical_jobs, workers);
+        std::cout << mode_name << " weighted-fair   ";
+        run("", mode, PriorityPolicy::WeightedFair, low_jobs, critical_jobs, workers);
+        std::cout << mode_name << " strict+aging    ";
+        run("", mode, PriorityPolicy::StrictWithAging, low_jobs, critical_jobs, workers);
+    }
+    return 0;
+}
@@ -0,0 +1,85 @@
+/**
+ * @file QueueBackendBenchmark.cpp
+ * @brief Compares the heap and timing wheel JobStore backends with many pending jobs.
+ *
+ * Usage: queue_backend_benchmark [pending_jobs...]   (default: 10000 1000000)
+ */
+
+#include "HeapJobStore.hpp"
+#include "TimingWheelJobStore.hpp"
+#include "Utils.hpp"
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace scheduleit;
+using namespace std::chrono;
+
+namespace {
+
+std::vector<std::shared_ptr<Job>> makeJobs(size_t count) {
+    // Delays spread over one hour, like a mix of retries and delayed work.
+    std::mt19937_64 rng(42);
+    std::uniform_int_distribution<long> delay_ms(1, 3600 * 1000);
+    std::vector<std::shared_ptr<Job>> jobs;
+    jobs.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        jobs.push_back(std::make_shared<Job>("", nullptr, nullptr, milliseconds(delay_ms(rng)), 0));
+    }
+    return jobs;
+}
+
+void run(const char* name, JobStore& store, const std::vector<std::shared_ptr<Job>>& jobs,
+         Job::TimePoint origin) {
+    auto start = steady_clock::now();
+    for (const auto& job : jobs) {
+        store.push(job);
+    }
+    auto filled = steady_clock::now();
+
+    // Drain in 10ms steps of virtual time, as a dispatcher would.
+    size_t popped = 0;
+    for (auto now = origin; popped < jobs.size(); now += milliseconds(10)) {
+        while (store.popReady(now)) {
+            ++popped;
+        }
+    }
+    auto drained = steady_clock::now();
+
+    double insert_ns = duration<double, std::nano>(filled - start).count() / jobs.size();
+    double expire_ns = duration<double, std::nano>(drained - filled).count() / jobs.size();
+    std::cout << name << " pending=" << jobs.size()
+              << " insert=" << insert_ns << " ns/job"
+              << " expire=" << expire_ns << " ns/job\n";
+}
+
+}
+
+int main(int argc, char** argv) {
+    std::vector<size_t> sizes;
+    for (int i = 1; i < argc; ++i) {
+        sizes.push_back(std::strtoull(argv[i], nullptr, 10));
+    }
+    if (sizes.empty()) {
+        sizes = {10000, 1000000};
+    }
+
+    for (size_t size : sizes) {
+        auto origin = utils::now();
+        auto jobs = makeJobs(size);
+        {
+            HeapJobStore heap;
+            run("heap ", heap, jobs, origin);
+        }
+        {
+            TimingWheelJobStore wheel(milliseconds(1), 4, origin);
+            run("wheel", wheel, jobs, origin);
+        }
+    }
+    return 0;
+}
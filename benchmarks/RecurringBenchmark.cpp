@@ -0,0 +1,144 @@
+/**
+ * @file RecurringBenchmark.cpp
+ * @brief Compares native recurring jobs with jobs that resubmit a fresh copy of themselves.
+ *
+ * A set of periodic jobs runs for a fixed wall-clock window. For each approach the benchmark
+ * reports heap allocations per firing, firings completed, lag: how far the last firing of a
+ * series is behind first firing + (firings - 1) * period, and phase error: the distance of
+ * the last firing from the nearest slot of the grid first firing + k * period. Skipping
+ * missed slots shows up as lag but not as phase error.
+ */
+
+#include "JobScheduler.hpp"
+#include "Utils.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <new>
+#include <thread>
+#include <vector>
+
+using namespace scheduleit;
+using namespace std::chrono;
+
+namespace {
+
+std::atomic<size_t> g_allocations{0};
+
+constexpr int kSeries = 200;
+constexpr milliseconds kPeriod(5);
+constexpr milliseconds kWindow(2000);
+
+struct Series {
+    Job::TimePoint first{};
+    Job::TimePoint last{};
+    std::atomic<int> firings{0};
+};
+
+void record(Series& series) {
+    auto now = utils::now();
+    if (series.firings++ == 0) {
+        series.first = now;
+    }
+    series.last = now;
+}
+
+void report(const char* name, std::vector<Series>& series, size_t allocations) {
+    long total = 0;
+    double sum_lag = 0;
+    double sum_phase = 0;
+    double worst_phase = 0;
+    for (auto& s : series) {
+        int n = s.firings.load();
+        total += n;
+        if (n > 1) {
+            auto span = s.last - s.first;
+            sum_lag += duration<double, std::milli>(span - kPeriod * (n - 1)).count();
+            auto offset = span % duration_cast<Job::TimePoint::duration>(kPeriod);
+            double phase = duration<double, std::milli>(std::min(offset, kPeriod - offset)).count();
+            sum_phase += phase;
+            worst_phase = std::max(worst_phase, phase);
+        }
+    }
+    std::cout << name << ": " << total << " firings, "
+              << static_cast<double>(allocations) / static_cast<double>(total) << " allocations/firing, lag "
+              << sum_lag / kSeries << " ms, phase error mean " << sum_phase / kSeries << " ms, worst "
+              << worst_phase << " ms\n";
+}
+
+void runResubmitting() {
+    std::vector<Series> series(kSeries);
+    JobScheduler scheduler(2);
+    scheduler.start();
+    std::atomic<bool> stop{false};
+
+    // The pre-existing workaround: every firing allocates and submits its successor.
+    std::function<void(Series&)> fire = [&](Series& s) {
+        record(s);
+        if (!stop.load()) {
+            scheduler.submit(std::make_shared<Job>("", [&fire, &s]() { fire(s); }, nullptr, kPeriod, 0));
+        }
+    };
+    size_t before = g_allocations.load();
+    for (auto& s : series) {
+        scheduler.submit(std::make_shared<Job>("", [&fire, &s]() { fire(s); }, nullptr, milliseconds(0), 0));
+    }
+    std::this_thread::sleep_for(kWindow);
+    stop = true;
+    size_t allocations = g_allocations.load() - before;
+    scheduler.shutdown();
+    report("resubmit make_shared", series, allocations);
+}
+
+void runNative(MissedFiringPolicy missed) {
+    std::vector<Series> series(kSeries);
+    JobScheduler scheduler(2);
+    scheduler.start();
+
+    size_t before = g_allocations.load();
+    for (auto& s : series) {
+        auto job = Job::create("", [&s]() { record(s); }, nullptr, milliseconds(0), 0);
+        Recurrence recurrence;
+        recurrence.period = kPeriod;
+        recurrence.missed = missed;
+        job->setRecurrence(recurrence);
+        scheduler.submit(std::move(job));
+    }
+    std::this_thread::sleep_for(kWindow);
+    size_t allocations = g_allocations.load() - before;
+    scheduler.shutdown();
+    report(missed == MissedFiringPolicy::CatchUp ? "native fixed-rate, catch-up" : "native fixed-rate, skip",
+           series, allocations);
+}
+
+}
+
+void* operator new(size_t size) {
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* pointer = std::malloc(size ? size : 1)) {
+        return pointer;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* pointer) noexcept {
+    std::free(pointer);
+}
+
+void operator delete(void* pointer, size_t) noexcept {
+    std::free(pointer);
+}
+
+int main() {
+    std::cout << kSeries << " series, period " << kPeriod.count() << " ms, window " << kWindow.count()
+              << " ms, ideal " << kSeries * (kWindow / kPeriod) << " firings\n";
+    runResubmitting();
+    runNative(MissedFiringPolicy::CatchUp);
+    runNative(MissedFiringPolicy::Skip);
+    return 0;
+}
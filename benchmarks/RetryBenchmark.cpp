@@ -0,0 +1,74 @@
+/**
+ * @file RetryBenchmark.cpp
+ * @brief Measures throughput when a fraction of jobs fail once and are retried with backoff.
+ *
+ * Usage: retry_benchmark [jobs] [workers] [backoff_ms]   (default: 20000 4 100)
+ */
+
+#include "JobScheduler.hpp"
+#include "FixedRetryStrategy.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+
+using namespace scheduleit;
+using namespace std::chrono;
+
+int main(int argc, char** argv) {
+    int job_count = argc > 1 ? std::atoi(argv[1]) : 20000;
+    size_t workers = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 4;
+    milliseconds backoff(argc > 3 ? std::atoi(argv[3]) : 100);
+
+    JobScheduler scheduler(workers);
+    auto retry_strategy = std::make_shared<FixedRetryStrategy>(backoff);
+    std::atomic<int> first_attempts_done{0};
+    std::atomic<int> succeeded{0};
+
+    for (int i = 0; i < job_count; ++i) {
+        bool fails_once = i % 10 == 0;
+        auto attempts = std::make_shared<int>(0);
+        scheduler.submit(std::make_shared<Job>(
+            "",
+            [&, fails_once, attempts]() {
+                auto until = steady_clock::now() + microseconds(20);
+                while (steady_clock::now() < until) {
+                }
+                if ((*attempts)++ == 0) {
+                    first_attempts_done++;
+                    if (fails_once) {
+                        throw std::runtime_error("transient failure");
+                    }
+                }
+                succeeded++;
+            },
+            retry_strategy,
+            milliseconds(0),
+            1));
+    }
+
+    auto start = steady_clock::now();
+    scheduler.start();
+    while (first_attempts_done < job_count) {
+        std::this_thread::sleep_for(microseconds(100));
+    }
+    auto first_pass = steady_clock::now();
+    while (succeeded < job_count) {
+        std::this_thread::sleep_for(microseconds(100));
+    }
+    auto end = steady_clock::now();
+    scheduler.shutdown();
+
+    auto first_ms = duration_cast<milliseconds>(first_pass - start).count();
+    auto total_ms = duration_cast<milliseconds>(end - start).count();
+    std::cout << "jobs=" << job_count << " failing=10% workers=" << workers
+              << " backoff=" << backoff.count() << "ms\n"
+              << "first attempts done in " << first_ms << " ms ("
+              << job_count * 1000.0 / std::max<long long>(first_ms, 1) << " jobs/sec)\n"
+              << "all jobs succeeded in " << total_ms << " ms\n";
+    return 0;
+}
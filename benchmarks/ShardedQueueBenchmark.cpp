@@ -0,0 +1,78 @@
+/**
+ * @file ShardedQueueBenchmark.cpp
+ * @brief Measures JobQueue throughput with concurrent producers and consumers per shard count.
+ *
+ * Producers enqueue due jobs while consumers drain them with waitDequeue(); the reported rate
+ * is jobs handed from a producer to a consumer per second.
+ */
+
+#include "JobQueue.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <thread>
+#include <vector>
+
+using namespace scheduleit;
+using namespace std::chrono;
+
+namespace {
+
+double run(size_t shards, int producers, int consumers, int jobs_per_producer) {
+    QueueOptions options;
+    options.shards = shards;
+    options.shard_skew = milliseconds(1);
+    JobQueue queue(options);
+    auto noop = []() {};
+
+    std::atomic<int> received{0};
+    std::vector<std::thread> threads;
+    for (int c = 0; c < consumers; ++c) {
+        threads.emplace_back([&] {
+            while (queue.waitDequeue()) {
+                received.fetch_add(1, std::memory_order_relaxed);
+            }
+        });
+    }
+
+    auto start = steady_clock::now();
+    std::vector<std::thread> producer_threads;
+    for (int p = 0; p < producers; ++p) {
+        producer_threads.emplace_back([&] {
+            for (int i = 0; i < jobs_per_producer; ++i) {
+                queue.enqueue(Job::create("", noop, nullptr, milliseconds(0), 0));
+            }
+        });
+    }
+    for (auto& thread : producer_threads) {
+        thread.join();
+    }
+    int total = producers * jobs_per_producer;
+    while (received.load() < total) {
+        std::this_thread::yield();
+    }
+    double elapsed = duration<double>(steady_clock::now() - start).count();
+
+    queue.close();
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    return total / elapsed;
+}
+
+}
+
+int main() {
+    constexpr int kJobsPerProducer = 200000;
+    std::cout << "hardware threads: " << std::thread::hardware_concurrency() << "\n";
+    for (int threads : {1, 4, 8}) {
+        for (size_t shards : {size_t{1}, size_t{2}, size_t{4}, size_t{8}}) {
+            double rate = run(shards, threads, threads, kJobsPerProducer);
+            std::cout << threads << " producers / " << threads << " consumers, shards=" << shards
+                      << ": " << rate / 1e6 << " Mjobs/s\n";
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,114 @@
+/**
+ * @file TaskSubmitBenchmark.cpp
+ * @brief Measures ns/op and heap allocations per op for task wrapping and ThreadPool submission.
+ */
+
+#include "Job.hpp"
+#include "ThreadPool.hpp"
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <functional>
+#include <future>
+#include <iostream>
+#include <new>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace scheduleit;
+using namespace std::chrono;
+
+namespace {
+
+std::atomic<size_t> g_allocations{0};
+
+template <class Body>
+void measure(const char* name, int operations, Body body) {
+    size_t before = g_allocations.load();
+    auto start = steady_clock::now();
+    body(operations);
+    double ns = duration<double, std::nano>(steady_clock::now() - start).count() / operations;
+    double allocs = static_cast<double>(g_allocations.load() - before) / operations;
+    std::cout << name << ": " << ns << " ns/op, " << allocs << " allocations/op\n";
+}
+
+// A capture typical of real jobs: a few pointers and ids, too large for std::function's
+// 16-byte local buffer.
+struct Capture {
+    std::array<void*, 5> words{};
+};
+
+}
+
+void* operator new(size_t size) {
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* pointer = std::malloc(size ? size : 1)) {
+        return pointer;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* pointer) noexcept {
+    std::free(pointer);
+}
+
+void operator delete(void* pointer, size_t) noexcept {
+    std::free(pointer);
+}
+
+int main() {
+    constexpr int kWrapOps = 2000000;
+    constexpr int kSubmitOps = 500000;
+    std::atomic<int> sink{0};
+
+    measure("std::function wrap+call (40B capture)", kWrapOps, [&](int n) {
+        for (int i = 0; i < n; ++i) {
+            Capture capture;
+            std::function<void()> task([capture, &sink]() { sink += capture.words.size() > 0; });
+            task();
+        }
+    });
+    measure("UniqueFunction wrap+call (40B capture)", kWrapOps, [&](int n) {
+        for (int i = 0; i < n; ++i) {
+            Capture capture;
+            UniqueFunction<void()> task([capture, &sink]() { sink += capture.words.size() > 0; });
+            task();
+        }
+    });
+
+    for (bool stealing : {false, true}) {
+        ThreadPoolOptions options;
+        options.work_stealing = stealing;
+        const char* mode = stealing ? " [stealing]" : " [shared queue]";
+
+        {
+            ThreadPool pool(1, options);
+            std::vector<std::future<void>> futures;
+            futures.reserve(kSubmitOps);
+            measure((std::string("ThreadPool::submit") + mode).c_str(), kSubmitOps, [&](int n) {
+                for (int i = 0; i < n; ++i) {
+                    futures.push_back(pool.submit([&sink]() { ++sink; }));
+                }
+                for (auto& future : futures) {
+                    future.wait();
+                }
+            });
+        }
+        {
+            ThreadPool pool(1, options);
+            std::atomic<int> done{0};
+            measure((std::string("ThreadPool::submitDetached") + mode).c_str(), kSubmitOps, [&](int n) {
+                for (int i = 0; i < n; ++i) {
+                    pool.submitDetached([&done]() { done.fetch_add(1, std::memory_order_release); });
+                }
+                while (done.load(std::memory_order_acquire) < n) {
+                    std::this_thread::yield();
+                }
+            });
+        }
+    }
+    return sink.load() == 0;
+}
@@ -0,0 +1,95 @@
+/**
+ * @file ThreadPoolScalingBenchmark.cpp
+ * @brief Compares shared-queue and work-stealing ThreadPool throughput from 1 to N workers.
+ *
+ * Usage: thread_pool_scaling_benchmark [max_workers] [tasks]   (default: hardware threads, 200000)
+ */
+
+#include "ThreadPool.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <future>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+using namespace scheduleit;
+using namespace std::chrono;
+
+namespace {
+
+void spin(int iterations) {
+    volatile int sink = 0;
+    for (int i = 0; i < iterations; ++i) {
+        sink = sink + i;
+    }
+}
+
+// Tasks submitted from outside the pool, as the scheduler's dispatcher does.
+double external(ThreadPool& pool, int tasks) {
+    std::atomic<int> done{0};
+    auto start = steady_clock::now();
+    for (int i = 0; i < tasks; ++i) {
+        pool.submit([&done]() {
+            spin(200);
+            done.fetch_add(1, std::memory_order_relaxed);
+        });
+    }
+    while (done.load() < tasks) {
+        std::this_thread::yield();
+    }
+    return tasks / duration<double>(steady_clock::now() - start).count();
+}
+
+// Tasks that fan out more tasks from inside the pool.
+double nested(ThreadPool& pool, int tasks) {
+    constexpr int kFanOut = 100;
+    int roots = tasks / kFanOut;
+    std::atomic<int> done{0};
+    auto start = steady_clock::now();
+    for (int i = 0; i < roots; ++i) {
+        pool.submit([&pool, &done]() {
+            for (int j = 0; j < kFanOut; ++j) {
+                pool.submit([&done]() {
+                    spin(200);
+                    done.fetch_add(1, std::memory_order_relaxed);
+                });
+            }
+        });
+    }
+    while (done.load() < roots * kFanOut) {
+        std::this_thread::yield();
+    }
+    return roots * kFanOut / duration<double>(steady_clock::now() - start).count();
+}
+
+}
+
+int main(int argc, char** argv) {
+    size_t max_workers = argc > 1 ? std::strtoul(argv[1], nullptr, 10)
+                                  : std::max(1u, std::thread::hardware_concurrency());
+    int tasks = argc > 2 ? std::atoi(argv[2]) : 200000;
+
+    std::cout << "workers  shared/external  stealing/external  shared/nested  stealing/nested (tasks/sec)\n";
+    std::vector<size_t> worker_counts;
+    for (size_t workers = 1; workers < max_workers; workers *= 2) {
+        worker_counts.push_back(workers);
+    }
+    worker_counts.push_back(max_workers);
+
+    for (size_t workers : worker_counts) {
+        double results[4];
+        for (int mode = 0; mode < 2; ++mode) {
+            ThreadPoolOptions options;
+            options.work_stealing = mode == 1;
+            ThreadPool pool(workers, options);
+            results[mode] = external(pool, tasks);
+            results[mode + 2] = nested(pool, tasks);
+        }
+        std::cout << workers << "  " << results[0] << "  " << results[1] << "  "
+                  << results[2] << "  " << results[3] << '\n';
+    }
+    return 0;
+}
@@ -0,0 +1,135 @@
+/**
+ * @file TimeoutBenchmark.cpp
+ * @brief Measures task timeouts: the shared Watchdog against the former std::async wrapper.
+ *
+ * The former wrapper is reproduced here: it started a thread with std::async per task, and
+ * the future's destructor waited for the task even after the timeout had fired. The
+ * benchmark reports (1) throughput of short tasks submitted with a timeout, (2) wall time of
+ * overrunning tasks that poll for cancellation, and (3) scheduler throughput of jobs with and
+ * without Job::setTimeout().
+ *
+ * Usage: timeout_benchmark [tasks] [workers]   (default: 20000 4)
+ */
+
+#include "JobScheduler.hpp"
+#include "ThreadPool.hpp"
+#include "Watchdog.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <future>
+#include <iostream>
+#include <memory>
+#include <thread>
+#include <vector>
+
+using namespace scheduleit;
+using namespace std::chrono;
+
+namespace {
+
+/// What ThreadPool::submitWithTimeout used to queue.
+template <class F>
+void submitWithAsync(ThreadPool& pool, F f, milliseconds timeout) {
+    auto task = std::make_shared<std::packaged_task<void()>>(std::move(f));
+    pool.submitDetached([task, timeout]() {
+        auto future = std::async(std::launch::async, [task]() { (*task)(); });
+        if (future.wait_for(timeout) == std::future_status::timeout) {
+            return;  // the future's destructor still waits for the task
+        }
+        future.get();
+    });
+}
+
+void drain(ThreadPool& pool, size_t workers) {
+    std::vector<std::future<void>> done;
+    for (size_t i = 0; i < workers; ++i) {
+        done.push_back(pool.submit([]() {}));
+    }
+    for (auto& future : done) {
+        future.wait();
+    }
+}
+
+void shortTasks(int tasks, size_t workers) {
+    std::atomic<int> ran{0};
+    for (bool watchdog : {false, true}) {
+        ThreadPool pool(workers);
+        auto start = steady_clock::now();
+        for (int i = 0; i < tasks; ++i) {
+            if (watchdog) {
+                pool.submitWithTimeout([&ran]() { ran.fetch_add(1, std::memory_order_relaxed); }, milliseconds(100));
+            } else {
+                submitWithAsync(pool, [&ran]() { ran.fetch_add(1, std::memory_order_relaxed); }, milliseconds(100));
+            }
+        }
+        drain(pool, workers);
+        double seconds = duration<double>(steady_clock::now() - start).count();
+        pool.shutdown();
+        std::cout << (watchdog ? "watchdog:   " : "std::async: ") << tasks / seconds << " short tasks/s\n";
+    }
+}
+
+void overrunningTasks(size_t workers) {
+    constexpr int kTasks = 16;
+    const milliseconds work(50);
+    const milliseconds timeout(10);
+    for (bool watchdog : {false, true}) {
+        ThreadPool pool(workers);
+        auto start = steady_clock::now();
+        for (int i = 0; i < kTasks; ++i) {
+            if (watchdog) {
+                pool.submitWithTimeout([work](CancellationToken token) {
+                    auto end = steady_clock::now() + work;
+                    while (steady_clock::now() < end && !token.isCancelled()) {
+                        std::this_thread::sleep_for(microseconds(200));
+                    }
+                }, timeout);
+            } else {
+                // No token to poll: the task runs its full length.
+                submitWithAsync(pool, [work]() { std::this_thread::sleep_for(work); }, timeout);
+            }
+        }
+        drain(pool, workers);
+        double ms = duration<double, std::milli>(steady_clock::now() - start).count();
+        pool.shutdown();
+        std::cout << (watchdog ? "watchdog:   " : "std::async: ") << kTasks << " tasks of " << work.count()
+                  << " ms with a " << timeout.count() << " ms timeout took " << ms << " ms\n";
+    }
+}
+
+void scheduledJobs(int jobs, size_t workers) {
+    for (bool timed : {false, true}) {
+        JobScheduler scheduler(workers);
+        scheduler.start();
+        auto start = steady_clock::now();
+        for (int submitted = 0; submitted < jobs; submitted += 1000) {
+            std::vector<std::shared_ptr<Job>> batch;
+            for (int i = 0; i < 1000; ++i) {
+                auto job = Job::create("", []() {}, nullptr, milliseconds(0), 0);
+                if (timed) {
+                    job->setTimeout(milliseconds(1000));
+                }
+                batch.push_back(std::move(job));
+            }
+            scheduler.submitBatch(std::move(batch));
+        }
+        scheduler.waitForIdle();
+        double seconds = duration<double>(steady_clock::now() - start).count();
+        scheduler.shutdown();
+        std::cout << (timed ? "jobs with timeout:    " : "jobs without timeout: ") << jobs / seconds << " jobs/s\n";
+    }
+}
+
+}
+
+int main(int argc, char** argv) {
+    int tasks = argc > 1 ? std::atoi(argv[1]) : 20000;
+    size_t workers = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 4;
+
+    shortTasks(tasks, workers);
+    overrunningTasks(workers);
+    scheduledJobs(tasks * 25, workers);
+    return 0;
+}
@@ -0,0 +1,118 @@
+/**
+ * @file WorkflowBenchmark.cpp
+ * @brief Measures many "step, sleep, step" workflows in flight on a few workers.
+ *
+ * Each workflow polls a counter, sleeps and polls again a fixed number of times. As
+ * coroutines, all of them are in flight at once while the workers only run steps; the
+ * benchmark reports wall time against the ideal (steps x sleep), step throughput, dispatch
+ * lateness and the memory per workflow. For comparison a much smaller number of the same
+ * workflows run as plain jobs that block their worker in sleep_for, the old way.
+ *
+ * Usage: workflow_benchmark [workflows] [workers] [steps] [sleep_ms]   (default: 200000 4 5 50)
+ */
+
+#include "JobScheduler.hpp"
+#include "Utils.hpp"
+#include "Workflow.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace scheduleit;
+using namespace std::chrono;
+
+namespace {
+
+std::atomic<uint64_t> polls{0};
+
+Workflow poller(JobScheduler& scheduler, int steps, milliseconds pause) {
+    for (int i = 0; i < steps; ++i) {
+        polls.fetch_add(1, std::memory_order_relaxed);
+        co_await scheduler.sleep(pause);
+    }
+    polls.fetch_add(1, std::memory_order_relaxed);
+}
+
+/// Resident set size in KiB, from /proc.
+long residentKiB() {
+    std::ifstream status("/proc/self/status");
+    std::string line;
+    while (std::getline(status, line)) {
+        if (line.rfind("VmRSS:", 0) == 0) {
+            return std::atol(line.c_str() + 6);
+        }
+    }
+    return 0;
+}
+
+void coroutines(int workflows, size_t workers, int steps, milliseconds pause) {
+    JobScheduler scheduler(workers);
+    scheduler.start();
+    polls = 0;
+    long rss_before = residentKiB();
+    auto start = steady_clock::now();
+    for (int submitted = 0; submitted < workflows; submitted += 1000) {
+        std::vector<std::shared_ptr<Job>> batch;
+        for (int i = submitted; i < workflows && i < submitted + 1000; ++i) {
+            batch.push_back(poller(scheduler, steps, pause).intoJob());
+        }
+        scheduler.submitBatch(std::move(batch));
+    }
+    // Sample while every workflow is asleep after its first step.
+    utils::sleepForMillis(pause / 2);
+    long rss_in_flight = residentKiB();
+    size_t in_flight = scheduler.getOutstandingCount();
+    scheduler.waitForIdle();
+    double seconds = duration<double>(steady_clock::now() - start).count();
+    auto lag = scheduler.getMetrics().dispatch_lag;
+    scheduler.shutdown();
+
+    std::cout << "coroutines: " << workflows << " workflows x " << steps << " sleeps of " << pause.count()
+              << " ms on " << workers << " workers\n"
+              << "  in flight after submit: " << in_flight << ", "
+              << (rss_in_flight - rss_before) * 1024.0 / workflows << " bytes each\n"
+              << "  wall time " << seconds << " s (ideal " << steps * pause.count() / 1000.0 << " s), "
+              << polls.load() / seconds << " steps/s\n"
+              << "  wake-up lateness p50 " << lag.percentile(0.5) / 1e6 << " ms, p99 "
+              << lag.percentile(0.99) / 1e6 << " ms, max " << lag.max / 1e6 << " ms\n";
+}
+
+void blocking(int workflows, size_t workers, int steps, milliseconds pause) {
+    JobScheduler scheduler(workers);
+    scheduler.start();
+    polls = 0;
+    auto start = steady_clock::now();
+    for (int i = 0; i < workflows; ++i) {
+        scheduler.submit(Job::create("", [steps, pause]() {
+            for (int step = 0; step < steps; ++step) {
+                polls.fetch_add(1, std::memory_order_relaxed);
+                utils::sleepForMillis(pause);
+            }
+            polls.fetch_add(1, std::memory_order_relaxed);
+        }, nullptr, milliseconds(0), 0));
+    }
+    scheduler.waitForIdle();
+    double seconds = duration<double>(steady_clock::now() - start).count();
+    scheduler.shutdown();
+    std::cout << "blocking sleep_for: " << workflows << " workflows on " << workers << " workers: wall time "
+              << seconds << " s, " << polls.load() / seconds << " steps/s\n";
+}
+
+}
+
+int main(int argc, char** argv) {
+    int workflows = argc > 1 ? std::atoi(argv[1]) : 200000;
+    size_t workers = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 4;
+    int steps = argc > 3 ? std::atoi(argv[3]) : 5;
+    milliseconds pause(argc > 4 ? std::atoi(argv[4]) : 50);
+
+    coroutines(workflows, workers, steps, pause);
+    blocking(static_cast<int>(workers) * 4, workers, steps, pause);
+    return 0;
+}
@@ -0,0 +1,191 @@
+/**
+ * @file AdmissionController.hpp
+ * @brief Declares the AdmissionController that bounds and rate-limits what a JobScheduler
+ *        accepts.
+ */
+
+#pragma once
+
+#include "CompletionTracker.hpp"
+#include "Job.hpp"
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace scheduleit {
+
+/**
+ * @enum OverloadPolicy
+ * @brief What JobScheduler::submit() does with a job that does not fit.
+ */
+enum class OverloadPolicy {
+    Block,              ///< Wait for room or a token, up to AdmissionOptions::max_block.
+    Reject,             ///< Turn the job away at once.
+    /// Cancel a queued job of a lower priority to make room, else reject. Only jobs still in
+    /// the JobQueue can be shed: pair it with a PriorityPolicy, max_pool_queue_size or
+    /// DispatchMode::Direct, or ready jobs move on to the pool at once.
+    ShedLowestPriority
+};
+
+/**
+ * @struct RateLimit
+ * @brief A token bucket: jobs_per_second tokens accrue up to burst, and each job takes one.
+ */
+struct RateLimit {
+    double jobs_per_second = 0;
+    double burst = 1;
+};
+
+/**
+ * @struct AdmissionOptions
+ * @brief Admission control for a JobScheduler; the defaults admit everything.
+ */
+struct AdmissionOptions {
+    /// Most jobs outstanding at once (queued, running or awaiting a retry; a recurring series
+    /// counts once). 0 for unbounded. Graphs and recovered journal jobs count, but are not
+    /// turned away.
+    size_t max_pending = 0;
+    OverloadPolicy policy = OverloadPolicy::Block;
+    /// Longest a Block submit waits for room and tokens before it gives up.
+    std::chrono::milliseconds max_block = std::chrono::milliseconds::max();
+    /// Token buckets by Job::getTag(); jobs with other tags are not rate-limited. Over its
+    /// rate, a job waits under Block and is turned away under the other policies.
+    std::unordered_map<std::string, RateLimit> rate_limits;
+    /// Share of max_pending from which QueuePressure reports PressureLevel::Elevated.
+    double elevated_at = 0.75;
+};
+
+/**
+ * @enum SubmitStatus
+ * @brief Outcome of JobScheduler::trySubmit().
+ */
+enum class SubmitStatus {
+    Accepted,     ///< Queued, possibly after a lower-priority job was shed for it.
+    Full,         ///< max_pending jobs are outstanding.
+    RateLimited,  ///< The job's tag is out of tokens.
+    Invalid       ///< The job was null.
+};
+
+/**
+ * @enum PressureLevel
+ * @brief Coarse load signal for producers that can slow down.
+ */
+enum class PressureLevel {
+    Normal,     ///< Below AdmissionOptions::elevated_at, or no max_pending.
+    Elevated,   ///< Filling up; a producer that can defer work should.
+    Saturated   ///< At max_pending; new jobs wait, are rejected or shed others.
+};
+
+/**
+ * @struct QueuePressure
+ * @brief What JobScheduler::getQueuePressure() reports; the counters only grow.
+ */
+struct QueuePressure {
+    PressureLevel level = PressureLevel::Normal;
+    size_t outstanding = 0;         ///< Jobs submitted and not finished.
+    size_t capacity = 0;            ///< max_pending; 0 for unbounded.
+    double utilization = 0;         ///< outstanding / capacity; 0 for unbounded.
+    size_t blocked_submitters = 0;  ///< Threads waiting in submit() right now.
+    uint64_t accepted = 0;
+    uint64_t rejected = 0;          ///< Turned away for want of room.
+    uint64_t rate_limited = 0;      ///< Turned away for want of a token.
+    uint64_t shed = 0;              ///< Queued jobs cancelled to make room.
+    uint64_t blocked = 0;           ///< Submits that had to wait.
+};
+
+/**
+ * @class AdmissionController
+ * @brief Decides, before a job is queued, whether a JobScheduler takes it.
+ *
+ * Room is reserved in the CompletionTracker with a compare-and-swap on its outstanding count,
+ * so concurrent submitters never overshoot max_pending and an admitted job needs no further
+ * accounting: it frees its slot when it finishes. Token buckets are looked up by tag in a map
+ * fixed at construction, each with its own lock. For shedding, admitted jobs are remembered
+ * per priority class; the newest queued job of the lowest class below the newcomer's is
+ * cancelled, since it has waited least.
+ */
+class AdmissionController {
+public:
+    using CancelFunction = std::function<bool(const std::shared_ptr<Job>&)>;
+
+    /**
+     * @param options Limits and policy.
+     * @param tracker The scheduler's tracker, which holds the outstanding count.
+     * @param cancel Withdraws a queued job as JobScheduler::cancel() does; used for shedding.
+     * @throws std::invalid_argument for a rate limit that is not positive or a burst below 1.
+     */
+    AdmissionController(AdmissionOptions options, std::shared_ptr<CompletionTracker> tracker, CancelFunction cancel);
+
+    /**
+     * @brief Takes a token and a slot for the job, waiting if allowed and the policy is Block.
+     *
+     * On Accepted the job is counted as outstanding: pass reserved to
+     * CompletionTracker::onSubmitted(), then call onQueued() once it is queued.
+     */
+    SubmitStatus admit(const Job& job, bool may_wait);
+
+    /**
+     * @brief Admits a batch in order, handing each admitted run of jobs to accept (counted,
+     *        as after admit()). Under Block, a run is accepted before waiting for the next, so
+     *        a batch larger than max_pending drains through.
+     * @return The number of jobs accepted.
+     */
+    size_t admitBatch(std::vector<std::shared_ptr<Job>>& jobs,
+                      const std::function<void(std::vector<std::shared_ptr<Job>>&)>& accept);
+
+    /**
+     * @brief True if admitted jobs must be passed to onQueued(): shedding with a max_pending.
+     */
+    bool shedsLoad() const {
+        return options_.policy == OverloadPolicy::ShedLowestPriority && options_.max_pending > 0;
+    }
+
+    /**
+     * @brief Makes a queued job a candidate for shedding, unless it is recurring.
+     */
+    void onQueued(const std::shared_ptr<Job>& job);
+
+    QueuePressure getPressure() const;
+
+private:
+    struct TokenBucket {
+        std::mutex mutex;
+        RateLimit limit;
+        double tokens;
+        std::chrono::steady_clock::time_point refilled;
+    };
+
+    using Deadline = std::chrono::steady_clock::time_point;
+
+    Deadline deadlineFor(bool may_wait) const;
+    TokenBucket* bucketFor(const Job& job) const;
+    bool takeToken(const Job& job, Deadline deadline, bool& waited);
+    /// Gives back the token of a job that was then turned away for want of room.
+    void refundToken(const Job& job);
+    /// Reserves up to count slots, shedding or waiting as the policy says; 0 if none.
+    size_t reserve(size_t count, JobPriority priority, Deadline deadline, bool& waited);
+    bool shedBelow(JobPriority priority);
+
+    AdmissionOptions options_;
+    std::shared_ptr<CompletionTracker> tracker_;
+    CancelFunction cancel_;
+    std::unordered_map<std::string, std::unique_ptr<TokenBucket>> buckets_;
+    std::mutex shed_mutex_;
+    std::array<std::deque<std::weak_ptr<Job>>, kJobPriorityCount> candidates_;  // oldest first
+    std::atomic<size_t> blocked_submitters_{0};
+    std::atomic<uint64_t> accepted_{0};
+    std::atomic<uint64_t> rejected_{0};
+    std::atomic<uint64_t> rate_limited_{0};
+    std::atomic<uint64_t> shed_{0};
+    std::atomic<uint64_t> blocked_{0};
+};
+
+}
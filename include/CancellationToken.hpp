@@ -0,0 +1,187 @@
+/**
+ * @file CancellationToken.hpp
+ * @brief Declares cooperative cancellation: CancellationSource, CancellationToken and their shared state.
+ */
+
+#pragma once
+
+#include "UniqueFunction.hpp"
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+
+namespace scheduleit {
+
+/**
+ * @enum CancellationReason
+ * @brief Why a token was cancelled.
+ */
+enum class CancellationReason : uint8_t {
+    None,       ///< Not cancelled.
+    Cancelled,  ///< CancellationSource::cancel() was called.
+    TimedOut    ///< The Watchdog found the work past its deadline.
+};
+
+/**
+ * @class TaskCancelledError
+ * @brief Thrown by CancellationToken::throwIfCancelled().
+ */
+class TaskCancelledError : public std::runtime_error {
+public:
+    explicit TaskCancelledError(CancellationReason reason)
+        : std::runtime_error(reason == CancellationReason::TimedOut ? "Task timed out" : "Task cancelled"),
+          reason_(reason) {}
+
+    CancellationReason getReason() const {
+        return reason_;
+    }
+
+private:
+    CancellationReason reason_;
+};
+
+/**
+ * @class CancellationState
+ * @brief The state a source and its tokens share: running, finished, or cancelled for a reason.
+ *
+ * Exactly one of finish() and cancel() succeeds, so the worker that ends the work and the
+ * thread that cancels it agree on the outcome without a lock.
+ */
+class CancellationState {
+public:
+    /// Run on the Watchdog thread if the state times out; dropped if it finishes first.
+    using ExpiryCallback = UniqueFunction<void()>;
+
+    CancellationReason getReason() const {
+        switch (status_.load(std::memory_order_acquire)) {
+            case kCancelled:
+                return CancellationReason::Cancelled;
+            case kTimedOut:
+                return CancellationReason::TimedOut;
+            default:
+                return CancellationReason::None;
+        }
+    }
+
+    /**
+     * @brief Marks the work as ended. Also drops the expiry callback.
+     * @return False if it had been cancelled first.
+     */
+    bool finish() {
+        if (!transition(kFinished)) {
+            return false;
+        }
+        on_expire_ = nullptr;
+        return true;
+    }
+
+    /**
+     * @brief Cancels the work unless it has already ended or been cancelled.
+     * @return True if this call cancelled it.
+     */
+    bool cancel() {
+        if (!transition(kCancelled)) {
+            return false;
+        }
+        on_expire_ = nullptr;
+        return true;
+    }
+
+    /**
+     * @brief After a timeout, waits until the Watchdog has run and released the expiry callback.
+     *
+     * Lets the worker report the failure after the timeout, and outlive the callback.
+     */
+    void waitForExpiry() const {
+        while (!expired_.load(std::memory_order_acquire)) {
+            std::this_thread::yield();
+        }
+    }
+
+    /// True until finish() or cancel() succeeded.
+    bool isRunning() const {
+        return status_.load(std::memory_order_acquire) == kRunning;
+    }
+
+private:
+    friend class Watchdog;
+
+    static constexpr uint8_t kRunning = 0;
+    static constexpr uint8_t kFinished = 1;
+    static constexpr uint8_t kCancelled = 2;
+    static constexpr uint8_t kTimedOut = 3;
+
+    bool transition(uint8_t to) {
+        uint8_t expected = kRunning;
+        return status_.compare_exchange_strong(expected, to, std::memory_order_acq_rel);
+    }
+
+    std::atomic<uint8_t> status_{kRunning};
+    std::atomic<bool> expired_{false};  // set by the Watchdog once the callback is done
+    ExpiryCallback on_expire_;  // owned by whichever of finish() and the Watchdog wins
+};
+
+/**
+ * @class CancellationToken
+ * @brief Read side of a cancellation, handed to the work. Copying is cheap.
+ *
+ * Cancellation is cooperative: nothing interrupts the work, which should poll the token at
+ * convenient points and stop, typically by calling throwIfCancelled(). A default token is
+ * never cancelled.
+ */
+class CancellationToken {
+public:
+    CancellationToken() = default;
+    explicit CancellationToken(std::shared_ptr<const CancellationState> state) : state_(std::move(state)) {}
+
+    /// One atomic load; cheap enough for tight loops.
+    bool isCancelled() const {
+        return state_ && state_->getReason() != CancellationReason::None;
+    }
+
+    CancellationReason getReason() const {
+        return state_ ? state_->getReason() : CancellationReason::None;
+    }
+
+    /**
+     * @throws TaskCancelledError if the token has been cancelled.
+     */
+    void throwIfCancelled() const {
+        CancellationReason reason = getReason();
+        if (reason != CancellationReason::None) {
+            throw TaskCancelledError(reason);
+        }
+    }
+
+private:
+    std::shared_ptr<const CancellationState> state_;
+};
+
+/**
+ * @class CancellationSource
+ * @brief Write side of a cancellation: hands out tokens and cancels them.
+ */
+class CancellationSource {
+public:
+    CancellationSource() : state_(std::make_shared<CancellationState>()) {}
+
+    CancellationToken getToken() const {
+        return CancellationToken(state_);
+    }
+
+    /// @return True if this call cancelled the work.
+    bool cancel() {
+        return state_->cancel();
+    }
+
+    const std::shared_ptr<CancellationState>& getState() const {
+        return state_;
+    }
+
+private:
+    std::shared_ptr<CancellationState> state_;
+};
+
+}
@@ -0,0 +1,109 @@
+/**
+ * @file CompletionTracker.hpp
+ * @brief Declares the CompletionTracker that lets callers wait for submitted jobs to finish.
+ */
+
+#pragma once
+
+#include "Job.hpp"
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace scheduleit {
+
+/**
+ * @class CompletionTracker
+ * @brief Counts jobs from submission until they succeed or fail permanently.
+ *
+ * A job stays outstanding while it is queued, running, or waiting for a retry. The common
+ * path is a single atomic counter; the mutex is only taken when the count reaches zero, so
+ * waiters wake as soon as the last job finishes. Jobs with a non-empty id are also counted
+ * per id in one of kIdShards maps chosen by the id's hash, each with its own lock, so
+ * submitters and workers only contend when their ids share a shard.
+ */
+class CompletionTracker {
+public:
+    /**
+     * @brief Records a newly submitted job.
+     * @param reserved True if reserve() already counted the job.
+     */
+    void onSubmitted(const Job& job, bool reserved = false);
+
+    /**
+     * @brief Records a batch of newly submitted jobs.
+     * @param reserved True if reserve() already counted the jobs.
+     */
+    void onSubmittedBatch(const std::vector<std::shared_ptr<Job>>& jobs, bool reserved = false);
+
+    /**
+     * @brief Counts up to count jobs as outstanding ahead of onSubmitted(), as many as fit
+     *        under limit. Lock-free.
+     * @return The number of jobs counted, 0 if limit is reached.
+     */
+    size_t reserve(size_t count, size_t limit);
+
+    /**
+     * @brief Like reserve(), but first blocks until fewer than limit jobs are outstanding or
+     *        the timeout expires.
+     */
+    size_t waitToReserve(size_t count, size_t limit,
+                         std::chrono::milliseconds timeout = std::chrono::milliseconds::max());
+
+    /**
+     * @brief Records that a job reached a terminal state.
+     */
+    void onCompleted(const Job& job);
+
+    /**
+     * @brief Returns the number of submitted jobs that have not finished.
+     */
+    size_t getOutstandingCount() const {
+        return outstanding_.load();
+    }
+
+    /**
+     * @brief Blocks until no job is outstanding or the timeout expires.
+     * @return True if idle.
+     */
+    bool waitForIdle(std::chrono::milliseconds timeout = std::chrono::milliseconds::max());
+
+    /**
+     * @brief Blocks until none of the given job ids is outstanding or the timeout expires.
+     * @return True if all listed jobs finished.
+     */
+    bool waitForJobs(const std::vector<std::string>& ids,
+                     std::chrono::milliseconds timeout = std::chrono::milliseconds::max());
+
+private:
+    static constexpr size_t kIdShards = 16;
+
+    /// Outstanding jobs per id, for the ids whose hash selects this shard.
+    struct alignas(64) IdShard {
+        std::mutex mutex;
+        std::unordered_map<std::string, size_t> counts;
+    };
+
+    IdShard& shardFor(const std::string& id) {
+        return id_shards_[std::hash<std::string>()(id) % kIdShards];
+    }
+    void addId(const std::string& id);
+
+    template <class Predicate>
+    bool waitUntil(std::unique_lock<std::mutex>& lock, std::chrono::milliseconds timeout, Predicate done);
+
+    std::atomic<size_t> outstanding_{0};
+    mutable std::mutex mutex_;
+    std::condition_variable cv_;
+    std::array<IdShard, kIdShards> id_shards_;
+    std::atomic<int> id_waiters_{0};        // checked by onCompleted() without mutex_
+    std::atomic<int> capacity_waiters_{0};  // checked by onCompleted() without the lock
+};
+
+}
@@ -0,0 +1,107 @@
+/**
+ * @file CpuTopology.hpp
+ * @brief Declares CpuTopology, the CPUs of each NUMA node, used to place and pin workers.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace scheduleit {
+
+/**
+ * @class CpuTopology
+ * @brief Lists the CPUs of each NUMA node.
+ *
+ * A ThreadPool or JobScheduler given a topology groups its workers by node, keeps one ready
+ * queue per node and can pin each worker to a CPU of its node. The topology can come from
+ * sysfs, from a CPU list (one node), or be made up to simulate a multi-node machine.
+ *
+ * Nodes without CPUs are left out, so a node's index (0 to getNodeCount() - 1) may differ
+ * from its id. The id is the kernel's node number for a detected topology, and the position
+ * in the constructor's list otherwise. Placement hints (Job::setPreferredNode(),
+ * ThreadPool::submitDetachedToNode()) take ids.
+ */
+class CpuTopology {
+public:
+    /// Placement hint meaning "any node".
+    static constexpr size_t kAnyNode = static_cast<size_t>(-1);
+
+    /**
+     * @brief Reads the NUMA nodes from /sys/devices/system/node.
+     *
+     * Falls back to one node holding the online CPUs, or hardware_concurrency() CPUs when
+     * sysfs is not available.
+     */
+    static CpuTopology detect();
+
+    /**
+     * @brief One node holding the CPUs of a list such as "0-3,8,10-11".
+     * @throws std::invalid_argument if the list is malformed or empty.
+     */
+    static CpuTopology fromCpuList(const std::string& cpu_list);
+
+    /**
+     * @brief A made-up machine: node n holds CPUs n * cpus_per_node to (n + 1) * cpus_per_node - 1.
+     *
+     * CPUs that do not exist cannot be pinned to; workers stay unpinned then.
+     * @throws std::invalid_argument if either count is zero.
+     */
+    static CpuTopology simulated(size_t nodes, size_t cpus_per_node);
+
+    /**
+     * @brief Builds a topology from explicit node CPU lists; empty nodes are dropped.
+     *
+     * Each remaining node keeps its position in the list as its id.
+     * @throws std::invalid_argument if no node has a CPU.
+     */
+    explicit CpuTopology(std::vector<std::vector<int>> nodes);
+
+    /**
+     * @brief Parses a sysfs-style CPU list, e.g. "0-3,8" -> {0, 1, 2, 3, 8}.
+     * @throws std::invalid_argument if the list is malformed.
+     */
+    static std::vector<int> parseCpuList(const std::string& cpu_list);
+
+    size_t getNodeCount() const {
+        return nodes_.size();
+    }
+
+    /// The CPUs of the node at an index.
+    const std::vector<int>& getCpus(size_t index) const {
+        return nodes_[index];
+    }
+
+    /// The id of the node at an index.
+    size_t getNodeId(size_t index) const {
+        return node_ids_[index];
+    }
+
+    /**
+     * @brief Returns the index of the node with an id, or kAnyNode if there is no such node
+     *        with CPUs.
+     */
+    size_t findNode(size_t node_id) const;
+
+    size_t getCpuCount() const;
+
+    /**
+     * @brief The CPU for the n-th worker: workers go round-robin over the nodes, then over
+     *        each node's CPUs.
+     */
+    int getCpuForWorker(size_t worker) const;
+
+    /**
+     * @brief Pins the calling thread to one CPU.
+     * @return False if the CPU does not exist or pinning is not supported here.
+     */
+    static bool pinCurrentThread(int cpu);
+
+private:
+    std::vector<std::vector<int>> nodes_;
+    std::vector<size_t> node_ids_;  // per index
+};
+
+}
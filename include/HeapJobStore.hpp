@@ -0,0 +1,46 @@
+/**
+ * @file HeapJobStore.hpp
+ * @brief Defines the binary-heap JobStore used by default.
+ */
+
+#pragma once
+
+#include "JobStore.hpp"
+#include <vector>
+
+namespace scheduleit {
+
+/**
+ * @class HeapJobStore
+ * @brief Min-heap on scheduled time. O(log n) push and pop, exact ordering.
+ *
+ * A batch push appends and then either sifts each new job up or rebuilds the whole heap in
+ * O(n), whichever is cheaper for the batch size. Stale entries, including those of moved jobs,
+ * are removed with one O(n) rebuild.
+ */
+class HeapJobStore : public JobStore {
+public:
+    void push(std::shared_ptr<Job> job) override;
+    void pushBatch(std::vector<std::shared_ptr<Job>>& jobs) override;
+    std::shared_ptr<Job> popReady(Job::TimePoint now) override;
+    Job::TimePoint nextWakeTime() const override;
+    void removeStale(std::vector<std::shared_ptr<Job>>& removed) override;
+    size_t size() const override;
+
+private:
+    // The scheduled time is copied into the entry so that sifting never dereferences a job.
+    struct Entry {
+        Job::TimePoint time;
+        std::shared_ptr<Job> job;
+    };
+
+    struct CompareEntry {
+        bool operator()(const Entry& lhs, const Entry& rhs) const {
+            return lhs.time > rhs.time; // min-heap
+        }
+    };
+
+    std::vector<Entry> heap_;
+};
+
+}
@@ -0,0 +1,38 @@
+/**
+ * @file JitterRetryStrategy.hpp
+ * @brief Defines a retry strategy decorator that randomizes backoff delays.
+ */
+
+#pragma once
+
+#include "RetryStrategy.hpp"
+#include <chrono>
+#include <memory>
+
+namespace scheduleit {
+
+/**
+ * @class JitterRetryStrategy
+ * @brief Wraps another strategy and subtracts a random fraction from each delay.
+ *
+ * Spreading retries out keeps a burst of failures from coming back as a burst of retries.
+ * A ratio of 0 disables jitter, 0.5 gives "equal jitter", and 1 gives "full jitter".
+ */
+class JitterRetryStrategy : public RetryStrategy {
+public:
+    /**
+     * @brief Constructor.
+     * @param base The strategy whose delays are jittered.
+     * @param jitter_ratio Maximum fraction of the base delay to remove, in [0, 1].
+     */
+    JitterRetryStrategy(std::shared_ptr<RetryStrategy> base, double jitter_ratio);
+
+    bool shouldRetry(int attempt) const override;
+    std::chrono::milliseconds getBackoffDelay(int attempt) const override;
+
+private:
+    std::shared_ptr<RetryStrategy> base_;
+    double jitter_ratio_;
+};
+
+}
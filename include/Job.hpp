@@ -10,10 +10,115 @@
 #include <memory>
 #include <string>
 #include <atomic>
+#include <cstdint>
+#include "CancellationToken.hpp"
+#include "CpuTopology.hpp"
+#include "PoolAllocator.hpp"
 #include "RetryStrategy.hpp"
+#include "UniqueFunction.hpp"
 
 namespace scheduleit {
 
+/**
+ * @enum JobPriority
+ * @brief Quality-of-service class of a job, highest first.
+ *
+ * Only affects the order in which due jobs leave a JobQueue configured with a PriorityPolicy.
+ */
+enum class JobPriority {
+    Critical,
+    High,
+    Normal,
+    Low
+};
+
+constexpr size_t kJobPriorityCount = 4;
+
+/**
+ * @enum ExecutionClass
+ * @brief Which of a JobScheduler's pools runs a job.
+ *
+ * Only matters to a scheduler given a separate blocking pool (SchedulerOptions::blocking);
+ * otherwise every class runs on the one pool.
+ */
+enum class ExecutionClass {
+    Compute,  ///< Short CPU-bound work; sized to the cores.
+    Blocking  ///< Work that waits on I/O, locks or other services.
+};
+
+constexpr size_t kExecutionClassCount = 2;
+
+/**
+ * @enum JobState
+ * @brief Where a job is in its life cycle.
+ */
+enum class JobState {
+    Created,   ///< Not yet handed to a queue.
+    Queued,    ///< Waiting in a JobQueue, either for its time or for a pending retry.
+    Running,   ///< Taken off the queue by a worker.
+    Finished,  ///< Ran for the last time, successfully or not.
+    Cancelled, ///< Withdrawn from the queue before it ran.
+    Expired    ///< Dropped unrun because it could no longer start in time (Job::setDeadline()).
+};
+
+/**
+ * @enum RecurrenceMode
+ * @brief How the next firing of a recurring job is timed.
+ */
+enum class RecurrenceMode {
+    FixedRate,  ///< Firings sit on a fixed grid: previous nominal time + period. No drift.
+    FixedDelay  ///< The next firing starts one period after the previous one finished.
+};
+
+/**
+ * @enum MissedFiringPolicy
+ * @brief What a fixed-rate job does with grid slots that passed while it was late.
+ */
+enum class MissedFiringPolicy {
+    CatchUp,  ///< Run every missed firing, back to back, until the job is on schedule again.
+    Skip      ///< Drop the missed firings and continue at the next slot of the grid.
+};
+
+/**
+ * @struct Recurrence
+ * @brief Makes a job fire repeatedly. A zero period means the job runs once.
+ */
+struct Recurrence {
+    RecurrenceMode mode = RecurrenceMode::FixedRate;
+    std::chrono::milliseconds period{0};
+    MissedFiringPolicy missed = MissedFiringPolicy::Skip;
+    uint64_t max_firings = 0;  ///< Stop after this many firings; 0 runs until cancelled.
+};
+
+/**
+ * @struct DurableTask
+ * @brief Names a job's task so a Journal can rebuild it after a restart; see TaskRegistry.
+ */
+struct DurableTask {
+    std::string name;     ///< Key of the task factory in the TaskRegistry.
+    std::string payload;  ///< Opaque argument the factory turns back into the task.
+};
+
+class Job;
+class JobExecutor;
+
+/**
+ * @class CompletionWaiter
+ * @brief Intrusive node for waiting on a job without a lock; see Job::addCompletionWaiter().
+ */
+class CompletionWaiter {
+public:
+    /// Runs once, on the thread that finished or cancelled the job.
+    virtual void onJobCompleted(bool succeeded) = 0;
+
+protected:
+    ~CompletionWaiter() = default;
+
+private:
+    friend class Job;
+    CompletionWaiter* next_ = nullptr;
+};
+
 /**
  * @class Job
  * @brief Represents a unit of work to be executed by the scheduler.
@@ -24,7 +129,13 @@ namespace scheduleit {
 class Job {
 public:
     using TimePoint = std::chrono::system_clock::time_point;
-    using Task = std::function<void()>;
+    /// Move-only, so tasks may capture move-only state; small captures are stored inline.
+    using Task = UniqueFunction<void()>;
+    /// Called before each retry with the upcoming attempt number; returning false cancels it.
+    using RetryHook = std::function<bool(const Job&, int attempt)>;
+    /// Called once when the job is done for good; succeeded is false after a final failure
+    /// or a cancellation. Move-only like Task, so small captures do not allocate.
+    using CompletionHook = UniqueFunction<void(const Job&, bool succeeded)>;
 
     Job(std::string id,
         Task task,
@@ -32,8 +143,22 @@ public:
         std::chrono::milliseconds delay = std::chrono::milliseconds(0),
         int max_retries = 3);
 
+    /**
+     * @brief Creates a job in pooled memory, together with its reference counts.
+     *
+     * Takes the same arguments as the constructor. Blocks are recycled through per-thread
+     * free lists, so steady-state job churn does not reach malloc.
+     */
+    template <class... Args>
+    static std::shared_ptr<Job> create(Args&&... args) {
+        return std::allocate_shared<Job>(PoolAllocator<Job>(), std::forward<Args>(args)...);
+    }
+
     const std::string& getId() const;
     TimePoint getScheduledTime() const;
+    /// Returns when the job was last put into a JobQueue: submission, retry or next firing.
+    TimePoint getEnqueuedTime() const;
+    /// Sets a new start time. Only for a job that is not queued; use JobHandle for queued ones.
     void reschedule(std::chrono::milliseconds delay);
     void execute() const;
     bool shouldRetry() const;
@@ -42,13 +167,260 @@ public:
     int getMaxRetries() const;
     std::shared_ptr<RetryStrategy> getRetryStrategy() const;
 
+    /**
+     * @brief Installs a hook that can veto individual retries.
+     * @param hook Callback consulted before every retry of this job.
+     */
+    void setRetryHook(RetryHook hook);
+
+    /**
+     * @brief Asks the retry hook, if any, whether the given attempt may proceed.
+     * @param attempt The attempt number the retry would run as.
+     */
+    bool approveRetry(int attempt) const;
+
+    /**
+     * @brief Installs a hook run by the executor when the job finishes for good.
+     *
+     * Runs on the worker that finished the job, or on the thread that cancelled it, before
+     * the job stops counting as outstanding. Must be set before the job is submitted.
+     */
+    void setCompletionHook(CompletionHook hook);
+
+    /**
+     * @brief Runs the completion hook, if any.
+     */
+    void notifyCompleted(bool succeeded) const;
+
+    /**
+     * @brief Adds a waiter that is run once the job finishes for good, after the completion hook.
+     *
+     * Lock-free, and may be called from any thread at any time. The waiter must stay alive
+     * until it has been run.
+     * @return False if the job has already finished; the waiter is then never run.
+     */
+    bool addCompletionWaiter(CompletionWaiter* waiter);
+
+    /**
+     * @brief Returns true if the job has finished and its last run succeeded.
+     */
+    bool completedSuccessfully() const;
+
+    /**
+     * @brief Returns the job whose task is running on the calling worker, or nullptr.
+     */
+    static Job* current();
+
+    /**
+     * @brief From the job's own task: once the task returns, queue the job again to run
+     *        after the delay instead of finishing it. The worker is free meanwhile.
+     *
+     * This is how a Workflow sleeps. Observers hear about the job only when it finishes.
+     */
+    void suspendFor(std::chrono::nanoseconds delay);
+
+    /**
+     * @brief From the job's own task: once the task returns, keep the job out of the queue,
+     *        still outstanding, until wake() is called.
+     */
+    void suspendUntilWoken();
+
+    /**
+     * @brief Withdraws a suspension requested by the running task.
+     */
+    void cancelSuspension();
+
+    /**
+     * @brief Queues a job suspended by suspendUntilWoken() to run now. Call exactly once per
+     *        suspension; it may be called before the suspending task has returned.
+     */
+    void wake();
+
+    /**
+     * @brief Gives every attempt a time limit. Must be called before the job is submitted.
+     *
+     * The shared Watchdog flags an attempt that runs longer: its cancellation token turns
+     * TimedOut and observers get onJobTimedOut() at once. Nothing interrupts the task; once
+     * it returns, the attempt counts as failed whatever it did, and the retry strategy
+     * decides what follows. A zero timeout, the default, arms nothing.
+     * @throws std::invalid_argument if the timeout is negative.
+     */
+    void setTimeout(std::chrono::milliseconds timeout);
+    std::chrono::milliseconds getTimeout() const;
+
+    /**
+     * @brief Returns the cancellation token of the running attempt, for the task to poll,
+     *        e.g. `Job::current()->getCancellationToken().throwIfCancelled()`.
+     *
+     * Only valid from the job's own task. Never cancelled for a job without a timeout.
+     */
+    CancellationToken getCancellationToken() const;
+
+    /**
+     * @brief Asks for the job to run on a worker of one NUMA node, e.g. the node whose memory
+     *        it works on. Must be called before the job is submitted.
+     *
+     * Honoured by a scheduler given a CpuTopology; idle workers of other nodes may still steal
+     * the job. The node is a topology node id, the kernel's node number for
+     * CpuTopology::detect(). CpuTopology::kAnyNode, the default, or an id the topology has no
+     * CPUs for places it anywhere.
+     */
+    void setPreferredNode(size_t node);
+    size_t getPreferredNode() const;
+
+    /**
+     * @brief Labels the job for admission control, e.g. with its tenant or source, so a
+     *        JobScheduler can rate-limit it (AdmissionOptions::rate_limits). Must be called
+     *        before the job is submitted. Not journaled.
+     */
+    void setTag(std::string tag);
+    const std::string& getTag() const;
+
+    /**
+     * @brief Sets when the job's result stops being useful. Must be called before the job
+     *        is submitted.
+     *
+     * An attempt that would start past the deadline is dropped instead of run. With an
+     * expected run time, an attempt is also dropped when fewer than that remain before the
+     * deadline, since it could not finish in time. The job then ends as Expired and
+     * observers get onJobExpired(); a running attempt is left to finish. Under
+     * PriorityPolicy::EarliestDeadlineFirst, due jobs leave the queue in deadline order. A
+     * recurring job's deadline keeps its distance from each firing's nominal time. Not
+     * journaled.
+     * @param deadline When the result stops being useful.
+     * @param expected_run How long an attempt takes; 0 drops only attempts already late.
+     */
+    void setDeadline(TimePoint deadline, std::chrono::microseconds expected_run = std::chrono::microseconds(0));
+    TimePoint getDeadline() const;  ///< TimePoint::max() without a deadline.
+    bool hasDeadline() const;
+    /// Returns the latest time a fresh attempt may start: the deadline less the expected run time.
+    TimePoint getLatestStart() const;
+
+    /**
+     * @brief Sets the job's QoS class. Must be called before the job is submitted.
+     */
+    void setPriority(JobPriority priority);
+    JobPriority getPriority() const;
+
+    /**
+     * @brief Sets the pool the job runs on. Must be called before the job is submitted.
+     *
+     * Retries, later firings and resumed suspensions of the job stay in its class.
+     */
+    void setExecutionClass(ExecutionClass execution_class);
+    ExecutionClass getExecutionClass() const;
+
+    JobState getState() const;
+
+    /**
+     * @brief Makes the job recurring. Must be called before the job is submitted.
+     *
+     * The same Job object is queued again after each firing, with its attempt count reset;
+     * retries of a failed firing happen before the next firing is planned. A recurring job
+     * stays outstanding for waitForIdle() until its series ends or is cancelled.
+     * @throws std::invalid_argument if the period is negative.
+     */
+    void setRecurrence(const Recurrence& recurrence);
+    const Recurrence& getRecurrence() const;
+    bool isRecurring() const;
+
+    /**
+     * @brief Returns the number of firings started so far.
+     */
+    uint64_t getFiringCount() const;
+
+    /**
+     * @brief Marks the job as rebuildable from a named task. Only such jobs are journaled.
+     * Must be called before the job is submitted; TaskRegistry::create() does it.
+     */
+    void setDurableTask(std::string name, std::string payload);
+
+    /**
+     * @brief Returns the job's task name and payload, or nullptr if it is not durable.
+     */
+    const DurableTask* getDurableTask() const;
+
 private:
+    friend class JobQueue;
+    friend class JobExecutor;
+    friend class JobScheduler;
+    friend class Journal;
+
+    enum class Suspension : uint8_t {
+        None,
+        Sleep,  // requeue at scheduled_time_
+        Park    // wait for wake()
+    };
+
+    // The state word packs a JobState with a generation that changes whenever the job is
+    // queued again or moved, so a consumer that read the old scheduled time cannot claim it.
+    static constexpr uint64_t kStateBits = 3;
+    static constexpr uint64_t kStateMask = (uint64_t{1} << kStateBits) - 1;
+    static constexpr uint64_t kMoving = kStateMask;  // transient, while the scheduled time changes
+
+    static constexpr uint64_t packState(JobState state, uint64_t generation) {
+        return (generation << kStateBits) | static_cast<uint64_t>(state);
+    }
+
+    /// Marks the job queued; returns true if it already was, i.e. it now has a duplicate entry.
+    bool markQueued();
+    /// Queued and due at now -> Running. Fails for entries made stale by cancel or move.
+    bool claim(TimePoint now);
+    /// Queued -> Cancelled.
+    bool cancelQueued();
+    /// Created -> Cancelled, for a job held back before it was ever queued.
+    bool cancelUnqueued();
+    /// Changes the scheduled time of a queued job; its existing queue entry becomes stale.
+    bool moveQueued(TimePoint time);
+    void markFinished();
+    /// Running -> Expired.
+    void markExpired();
+    uint64_t waitUntilSettled() const;
+
+    /// Records the start of a firing and its nominal time.
+    void beginFiring();
+    /// Sets the next firing time and resets the attempts; false once the series is over.
+    bool planNextFiring();
+    /// Ends the series after the current firing; false if it was already ended.
+    bool stopRecurrence();
+    bool recurrenceStopped() const;
+
     std::string id_;
     Task task_;
     std::shared_ptr<RetryStrategy> retry_strategy_;
     int max_retries_;
     std::atomic<int> attempt_;
-    TimePoint scheduled_time_;
+    std::atomic<TimePoint> scheduled_time_;
+    std::atomic<TimePoint> enqueued_time_{};  // set by JobQueue, read for queue-wait metrics
+    std::atomic<uint64_t> state_{0};
+    RetryHook retry_hook_;
+    CompletionHook completion_hook_;
+    JobPriority priority_ = JobPriority::Normal;
+    ExecutionClass execution_class_ = ExecutionClass::Compute;
+    Recurrence recurrence_;
+    std::atomic<TimePoint> firing_time_{};  // nominal time of the current firing, anchors the fixed-rate grid
+    std::atomic<uint64_t> firings_{0};
+    std::atomic<bool> recurrence_stopped_{false};
+    std::unique_ptr<const DurableTask> durable_task_;
+    std::chrono::milliseconds timeout_{0};
+    std::shared_ptr<CancellationState> attempt_cancel_;  // the running attempt's, while it has a timeout
+    size_t preferred_node_ = CpuTopology::kAnyNode;
+    std::string tag_;
+    TimePoint deadline_ = TimePoint::max();
+    std::chrono::microseconds expected_run_{0};
+    bool resuming_ = false;  // set by the worker that suspended the job, cleared by the next run()
+    mutable std::atomic<uintptr_t> completion_waiters_{0};  // stack of CompletionWaiters; closed once finished
+    mutable bool completed_ok_ = false;                     // published by closing completion_waiters_
+    Suspension suspension_ = Suspension::None;              // set by the running task, read by its worker
+    std::atomic<uint8_t> park_arrivals_{0};                 // worker and wake(): the second one queues the job
+    JobExecutor* parked_by_ = nullptr;
+    std::shared_ptr<Job> parked_self_;                      // keeps a parked job alive until wake()
+    static thread_local Job* current_;
+    uint64_t journal_key_ = 0;       // 0 until journaled
+    uint64_t journal_commit_ = 0;    // commit that takes the job's first record; guarded by the Journal
+    size_t journal_index_ = 0;       // position of that record in the commit; guarded by the Journal
+    mutable uint32_t journal_segment_ = 0;  // segment of the job's latest full record; see Journal::encodeBatch
+    mutable uint32_t journal_slot_ = 0;     // that record's place in the segment's job list
 
     bool is_shutdown_signal_ = false;
 };
@@ -5,9 +5,15 @@
 
 #pragma once
 
+#include "CompletionTracker.hpp"
 #include "Job.hpp"
 #include "JobQueue.hpp"
+#include "Journal.hpp"
 #include "Observer.hpp"
+#include "ObserverRegistry.hpp"
+#include "SchedulerMetrics.hpp"
+#include <atomic>
+#include <cstdint>
 #include <memory>
 #include <vector>
 
@@ -19,7 +25,13 @@ namespace scheduleit {
  */
 class JobExecutor {
 public:
-    explicit JobExecutor(std::shared_ptr<JobQueue> job_queue);
+    /**
+     * @brief Constructor.
+     * @param job_queue Queue that receives retries, except those of a class given a lane.
+     * @param tracker Optional tracker told when a job finishes for good.
+     */
+    explicit JobExecutor(std::shared_ptr<JobQueue> job_queue,
+                         std::shared_ptr<CompletionTracker> tracker = nullptr);
 
     /**
      * @brief Executes the job and handles retry if necessary.
@@ -27,12 +39,71 @@ public:
      */
     void run(std::shared_ptr<Job> job);
 
+    /**
+     * @brief Settles the accounting for a job withdrawn from the queue instead of run.
+     * @param job A job that JobQueue::cancel() just cancelled, or a graph node cancelled
+     *            before it was ever queued.
+     */
+    void onCancelled(const std::shared_ptr<Job>& job);
+
+    /**
+     * @brief Queues a job that was parked by Job::suspendUntilWoken() to run now.
+     *
+     * Called by Job::wake(); safe from any thread.
+     */
+    void resumeParked(std::shared_ptr<Job> job);
+
     /**
      * @brief Registers an observer to receive job execution notifications.
+     *
+     * Safe while jobs run; workers pick up the change without taking a lock.
      * @param observer A shared pointer to the observer instance.
      */
     void registerObserver(std::shared_ptr<Observer> observer);
 
+    /**
+     * @brief Registers a sink that receives completion events in per-worker batches.
+     */
+    void registerBatchObserver(std::shared_ptr<BatchObserver> observer);
+
+    /**
+     * @brief Removes an observer; once this returns it is no longer called.
+     * @return False if it was not registered.
+     */
+    bool unregisterObserver(const std::shared_ptr<Observer>& observer);
+    bool unregisterBatchObserver(const std::shared_ptr<BatchObserver>& observer);
+
+    /**
+     * @brief Blocks until batch observers have received every event recorded so far.
+     */
+    void flushObservers();
+
+    /**
+     * @brief Journals retries, next firings and completions. Call before jobs run.
+     */
+    void setJournal(std::shared_ptr<Journal> journal);
+
+    /**
+     * @brief Records queue wait, dispatch lag, execution time and retries of every run into
+     *        the given histograms. Call before jobs run; without it no clock is read.
+     */
+    void setMetrics(std::shared_ptr<SchedulerMetrics> metrics);
+
+    /**
+     * @brief Gives jobs of one execution class their own queue and histograms, so that their
+     *        retries, next firings and resumptions go back to the pool serving that class.
+     *
+     * Classes without a lane use the constructor's queue and setMetrics()'s histograms.
+     * Call before jobs run.
+     */
+    void setLane(ExecutionClass execution_class, std::shared_ptr<JobQueue> queue,
+                 std::shared_ptr<SchedulerMetrics> metrics);
+
+    /**
+     * @brief Accounts for recovered jobs that were waiting for a retry, as if run() had queued them.
+     */
+    void adoptRecovered(const std::vector<std::shared_ptr<Job>>& jobs);
+
     /**
      * @brief Returns the number of active jobs currently being executed.
      */
@@ -40,10 +111,126 @@ public:
         return active_jobs_.load();
     }
 
+    /**
+     * @brief Returns the number of retries waiting in the queue for their backoff to expire.
+     */
+    int getPendingRetryCount() const {
+        return pending_retries_.load();
+    }
+
+    /**
+     * @brief Returns the total number of retries handed back to the queue.
+     */
+    uint64_t getRetriesScheduled() const {
+        return retries_scheduled_.load();
+    }
+
+    /**
+     * @brief Returns the total number of retries vetoed by a job's retry hook.
+     */
+    uint64_t getRetriesCancelled() const {
+        return retries_cancelled_.load();
+    }
+
+    /**
+     * @brief Returns the total number of recurring-job firings put back in the queue.
+     */
+    uint64_t getFiringsScheduled() const {
+        return firings_scheduled_.load();
+    }
+
+    /**
+     * @brief Returns the total number of queued jobs cancelled through onCancelled().
+     */
+    uint64_t getJobsCancelled() const {
+        return jobs_cancelled_.load();
+    }
+
+    /**
+     * @brief Returns the total number of attempts dropped because they could no longer start
+     *        in time (Job::setDeadline()).
+     */
+    uint64_t getJobsExpired() const {
+        return jobs_expired_.load();
+    }
+
+    /**
+     * @brief Returns the total number of attempts that overran their job's timeout.
+     */
+    uint64_t getTimeouts() const {
+        return timeouts_.load();
+    }
+
+    /**
+     * @brief Returns the total number of times a running job suspended itself, e.g. a
+     *        Workflow awaiting a sleep or another job.
+     */
+    uint64_t getSuspensions() const {
+        return suspensions_.load();
+    }
+
 private:
-    std::shared_ptr<JobQueue> job_queue_;
-    std::vector<std::shared_ptr<Observer>> observers_;
+    /**
+     * @brief Gives the attempt about to run a cancellation state and has the Watchdog time it.
+     */
+    void armTimeout(const std::shared_ptr<Job>& job);
+
+    /**
+     * @brief Disarms the attempt's timeout.
+     * @return True if the attempt overran.
+     */
+    bool endAttempt(Job& job);
+
+    /**
+     * @brief Requeues or parks a job whose task asked to be suspended.
+     */
+    void suspend(std::shared_ptr<Job>& job);
+
+    /**
+     * @brief Drops an attempt that would start too late for its job's deadline, as if it had run.
+     */
+    void expire(const std::shared_ptr<Job>& job);
+
+    /**
+     * @brief Notifies observers of a failure and retries the job if allowed.
+     * @return True if the job was handed back to the queue.
+     */
+    bool handleFailure(std::shared_ptr<Job>& job);
+
+    /**
+     * @brief Re-enqueues a failed job with its backoff deadline instead of sleeping on the worker.
+     * @return False if the job's retry hook cancelled the retry.
+     */
+    bool scheduleRetry(std::shared_ptr<Job>& job);
+
+    /**
+     * @brief Queues the same job object for its next firing, timed from its Recurrence.
+     * @return False if the series is over or was stopped.
+     */
+    bool scheduleNextFiring(const std::shared_ptr<Job>& job);
+
+    JobQueue& queueFor(const Job& job) const {
+        return *queues_[static_cast<size_t>(job.getExecutionClass())];
+    }
+
+    SchedulerMetrics* metricsFor(const Job& job) const {
+        return metrics_[static_cast<size_t>(job.getExecutionClass())].get();
+    }
+
+    std::shared_ptr<JobQueue> queues_[kExecutionClassCount];  // by ExecutionClass
+    std::shared_ptr<CompletionTracker> tracker_;
+    std::shared_ptr<Journal> journal_;
+    std::shared_ptr<SchedulerMetrics> metrics_[kExecutionClassCount];
+    ObserverRegistry observers_;
     std::atomic<int> active_jobs_{0};
+    std::atomic<int> pending_retries_{0};
+    std::atomic<uint64_t> retries_scheduled_{0};
+    std::atomic<uint64_t> retries_cancelled_{0};
+    std::atomic<uint64_t> jobs_cancelled_{0};
+    std::atomic<uint64_t> jobs_expired_{0};
+    std::atomic<uint64_t> firings_scheduled_{0};
+    std::atomic<uint64_t> suspensions_{0};
+    std::atomic<uint64_t> timeouts_{0};
 };
 
 }
\ No newline at end of file
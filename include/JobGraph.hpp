@@ -0,0 +1,84 @@
+/**
+ * @file JobGraph.hpp
+ * @brief Defines JobGraph, a set of jobs with predecessor edges submitted as one unit.
+ */
+
+#pragma once
+
+#include "Job.hpp"
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace scheduleit {
+
+/**
+ * @enum GraphFailurePolicy
+ * @brief Decides what a node's final failure means for the rest of its graph.
+ *
+ * A node has failed only once its RetryStrategy gives up (or its retry hook vetoes the next
+ * attempt); attempts that are retried do not affect the graph. A node that is cancelled
+ * counts as failed.
+ */
+enum class GraphFailurePolicy {
+    CancelDependents,  ///< Cancel every transitive successor; independent branches keep running.
+    RunDependents,     ///< Treat the failure like a success, so successors still run.
+    CancelGraph        ///< Cancel every node of the graph that has not started yet.
+};
+
+/**
+ * @class JobGraph
+ * @brief Builder for a directed acyclic graph of jobs.
+ *
+ * Submit it with JobScheduler::submitGraph(). Nodes without predecessors are queued at once;
+ * every other node keeps an atomic count of unfinished predecessors and is queued by the
+ * worker that finishes its last one, so independent branches overlap fully and no stage
+ * waits for an unrelated slow node. A node still honours its own delay, counted from when
+ * the job was created.
+ */
+class JobGraph {
+public:
+    using NodeId = uint32_t;
+
+    /**
+     * @brief Adds a job as a node.
+     * @return The node's id, used to add edges.
+     * @throws std::invalid_argument if job is null.
+     */
+    NodeId add(std::shared_ptr<Job> job);
+
+    /**
+     * @brief Makes child wait until parent has finished.
+     * @throws std::invalid_argument if either id is unknown or they are equal.
+     */
+    void addEdge(NodeId parent, NodeId child);
+
+    /**
+     * @brief Sets how a node's final failure propagates. Defaults to CancelDependents.
+     */
+    void setFailurePolicy(GraphFailurePolicy policy) {
+        policy_ = policy;
+    }
+
+    GraphFailurePolicy getFailurePolicy() const {
+        return policy_;
+    }
+
+    size_t size() const {
+        return jobs_.size();
+    }
+
+    const std::shared_ptr<Job>& getJob(NodeId node) const {
+        return jobs_.at(node);
+    }
+
+private:
+    friend class JobScheduler;
+
+    std::vector<std::shared_ptr<Job>> jobs_;
+    std::vector<std::pair<NodeId, NodeId>> edges_;
+    GraphFailurePolicy policy_ = GraphFailurePolicy::CancelDependents;
+};
+
+}
@@ -0,0 +1,74 @@
+/**
+ * @file JobHandle.hpp
+ * @brief Defines the handle returned by JobScheduler::submit for controlling a queued job.
+ */
+
+#pragma once
+
+#include "Job.hpp"
+#include <chrono>
+#include <memory>
+
+namespace scheduleit {
+
+class JobScheduler;
+
+/**
+ * @class JobHandle
+ * @brief Lets the submitter cancel or move a job while it is still queued.
+ *
+ * Both operations are O(1) and do not take the queue lock; they succeed only while the job
+ * is waiting in the queue, including while it waits for a retry. A handle is a cheap value
+ * and must not be used after its scheduler is destroyed.
+ */
+class JobHandle {
+public:
+    JobHandle() = default;
+
+    /**
+     * @brief Constructor.
+     * @param job The submitted job.
+     * @param scheduler The scheduler the job was submitted to.
+     */
+    JobHandle(std::shared_ptr<Job> job, JobScheduler* scheduler);
+
+    /**
+     * @brief Withdraws the job from the queue. It then counts as finished for waitForIdle().
+     *
+     * For a recurring job this ends the series, even while a firing is running.
+     * @return True if the job was queued and will not run; false if it is running, finished,
+     *         already cancelled, or the handle is empty.
+     */
+    bool cancel();
+
+    /**
+     * @brief Moves the queued job to a new scheduled time.
+     * @return True if the job was still queued.
+     */
+    bool reschedule(Job::TimePoint time);
+
+    /**
+     * @brief Moves the queued job to the given delay from now.
+     * @return True if the job was still queued.
+     */
+    bool reschedule(std::chrono::milliseconds delay);
+
+    /**
+     * @brief Returns the job's life-cycle state, or Created for an empty handle.
+     */
+    JobState getState() const;
+
+    const std::shared_ptr<Job>& getJob() const {
+        return job_;
+    }
+
+    explicit operator bool() const {
+        return job_ != nullptr;
+    }
+
+private:
+    std::shared_ptr<Job> job_;
+    JobScheduler* scheduler_ = nullptr;
+};
+
+}
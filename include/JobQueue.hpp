@@ -5,37 +5,154 @@
  */
 
 #include "Job.hpp"
+#include "JobStore.hpp"
+#include "PriorityJobStore.hpp"
+#include <array>
+#include <atomic>
+#include <chrono>
 #include <condition_variable>
+#include <limits>
 #include <memory>
 #include <mutex>
-#include <queue>
 #include <vector>
 
 namespace scheduleit {
 
+/**
+ * @enum QueueBackend
+ * @brief Selects the time-ordered container behind a JobQueue.
+ */
+enum class QueueBackend {
+    Heap,        ///< Binary heap: exact ordering, O(log n) per operation.
+    TimingWheel  ///< Hierarchical timing wheel: O(1) per operation, tick-rounded deadlines.
+};
+
+/**
+ * @enum ShardSelection
+ * @brief Chooses the shard a job is enqueued into when a JobQueue is sharded.
+ */
+enum class ShardSelection {
+    SubmittingThread,  ///< Each thread keeps to one shard, so concurrent producers rarely share a lock.
+    JobIdHash          ///< Hash of the job id; jobs without an id fall back to the submitting thread.
+};
+
+/**
+ * @struct QueueOptions
+ * @brief Configuration for a JobQueue.
+ */
+struct QueueOptions {
+    QueueBackend backend = QueueBackend::Heap;
+    std::chrono::microseconds wheel_tick = std::chrono::milliseconds(1);  ///< Timing wheel resolution.
+    size_t wheel_levels = 4;  ///< Timing wheel levels; jobs beyond 256^levels ticks overflow.
+    size_t shards = 1;  ///< Independent sub-queues, each with its own lock and backend.
+    ShardSelection shard_selection = ShardSelection::SubmittingThread;
+    /// A consumer takes a due job from its own shard rather than the globally earliest one
+    /// if the two deadlines are at most this far apart.
+    std::chrono::microseconds shard_skew{0};
+    /// How due jobs of different JobPriority classes, or with different Job deadlines, share
+    /// the consumers. Applied within each shard; across shards the earliest scheduled time
+    /// still wins.
+    PriorityPolicy priority_policy = PriorityPolicy::None;
+    std::array<unsigned, kJobPriorityCount> priority_weights{{8, 4, 2, 1}};  ///< WeightedFair shares.
+    std::chrono::milliseconds priority_aging{100};  ///< StrictWithAging starvation bound.
+};
+
 /**
  * @class JobQueue
  * @brief Thread-safe priority queue for scheduling jobs based on execution time.
+ *
+ * With more than one shard, producers and consumers lock only the shard they touch. Each
+ * shard publishes its earliest deadline in an atomic, so a consumer picks the shard holding
+ * the globally earliest due job without taking any other lock. Ordering across shards is
+ * exact only up to QueueOptions::shard_skew and concurrent updates, but a job is still never
+ * returned before its scheduled time.
+ *
+ * Cancelling or moving a queued job only updates the job itself, in O(1) and without the
+ * queue lock; its old entry is dropped when it surfaces. Once stale entries outnumber live
+ * ones, the queue compacts its stores in one O(n) pass, so mass cancellation stays linear.
  */
 class JobQueue {
 public:
+    /**
+     * @brief Constructs the queue with the given backend configuration.
+     * @param options Queue backend options.
+     */
+    explicit JobQueue(const QueueOptions& options = QueueOptions());
+
     /**
      * @brief Adds a job to the queue.
      * @param job The job to be enqueued.
      */
     void enqueue(std::shared_ptr<Job> job);
 
+    /**
+     * @brief Adds several jobs under a single lock acquisition.
+     *
+     * Wakes at most as many waiters as there are jobs already due, plus the deadline sleeper
+     * if the batch moves the next deadline earlier.
+     * @param jobs The jobs to enqueue; they are moved out and the vector is left empty.
+     */
+    void enqueueBatch(std::vector<std::shared_ptr<Job>>& jobs);
+
+    /**
+     * @brief Withdraws a queued job so that no consumer will receive it.
+     * @return True if the job was queued and is now cancelled; false if it was not queued,
+     *         e.g. because it is already running or finished.
+     */
+    bool cancel(Job& job);
+
+    /**
+     * @brief Moves a queued job to a new scheduled time.
+     * @return True if the job was still queued.
+     */
+    bool reschedule(const std::shared_ptr<Job>& job, Job::TimePoint time);
+
     /**
      * @brief Waits until the next job is ready or the queue is empty and retrieves it.
      * @return The job ready to be executed, or nullptr if empty.
      */
     std::shared_ptr<Job> dequeueReady();
 
+    /**
+     * @brief Blocks until a job is ready, waiting through empty periods.
+     *
+     * Intended for worker threads that consume the queue directly. Only one waiter sleeps
+     * until the next deadline; the others wait to be handed the role, so a deadline wakes
+     * one thread rather than all of them.
+     * @return The job ready to be executed, or nullptr once the queue is closed and empty.
+     */
+    std::shared_ptr<Job> waitDequeue();
+
+    /**
+     * @brief Like waitDequeue(), but also takes any other jobs that are due, under the same lock.
+     * @param out Receives the jobs; it is appended to.
+     * @param max_jobs Upper bound on the number of jobs taken.
+     * @return The number of jobs taken, or 0 once the queue is closed and empty.
+     */
+    size_t waitDequeueBatch(std::vector<std::shared_ptr<Job>>& out, size_t max_jobs);
+
+    /**
+     * @brief Releases waitDequeue() callers once the queue drains. Enqueueing stays allowed.
+     */
+    void close();
+
     /**
      * @brief Checks if the queue is empty.
      */
     bool empty() const;
 
+    /**
+     * @brief Returns the number of queued jobs, not counting stale entries of cancelled or moved jobs.
+     */
+    size_t size() const;
+
+    /**
+     * @brief Returns per-class depth and wait counters, summed over shards.
+     *
+     * All zero unless the queue was built with a PriorityPolicy.
+     */
+    PriorityStats getPriorityStats() const;
+
     /**
      * @brief Increments the internal pending job count (used for synchronization).
      */
@@ -57,17 +174,68 @@ public:
     bool isIdle() const;
 
 private:
-    struct CompareJob {
-        bool operator()(const std::shared_ptr<Job>& lhs, const std::shared_ptr<Job>& rhs) const {
-            return lhs->getScheduledTime() > rhs->getScheduledTime(); // min-heap
-        }
+    using Ticks = Job::TimePoint::rep;
+    static constexpr Ticks kNoDeadline = std::numeric_limits<Ticks>::max();
+
+    struct alignas(64) Shard {
+        std::mutex mutex;
+        std::unique_ptr<JobStore> store;
+        std::atomic<Ticks> earliest{kNoDeadline};  // store->nextWakeTime(), or kNoDeadline if empty
+        std::atomic<size_t> size{0};
+    };
+
+    // Which waiters an enqueue should wake; computed with mutex_ held.
+    struct Wakeup {
+        bool timed = false;
+        size_t idle = 0;
+        size_t idle_waiters = 0;
     };
 
+    // Stale entries tolerated before the stores are compacted.
+    static constexpr int64_t kMinCompaction = 1024;
+
+    std::unique_ptr<JobStore> makeStore(const QueueOptions& options);
+    void insert(std::shared_ptr<Job> job, Job::TimePoint now);
+    std::shared_ptr<Job> popClaimed(JobStore& store, Job::TimePoint now);
+    size_t liveCount(size_t entries) const;
+    size_t entryCount() const;
+    void compactIfStale();
+    std::shared_ptr<Job> popOrWait(std::unique_lock<std::mutex>& lock, bool wait_when_empty);
+    Wakeup planWakeup(Job::TimePoint earliest, size_t due) const;
+    void wake(const Wakeup& wakeup);
+
+    bool sharded() const {
+        return !shards_.empty();
+    }
+    size_t shardFor(const Job& job) const;
+    size_t homeShard() const;
+    void publish(Shard& shard);
+    Ticks scanEarliest() const;
+    void enqueueSharded(std::vector<std::shared_ptr<Job>>& jobs, Job::TimePoint now);
+    void notifySharded(Job::TimePoint earliest, size_t due);
+    std::shared_ptr<Job> tryPopSharded(Job::TimePoint now);
+    std::shared_ptr<Job> popOrWaitSharded(bool wait_when_empty);
+
     mutable std::mutex mutex_;
-    std::condition_variable cv_;
-    std::priority_queue<std::shared_ptr<Job>, std::vector<std::shared_ptr<Job>>, CompareJob> queue_;
+    std::condition_variable cv_;        // waiters without a deadline
+    std::condition_variable timed_cv_;  // the single waiter sleeping until the next deadline
+    std::unique_ptr<JobStore> store_;
+    std::vector<const PriorityJobStore*> priority_stores_;  // one per shard when priorities are on
+    bool has_timed_waiter_ = false;
+    Job::TimePoint timed_deadline_;
+    int idle_waiters_ = 0;
+    bool closed_ = false;
     std::atomic<int> pending_jobs_{0};
+    std::atomic<int64_t> stale_entries_{0};  // entries of cancelled, moved or duplicated jobs
+    std::atomic<int64_t> compact_at_{kMinCompaction};
+    std::atomic<bool> compacting_{false};
+
+    // Sharded mode only. mutex_ then guards just the waiting state above.
+    std::vector<std::unique_ptr<Shard>> shards_;
+    ShardSelection shard_selection_ = ShardSelection::SubmittingThread;
+    Ticks shard_skew_ = 0;
+    std::atomic<int> sharded_waiters_{0};  // threads inside the wait path, announced before re-checking
     std::atomic<int> pending_count_ = 0;
 };
 
-}
\ No newline at end of file
+}
@@ -5,17 +5,97 @@
 
 #pragma once
 
+#include "AdmissionController.hpp"
+#include "CompletionTracker.hpp"
 #include "Job.hpp"
+#include "JobGraph.hpp"
+#include "JobHandle.hpp"
 #include "JobQueue.hpp"
 #include "JobExecutor.hpp"
+#include "Journal.hpp"
+#include "SchedulerMetrics.hpp"
 #include "ThreadPool.hpp"
 #include <memory>
 #include <atomic>
+#include <mutex>
 #include <thread>
+#include <unordered_map>
 #include <vector>
 
 namespace scheduleit {
 
+/**
+ * @enum DispatchMode
+ * @brief Selects how ready jobs travel from the JobQueue to a worker.
+ */
+enum class DispatchMode {
+    Dispatcher,  ///< A dispatcher thread pops ready jobs and submits them to a ThreadPool.
+    Direct       ///< Worker threads pop ready jobs from the JobQueue themselves.
+};
+
+/**
+ * @struct ExecutionPoolOptions
+ * @brief A separately sized pool for one ExecutionClass.
+ */
+struct ExecutionPoolOptions {
+    size_t workers = 0;          ///< 0 runs the class on the compute pool.
+    size_t max_queue_size = 0;   ///< Tasks the pool may hold beyond those running (0 for unbounded).
+    ElasticOptions elastic;      ///< Let the pool grow and shrink around workers.
+};
+
+/**
+ * @struct SchedulerOptions
+ * @brief Optional configuration for a JobScheduler.
+ */
+struct SchedulerOptions {
+    QueueOptions queue;                             ///< Backend used by the scheduler's job queue.
+    DispatchMode dispatch = DispatchMode::Dispatcher;  ///< Path from the queue to the workers.
+    /// Optional write-ahead journal. The scheduler recovers and queues its jobs on construction,
+    /// then journals every durable job it is given.
+    std::shared_ptr<Journal> journal;
+    /// Keep per-worker histograms of queue wait, dispatch lag, execution time and retries.
+    /// Costs two clock reads and a few relaxed stores per run.
+    bool collect_metrics = true;
+    /// NUMA layout for the dispatcher's pool: one ready queue per node, and jobs with a
+    /// preferred node (Job::setPreferredNode()) placed on it. Direct mode, which has no ready
+    /// queues of its own, only uses it to pin workers.
+    std::shared_ptr<const CpuTopology> topology;
+    /// Pin each worker to one CPU of the topology, or of CpuTopology::detect() without one.
+    bool pin_workers = false;
+    /// Let the dispatcher's pool grow and shrink around num_workers (see ElasticOptions).
+    /// Not combinable with a topology; ignored in Direct mode.
+    ElasticOptions elastic;
+    /// Bound on the compute pool's queue; the backlog beyond it waits, in order, in the
+    /// JobQueue. 0 for unbounded, or num_workers with a priority policy.
+    size_t max_pool_queue_size = 0;
+    /// Pool for ExecutionClass::Blocking jobs. With workers, those jobs get their own
+    /// JobQueue, dispatcher and pool, so they cannot occupy the compute workers.
+    ExecutionPoolOptions blocking;
+    /// Bound on outstanding jobs, what submit() does beyond it, and per-tag rate limits.
+    AdmissionOptions admission;
+};
+
+/**
+ * @struct SubmitResult
+ * @brief What JobScheduler::trySubmit() returns: a status, and a handle if it was accepted.
+ */
+struct SubmitResult {
+    SubmitStatus status = SubmitStatus::Invalid;
+    JobHandle handle;
+
+    explicit operator bool() const {
+        return status == SubmitStatus::Accepted;
+    }
+};
+
+/**
+ * @struct SleepAwaitable
+ * @brief What JobScheduler::sleep() returns; a Workflow (Workflow.hpp) can co_await it.
+ */
+struct SleepAwaitable {
+    std::chrono::nanoseconds duration;
+};
+
 /**
  * @class JobScheduler
  * @brief Manages job submission, scheduling, and dispatching to the thread pool.
@@ -25,8 +105,10 @@ public:
     /**
      * @brief Constructs the scheduler with specified thread pool size.
      * @param num_workers Number of worker threads.
+     * @param options Queue backend and other optional settings.
+     * @throws std::runtime_error if the journal cannot be recovered.
      */
-    explicit JobScheduler(size_t num_workers);
+    explicit JobScheduler(size_t num_workers, const SchedulerOptions& options = SchedulerOptions());
 
     /**
      * @brief Destructor. Shuts down the scheduler.
@@ -34,37 +116,195 @@ public:
     ~JobScheduler();
 
     /**
-     * @brief Starts the internal dispatcher thread.
+     * @brief Starts the internal dispatcher thread, or the direct-dispatch workers.
      */
     void start();
 
     /**
      * @brief Submits a job to be scheduled.
+     *
+     * With admission control (SchedulerOptions::admission), a job that does not fit is
+     * handled by the OverloadPolicy: Block waits here, so a job submitting others from a
+     * worker should use trySubmit() instead, or it may wait for itself.
      * @param job The job to submit.
+     * @return A handle for cancelling or moving the job; empty if job was null or turned away.
+     */
+    JobHandle submit(std::shared_ptr<Job> job);
+
+    /**
+     * @brief Like submit(), but never waits: says why a job that does not fit was turned away.
+     */
+    SubmitResult trySubmit(std::shared_ptr<Job> job);
+
+    /**
+     * @brief Submits many jobs with one queue lock acquisition and an O(n) heap merge.
+     *
+     * Under admission control the jobs are admitted in order, as submit() would; with Block,
+     * a batch larger than max_pending is queued in parts as room frees up.
+     * @param jobs The jobs to submit; null entries are skipped with a warning.
+     * @return The number of jobs accepted.
+     */
+    size_t submitBatch(std::vector<std::shared_ptr<Job>> jobs);
+
+    /**
+     * @brief Submits a dependency graph of jobs; see JobGraph.
+     *
+     * Every node counts as outstanding from now on, so waitForIdle() covers the whole graph.
+     * Nodes that are cancelled because of a failure are reported through onJobCancelled().
+     * A node waiting for its predecessors is not queued, so cancel() cannot reach it yet.
+     * The graph's jobs must not be submitted again on their own.
+     * @throws std::invalid_argument if the graph has a cycle.
+     */
+    void submitGraph(JobGraph graph);
+
+    /**
+     * @brief For `co_await scheduler.sleep(d)` in a Workflow, which needs a C++20 build.
+     *
+     * The workflow's job goes back into the time-ordered queue for the duration and its
+     * worker moves on to other jobs.
+     */
+    SleepAwaitable sleep(std::chrono::nanoseconds duration) const {
+        return SleepAwaitable{duration};
+    }
+
+    /**
+     * @brief Withdraws a queued job; see JobHandle::cancel().
+     *
+     * For a recurring job this ends the series: a queued firing is withdrawn, and a firing
+     * that is running finishes without a successor.
+     * @return True if the job was queued and will not run, or its series was ended.
      */
-    void submit(std::shared_ptr<Job> job);
+    bool cancel(const std::shared_ptr<Job>& job);
 
     /**
-     * @brief Gracefully shuts down the scheduler.
+     * @brief Moves a queued job to a new scheduled time; see JobHandle::reschedule().
+     * @return True if the job was still queued.
+     */
+    bool reschedule(const std::shared_ptr<Job>& job, Job::TimePoint time);
+
+    /**
+     * @brief Gracefully shuts down the scheduler, first letting outstanding jobs finish.
+     *
+     * Recurring jobs are cancelled first, since their series would never finish.
      */
     void shutdown();
 
+    /**
+     * @brief Returns per-priority-class queue depth and wait counters of the compute queue.
+     */
+    PriorityStats getPriorityStats() const;
+
+    /**
+     * @brief Returns per-priority-class counters of the queue serving an execution class.
+     */
+    PriorityStats getPriorityStats(ExecutionClass execution_class) const;
+
+    /**
+     * @brief Returns all workers' latency histograms merged; empty if metrics are off.
+     *
+     * Safe to call while jobs run. Use HistogramSnapshot::percentile() to read tail latency.
+     */
+    MetricsSnapshot getMetrics() const;
+
+    /**
+     * @brief Returns the histograms of the jobs of one execution class. Without a separate
+     *        blocking pool, both classes share one set.
+     */
+    MetricsSnapshot getMetrics(ExecutionClass execution_class) const;
+
+    /**
+     * @brief Returns one set of histograms per thread that ran jobs, e.g. to spot a slow
+     *        worker: compute pool first, then blocking pool.
+     */
+    std::vector<MetricsSnapshot> getWorkerMetrics() const;
+
     /**
      * @brief Returns the internal job executor instance.
      */
     JobExecutor* getExecutor() const;
 
     /**
-     * @brief Blocks until the job queue is empty and all tasks are processed.
+     * @brief Returns a pool's elastic sizing state; all zero unless it is elastic.
+     */
+    ElasticStats getElasticStats(ExecutionClass execution_class = ExecutionClass::Compute) const;
+
+    /**
+     * @brief Blocks until every submitted job, including pending retries, has finished.
      */
     void waitForIdle();
 
+    /**
+     * @brief Like waitForIdle(), but gives up after the timeout.
+     * @param timeout Maximum time to wait.
+     * @return True if the scheduler became idle.
+     */
+    bool waitForIdle(std::chrono::milliseconds timeout);
+
+    /**
+     * @brief Blocks until the jobs with the given ids have finished.
+     *
+     * Only jobs with a non-empty id can be awaited this way, and only they pay for it: each is
+     * counted in a hash map from submission to completion. Leave ids empty on jobs that are
+     * never awaited by id.
+     * @param ids Job ids to wait for; ids that are not outstanding count as finished.
+     * @param timeout Maximum time to wait.
+     * @return True if all of them finished in time.
+     */
+    bool waitForJobs(const std::vector<std::string>& ids,
+                     std::chrono::milliseconds timeout = std::chrono::milliseconds::max());
+
+    /**
+     * @brief Returns the number of submitted jobs that are queued, running, or awaiting a retry.
+     */
+    size_t getOutstandingCount() const;
+
+    /**
+     * @brief Returns how close the scheduler is to max_pending and what admission turned
+     *        away; cheap enough to poll before every submit.
+     */
+    QueuePressure getQueuePressure() const;
+
 private:
+    class GraphRun;
+
+    void dispatchLoop(JobQueue& queue, ThreadPool& pool, size_t batch_size);
+    void directWorkerLoop(JobQueue& queue);
+    /// The queue serving the job's execution class.
+    JobQueue& queueFor(const Job& job) const;
+    /// Counts, journals and queues an admitted job; reserved if admission counted it.
+    JobHandle accept(std::shared_ptr<Job> job, bool reserved);
+    void acceptBatch(std::vector<std::shared_ptr<Job>>& jobs, bool reserved);
+    /// Queues jobs with one batch per execution class.
+    void enqueueJobs(std::vector<std::shared_ptr<Job>>& jobs);
+    void trackRecurring(const std::shared_ptr<Job>& job);
+    void stopRecurringJobs();
+    void releaseGraph(const GraphRun* run);
+
+    DispatchMode dispatch_mode_;
+    size_t num_workers_;
     std::shared_ptr<JobQueue> job_queue_;
-    std::unique_ptr<ThreadPool> thread_pool_;
+    std::shared_ptr<CompletionTracker> tracker_;
+    std::unique_ptr<ThreadPool> thread_pool_;  // Dispatcher mode only
+    std::shared_ptr<const CpuTopology> pin_topology_;  // Direct mode with pinned workers only
+    size_t dispatch_batch_ = 256;              // jobs moved from the queue to the pool per lock
     std::unique_ptr<JobExecutor> executor_;
+    std::unique_ptr<AdmissionController> admission_;  // null without max_pending or rate limits
+    std::shared_ptr<Journal> journal_;
+    std::shared_ptr<SchedulerMetrics> metrics_;  // null if collect_metrics is off
     std::thread dispatcher_thread_;
+    std::vector<std::thread> direct_workers_;  // Direct mode only
+    // Separate lane for ExecutionClass::Blocking; all null without blocking workers.
+    std::shared_ptr<JobQueue> blocking_queue_;
+    std::unique_ptr<ThreadPool> blocking_pool_;
+    std::shared_ptr<SchedulerMetrics> blocking_metrics_;
+    size_t blocking_workers_ = 0;
+    size_t blocking_batch_ = 256;
+    std::thread blocking_dispatcher_;
     std::atomic<bool> running_;
+    std::mutex recurring_mutex_;
+    std::vector<std::weak_ptr<Job>> recurring_jobs_;  // for shutdown(); pruned as it grows
+    std::mutex graphs_mutex_;
+    std::unordered_map<const GraphRun*, std::shared_ptr<GraphRun>> graphs_;  // until every node finished
 };
 
 }
\ No newline at end of file
@@ -0,0 +1,90 @@
+/**
+ * @file JobStore.hpp
+ * @brief Declares the storage interface behind JobQueue's time ordering.
+ */
+
+#pragma once
+
+#include "Job.hpp"
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+namespace scheduleit {
+
+/**
+ * @class JobStore
+ * @brief Strategy interface for the time-ordered container used by JobQueue.
+ *
+ * Implementations are not thread-safe; JobQueue serializes all access.
+ *
+ * Cancelling or moving a queued job does not touch the store: the job's old entry simply
+ * becomes stale. popReady() may return such entries and JobQueue discards them; removeStale()
+ * lets JobQueue compact them away once they make up a large part of the store.
+ */
+class JobStore {
+public:
+    virtual ~JobStore() = default;
+
+    /**
+     * @brief Inserts a job keyed by its scheduled time.
+     * @param job The job to store.
+     */
+    virtual void push(std::shared_ptr<Job> job) = 0;
+
+    /**
+     * @brief Inserts several jobs at once. The default pushes them one by one.
+     * @param jobs The jobs to store; they are moved out.
+     */
+    virtual void pushBatch(std::vector<std::shared_ptr<Job>>& jobs) {
+        for (auto& job : jobs) {
+            push(std::move(job));
+        }
+    }
+
+    /**
+     * @brief Removes and returns a job whose scheduled time is at or before now.
+     * @param now The current time.
+     * @return A due job, or nullptr if none is due yet.
+     */
+    virtual std::shared_ptr<Job> popReady(Job::TimePoint now) = 0;
+
+    /**
+     * @brief Returns the earliest time at which popReady() may yield a job.
+     *
+     * Only meaningful when the store is not empty.
+     */
+    virtual Job::TimePoint nextWakeTime() const = 0;
+
+    /**
+     * @brief Removes entries whose job is no longer queued, and moved entries where detectable.
+     *
+     * The default keeps stale entries until popReady() surfaces them.
+     * @param removed Receives the removed jobs, so they can be released outside the queue lock.
+     */
+    virtual void removeStale(std::vector<std::shared_ptr<Job>>& removed) {
+        (void)removed;
+    }
+
+    /**
+     * @brief Returns the number of stored entries, stale ones included.
+     */
+    virtual size_t size() const = 0;
+
+    bool empty() const {
+        return size() == 0;
+    }
+
+protected:
+    /**
+     * @brief True if the job was cancelled or already taken, so an entry for it is dead.
+     *
+     * Jobs pushed without going through a JobQueue stay in the Created state and are live.
+     */
+    static bool isStale(const Job& job) {
+        JobState state = job.getState();
+        return state != JobState::Queued && state != JobState::Created;
+    }
+};
+
+}
@@ -0,0 +1,210 @@
+/**
+ * @file Journal.hpp
+ * @brief Declares Journal, an opt-in write-ahead log that lets queued jobs survive a restart.
+ */
+
+#pragma once
+
+#include "Job.hpp"
+#include "TaskRegistry.hpp"
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace scheduleit {
+
+/**
+ * @struct JournalOptions
+ * @brief Where and how a Journal writes.
+ */
+struct JournalOptions {
+    std::string directory;                    ///< Created if missing; holds segment-NNNNNNNN.log files.
+    size_t segment_bytes = 64u << 20;         ///< A new segment is started once the current one is this big.
+    /// Group-commit latency budget: a record waits at most this long before the write and
+    /// fdatasync that make it durable, so one sync covers every record appended meanwhile.
+    std::chrono::microseconds commit_interval{2000};
+    size_t commit_bytes = 4u << 20;           ///< Commit early once this much is buffered.
+    bool fsync = true;                        ///< False leaves flushing to the OS; survives crashes of the process only.
+    /// The oldest segment is compacted once fewer than this fraction of its records are live
+    /// jobs' latest: those are written again at the tail and the segment is deleted. 0 disables.
+    double compact_ratio = 0.25;
+};
+
+/**
+ * @struct JournalStats
+ * @brief Counters of a Journal.
+ */
+struct JournalStats {
+    uint64_t records = 0;          ///< Records written since the journal was opened.
+    uint64_t bytes = 0;            ///< Bytes written since the journal was opened.
+    uint64_t commits = 0;          ///< Group commits, i.e. write + fdatasync rounds.
+    uint64_t segments_deleted = 0;
+    uint64_t compacted = 0;        ///< Records written again to empty the oldest segment; part of records.
+    size_t segments_live = 0;      ///< Segment files on disk, including the one being written.
+};
+
+/**
+ * @struct RecoveryStats
+ * @brief What Journal::recover() found.
+ */
+struct RecoveryStats {
+    size_t segments = 0;
+    uint64_t records = 0;         ///< Valid records read.
+    size_t recovered = 0;         ///< Jobs rebuilt.
+    size_t unknown_task = 0;      ///< Live jobs dropped because their task name is not registered.
+    uint64_t torn_bytes = 0;      ///< Bytes cut from the tail of the last segment after a torn write.
+    std::chrono::nanoseconds read_time{0};     ///< Mapping and scanning the segments.
+    std::chrono::nanoseconds rebuild_time{0};  ///< Creating the jobs.
+};
+
+/**
+ * @class Journal
+ * @brief Write-ahead log of job submissions, retries and completions.
+ *
+ * Only jobs with a DurableTask (see TaskRegistry) are journaled. A job's first record is
+ * written on submission and a new full record replaces it whenever the job is queued again
+ * with different state: a retry, the next firing of a recurring job, or a reschedule. A
+ * completion or cancellation writes a short "done" record. Recovery therefore needs only the
+ * latest full record of every job without a done record, and a job that was running at the
+ * time of a crash runs again: delivery is at least once.
+ *
+ * Recording a job only queues a reference to it under one mutex. A background thread
+ * encodes, checksums and writes the queued records in group commits, so a full record holds
+ * the job's state at commit time, and a job that finishes within the commit that would have
+ * written its first record leaves nothing on disk. Records go to numbered segment files; a
+ * segment is deleted once it and every older segment hold no live job's latest record. So that
+ * a long-pending job does not keep every later segment on disk, the oldest segment is compacted
+ * when few of its records are still live (see JournalOptions::compact_ratio). Each record
+ * carries a CRC, so a torn tail is detected and cut off. Jobs submitted as part of a JobGraph are not
+ * journaled, because their edges are not.
+ *
+ * A failed write, segment creation or sync fails the journal for good: nothing recorded
+ * from that commit on becomes durable, later records are dropped, and sync() throws.
+ */
+class Journal {
+public:
+    /**
+     * @brief Opens or creates the journal directory and starts the writer thread.
+     * @param options Location and commit policy.
+     * @param registry Factories used to rebuild recovered jobs.
+     * @throws std::runtime_error if the directory cannot be created or opened.
+     */
+    Journal(JournalOptions options, std::shared_ptr<const TaskRegistry> registry);
+
+    /**
+     * @brief Commits outstanding records and stops the writer thread.
+     */
+    ~Journal();
+
+    Journal(const Journal&) = delete;
+    Journal& operator=(const Journal&) = delete;
+
+    /**
+     * @brief Rebuilds the jobs that were queued, running or awaiting a retry at the last stop.
+     *
+     * Maps every segment read-only, keeps the latest full record of each job that has no done
+     * record, and creates the jobs in key order with their scheduled time, attempt, priority
+     * and recurrence restored. Must be called once, before anything is recorded; a
+     * JobScheduler with a journal does this in its constructor and queues the result in bulk.
+     * @throws std::runtime_error if called after records were appended.
+     */
+    std::vector<std::shared_ptr<Job>> recover();
+
+    /**
+     * @brief Returns what the last recover() call found.
+     */
+    const RecoveryStats& getRecoveryStats() const {
+        return recovery_;
+    }
+
+    /// Journals a newly submitted durable job; other jobs are ignored.
+    void recordSubmit(const std::shared_ptr<Job>& job);
+    /// Journals a batch of newly submitted jobs with one lock acquisition.
+    void recordSubmitBatch(const std::vector<std::shared_ptr<Job>>& jobs);
+    /// Replaces a journaled job's record after a retry, reschedule or next firing.
+    void recordUpdate(const std::shared_ptr<Job>& job);
+    /// Marks a journaled job as finished or cancelled.
+    void recordDone(const std::shared_ptr<Job>& job);
+
+    /**
+     * @brief Blocks until everything recorded so far is durable.
+     * @throws std::runtime_error if the journal failed before that; see the class comment.
+     */
+    void sync();
+
+    JournalStats getStats() const;
+
+private:
+    struct Segment {
+        uint32_t number;
+        size_t live;          // jobs whose latest full record is in this segment
+        size_t records = 0;   // records of any kind in it
+        std::vector<std::shared_ptr<const Job>> jobs;  // by journal_slot_; reset when the record is superseded
+    };
+
+    /// A record the writer thread has yet to encode; job is reset if the record was withdrawn.
+    struct Pending {
+        std::shared_ptr<const Job> job;
+        bool done;
+    };
+
+    void appendLocked(const std::shared_ptr<Job>& job, bool done);
+    void releaseSegments(std::vector<uint32_t>& released);
+    void writerLoop();
+    /// Encodes a batch into out and moves the records' jobs between segments; returns how
+    /// many records it encoded.
+    uint64_t encodeBatch(const std::vector<Pending>& batch, std::string& out,
+                         std::vector<std::pair<size_t, uint32_t>>& splits, std::vector<uint32_t>& released);
+    void encodeRecord(const std::shared_ptr<const Job>& job, bool done, std::string& out,
+                      std::vector<std::pair<size_t, uint32_t>>& splits);
+    /// Rewrites the live records of sparse oldest segments at the tail; returns how many.
+    uint64_t compact(std::string& out, std::vector<std::pair<size_t, uint32_t>>& splits,
+                     std::vector<uint32_t>& released);
+    /// Writes and syncs; these return false after recording the reason in write_error_.
+    bool writeBuffer(const std::string& data, const std::vector<std::pair<size_t, uint32_t>>& splits);
+    bool writeAll(const char* data, size_t size);
+    bool openSegment(uint32_t number);
+    bool fail(const std::string& what);
+    std::string segmentPath(uint32_t number) const;
+    static size_t fullRecordSize(const Job& job);
+    static void encodeFull(const Job& job, std::string& out);
+    static void encodeDone(const Job& job, std::string& out);
+
+    JournalOptions options_;
+    std::shared_ptr<const TaskRegistry> registry_;
+    RecoveryStats recovery_;
+    bool recovered_ = false;
+
+    mutable std::mutex mutex_;
+    std::condition_variable writer_cv_;
+    std::condition_variable durable_cv_;
+    std::vector<Pending> pending_;                         // appended, not yet encoded
+    size_t pending_bytes_ = 0;                             // encoded size of pending_, an upper bound
+    std::chrono::steady_clock::time_point first_pending_;  // append time of pending_'s oldest record
+    uint64_t appended_ = 0;                                // records appended, a log sequence number
+    uint64_t durable_ = 0;                                 // records written and synced
+    bool sync_requested_ = false;
+    bool stopping_ = false;
+    uint64_t commit_ = 1;                                  // number of the commit pending_ belongs to
+    uint64_t next_key_ = 1;                                // journal keys are never reused
+    std::vector<uint32_t> deletable_;                      // segments recover() released, for the writer to unlink
+    std::string failure_;                                  // set once a commit failed; never cleared
+    JournalStats stats_;
+
+    // Writer thread only, once recover() has returned.
+    size_t active_bytes_ = 0;                              // size of the newest segment, counted at encode
+    std::deque<Segment> segments_;                         // on disk, oldest first, consecutive numbers
+    int fd_ = -1;
+    uint32_t fd_segment_ = 0;                              // segment the next written byte belongs to
+    std::string write_error_;                              // why the last commit failed
+    int dir_fd_ = -1;
+    std::thread writer_;
+};
+
+}
@@ -0,0 +1,94 @@
+/**
+ * @file LatencyHistogram.hpp
+ * @brief Declares LatencyHistogram, a single-writer log-linear histogram, and its snapshots.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace scheduleit {
+
+/**
+ * @struct HistogramSnapshot
+ * @brief A copy of one or more LatencyHistograms that can be merged and queried.
+ */
+struct HistogramSnapshot {
+    std::vector<uint64_t> counts;  ///< One entry per bucket; empty until something is merged in.
+    uint64_t count = 0;            ///< Values recorded.
+    uint64_t sum = 0;              ///< Sum of the values; read separately from the buckets, so it may lag them slightly.
+    uint64_t max = 0;
+
+    /**
+     * @brief Adds another snapshot's values to this one.
+     */
+    void merge(const HistogramSnapshot& other);
+
+    /**
+     * @brief Returns a value at or above the given fraction of the recorded values.
+     *
+     * The answer is the upper edge of the bucket holding that rank, capped at max, so it
+     * overstates the true value by at most one bucket width (1/16 of the value).
+     * @param percentile Between 0 and 100.
+     */
+    uint64_t percentile(double percentile) const;
+
+    double mean() const;
+};
+
+/**
+ * @class LatencyHistogram
+ * @brief Log-linear histogram of non-negative integers, written by one thread and read by any.
+ *
+ * Values below 32 have a bucket each; above that every power of two is split into 16
+ * buckets, like an HDR histogram with a precision of 1/16, so any uint64_t fits in 976
+ * buckets. The owning thread records with relaxed loads and stores and no read-modify-write,
+ * which costs a few nanoseconds; other threads may snapshot at any time and see every
+ * counter at some recent value.
+ */
+class LatencyHistogram {
+public:
+    static constexpr unsigned kExactBits = 5;
+    static constexpr unsigned kSubBuckets = 1u << (kExactBits - 1);
+    static constexpr size_t kBucketCount = (1u << kExactBits) + (64 - kExactBits) * kSubBuckets;
+
+    /**
+     * @brief Records one value. Only the owning thread may call this.
+     */
+    void record(uint64_t value) noexcept {
+        auto& bucket = counts_[bucketFor(value)];
+        bucket.store(bucket.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        sum_.store(sum_.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+        if (value > max_.load(std::memory_order_relaxed)) {
+            max_.store(value, std::memory_order_relaxed);
+        }
+    }
+
+    /**
+     * @brief Adds the current contents to a snapshot; safe while the owner records.
+     */
+    void snapshotInto(HistogramSnapshot& snapshot) const;
+
+    static size_t bucketFor(uint64_t value) noexcept {
+        if (value < (uint64_t{1} << kExactBits)) {
+            return static_cast<size_t>(value);
+        }
+        unsigned exponent = 63u - static_cast<unsigned>(__builtin_clzll(value));
+        unsigned shift = exponent - (kExactBits - 1);
+        auto sub_bucket = static_cast<size_t>(value >> shift) - kSubBuckets;
+        return (1u << kExactBits) + (exponent - kExactBits) * kSubBuckets + sub_bucket;
+    }
+
+    /// Returns the largest value that falls into the bucket.
+    static uint64_t bucketUpperBound(size_t bucket) noexcept;
+
+private:
+    std::atomic<uint64_t> counts_[kBucketCount] = {};
+    std::atomic<uint64_t> sum_{0};
+    std::atomic<uint64_t> max_{0};
+};
+
+}
@@ -7,18 +7,119 @@
 
 #include "Observer.hpp"
 #include "Job.hpp"
-#include <memory>
+#include "PerThread.hpp"
+#include <atomic>
+#include <cstdint>
+#include <iostream>
+#include <ostream>
+#include <string>
+#include <vector>
 
 namespace scheduleit {
 
+/**
+ * @enum NotifierDropPolicy
+ * @brief What a worker does when its notification ring is full.
+ */
+enum class NotifierDropPolicy {
+    DropNewest,  ///< Discard the new event and count it; the worker never waits.
+    Block        ///< Yield until the writer thread makes room; nothing is lost.
+};
+
+/**
+ * @struct NotifierOptions
+ * @brief Buffering and output settings of a Notifier.
+ */
+struct NotifierOptions {
+    size_t ring_capacity = 1024;  ///< Events buffered per worker thread; rounded up to a power of two.
+    NotifierDropPolicy drop_policy = NotifierDropPolicy::DropNewest;
+    std::chrono::milliseconds flush_interval{5};  ///< Longest an event waits before it is written.
+    std::ostream* out = &std::cout;  ///< Receives successes; must outlive the Notifier.
+    std::ostream* err = &std::cerr;  ///< Receives failures; must outlive the Notifier.
+};
+
 /**
  * @class Notifier
  * @brief Concrete observer that outputs job events to the console.
+ *
+ * Workers do not format or write anything. Each event becomes a fixed-size binary record
+ * (kind, attempt, timestamp and up to 48 bytes of the job id) pushed into a single-producer
+ * ring owned by the calling thread, so reporting a job takes no lock and no allocation. A
+ * background thread drains every ring, formats the records and writes each stream once per
+ * batch. Memory is bounded by ring_capacity records per thread; what happens beyond that is
+ * chosen by the drop policy, and dropped events are counted.
  */
 class Notifier : public Observer {
 public:
+    explicit Notifier(NotifierOptions options = NotifierOptions());
+
+    /**
+     * @brief Writes every buffered event and stops the writer thread.
+     */
+    ~Notifier() override;
+
+    Notifier(const Notifier&) = delete;
+    Notifier& operator=(const Notifier&) = delete;
+
     void onJobFailed(const Job& job, int attempt) override;
     void onJobSuccess(const Job& job) override;
+    void onJobTimedOut(const Job& job, int attempt) override;
+
+    /**
+     * @brief Blocks until every event reported before the call has been written.
+     */
+    void flush();
+
+    /**
+     * @brief Returns the number of events discarded because a ring was full.
+     */
+    uint64_t getDroppedCount() const;
+
+    /**
+     * @brief Returns the number of events written so far.
+     */
+    uint64_t getWrittenCount() const {
+        return written_.load(std::memory_order_relaxed);
+    }
+
+private:
+    enum class EventKind : uint8_t { Success, Failure, TimedOut };
+
+    struct Record {
+        static constexpr size_t kIdBytes = 48;
+        int64_t time_ns;
+        int32_t attempt;
+        EventKind kind;
+        uint8_t id_size;
+        bool id_truncated;
+        char id[kIdBytes];
+    };
+
+    /// The ring of one worker thread.
+    struct Ring {
+        explicit Ring(size_t capacity) : records(capacity) {}
+        SpscRing<Record> records;
+        std::atomic<uint64_t> dropped{0};  // written by the owner
+    };
+
+    void push(EventKind kind, const Job& job, int attempt);
+    /// Formats and writes everything in the rings; returns false if they were empty.
+    bool drain();
+    /// Appends one record's line to the out or err buffer.
+    void format(const Record& record);
+
+    NotifierOptions options_;
+    PerThreadSlots<Ring> rings_;
+    std::atomic<uint64_t> written_{0};
+
+    // Writer thread only.
+    std::vector<Ring*> drain_rings_;
+    std::string out_buffer_;
+    std::string err_buffer_;
+    int64_t cached_second_ = -1;
+    std::string cached_timestamp_;
+
+    DrainThread writer_;  // last, so it stops before the members it drains go away
 };
 
-}
\ No newline at end of file
+}
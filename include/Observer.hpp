@@ -6,6 +6,8 @@
 #pragma once
 
 #include "Job.hpp"
+#include <cstddef>
+#include <memory>
 
 namespace scheduleit {
 
@@ -29,6 +31,80 @@ public:
      * @param job The job that succeeded.
      */
     virtual void onJobSuccess(const Job& job) = 0;
+
+    /**
+     * @brief Called when a queued job is cancelled before it runs. Does nothing by default.
+     * @param job The cancelled job.
+     */
+    virtual void onJobCancelled(const Job& job) {
+        (void)job;
+    }
+
+    /**
+     * @brief Called when an attempt overruns its timeout (Job::setTimeout()), at the moment the
+     *        Watchdog notices, while the task may still be running. Does nothing by default.
+     *
+     * Runs on the watchdog thread. onJobFailed() follows once the task returns.
+     * @param job The job that overran.
+     * @param attempt The attempt that overran.
+     */
+    virtual void onJobTimedOut(const Job& job, int attempt) {
+        (void)job;
+        (void)attempt;
+    }
+
+    /**
+     * @brief Called when an attempt is dropped because it could no longer start in time: its
+     *        job's deadline (Job::setDeadline()) has passed, or is nearer than the job's
+     *        expected run time. Does nothing by default.
+     * @param job The job that expired.
+     */
+    virtual void onJobExpired(const Job& job) {
+        (void)job;
+    }
+};
+
+/**
+ * @enum JobEventKind
+ * @brief What happened to a job, as seen by a BatchObserver.
+ */
+enum class JobEventKind {
+    Succeeded,
+    Failed,    ///< One attempt failed; it may still be retried.
+    Cancelled,
+    TimedOut,  ///< One attempt overran its timeout; a Failed event follows.
+    Expired    ///< Dropped unrun because it could no longer start in time.
+};
+
+/**
+ * @struct JobEvent
+ * @brief One completion event delivered to a BatchObserver.
+ */
+struct JobEvent {
+    JobEventKind kind;
+    int attempt;                     ///< Attempt that succeeded or failed.
+    Job::TimePoint time;             ///< When the event happened on the worker.
+    std::shared_ptr<const Job> job;  ///< Kept alive until the batch has been delivered.
+};
+
+/**
+ * @class BatchObserver
+ * @brief Interface for sinks that prefer many events per call, such as metrics or audit logs.
+ *
+ * Workers append events to per-thread buffers; a delivery thread hands each worker's
+ * buffered events over as contiguous spans, so one virtual call can cover thousands of jobs.
+ * Events of one worker arrive in order; events of different workers are not ordered.
+ */
+class BatchObserver {
+public:
+    virtual ~BatchObserver() = default;
+
+    /**
+     * @brief Called on the delivery thread with events collected by one worker.
+     * @param events The events; valid only during the call.
+     * @param count Number of events, at least one.
+     */
+    virtual void onJobEvents(const JobEvent* events, size_t count) = 0;
 };
 
-}
\ No newline at end of file
+}
@@ -0,0 +1,119 @@
+/**
+ * @file ObserverRegistry.hpp
+ * @brief Declares ObserverRegistry, a copy-on-write set of observers with wait-free reads.
+ */
+
+#pragma once
+
+#include "Job.hpp"
+#include "Observer.hpp"
+#include "PerThread.hpp"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace scheduleit {
+
+/**
+ * @struct ObserverRegistryOptions
+ * @brief Buffering of events for BatchObservers.
+ */
+struct ObserverRegistryOptions {
+    size_t batch_capacity = 4096;                ///< Events buffered per worker; rounded up to a power of two.
+    std::chrono::milliseconds batch_interval{10};  ///< Longest an event waits for delivery.
+};
+
+/**
+ * @class ObserverRegistry
+ * @brief The observers of a JobExecutor, safe to change while jobs run.
+ *
+ * The observer lists live in an immutable snapshot behind an atomic pointer. Changing them
+ * copies the snapshot and swaps the pointer (read-copy-update). Notifying is wait-free: the
+ * worker publishes the epoch it entered in, loads the pointer and calls the observers, and
+ * never takes a lock. A replaced snapshot is freed once every thread that might still be
+ * reading it has left; remove() waits for that grace period, so a removed observer is not
+ * called any more once remove() returns.
+ *
+ * Events for BatchObservers go into a single-producer ring per worker and are delivered in
+ * spans by a background thread, started with the first BatchObserver. A worker whose ring is
+ * full waits for the delivery thread rather than drop an event.
+ */
+class ObserverRegistry {
+public:
+    explicit ObserverRegistry(ObserverRegistryOptions options = ObserverRegistryOptions());
+
+    /**
+     * @brief Delivers outstanding batch events and stops the delivery thread.
+     *
+     * No thread may be notifying when the registry is destroyed.
+     */
+    ~ObserverRegistry();
+
+    ObserverRegistry(const ObserverRegistry&) = delete;
+    ObserverRegistry& operator=(const ObserverRegistry&) = delete;
+
+    /// Adds an observer; null is ignored. Does not wait for running notifications.
+    void add(std::shared_ptr<Observer> observer);
+    void add(std::shared_ptr<BatchObserver> observer);
+
+    /**
+     * @brief Removes an observer and waits until no other thread can still be calling it.
+     *
+     * May be called from an observer callback, but not from two callbacks at once.
+     * @return False if the observer was not registered.
+     */
+    bool remove(const std::shared_ptr<Observer>& observer);
+    bool remove(const std::shared_ptr<BatchObserver>& observer);
+
+    void notifySuccess(const std::shared_ptr<Job>& job);
+    void notifyFailure(const std::shared_ptr<Job>& job, int attempt);
+    void notifyCancelled(const std::shared_ptr<Job>& job);
+    void notifyTimedOut(const std::shared_ptr<Job>& job, int attempt);
+    void notifyExpired(const std::shared_ptr<Job>& job);
+
+    /**
+     * @brief Blocks until every batch event recorded before the call has been delivered.
+     */
+    void flush();
+
+private:
+    struct Snapshot {
+        std::vector<std::shared_ptr<Observer>> observers;
+        std::vector<std::shared_ptr<BatchObserver>> batch_observers;
+    };
+
+    /// Per-thread state: the epoch of an active read and, once needed, the batch ring.
+    struct alignas(64) Reader {
+        explicit Reader(size_t capacity) : events(capacity) {}
+        std::atomic<uint64_t> epoch{0};  // 0 outside read sections
+        unsigned depth = 0;              // nesting of read sections; owner only
+        SpscRing<JobEvent> events;       // batch ring; its storage is allocated on first use
+    };
+
+    class ReadSection;
+
+    /// Copies the snapshot, applies the edit and waits out the grace period; under no lock.
+    template <class Edit>
+    bool removeWhere(Edit edit);
+    /// Swaps in the next snapshot and retires the old one; returns the retiring epoch.
+    uint64_t publish(std::unique_ptr<Snapshot> next);
+    /// Frees retired snapshots that no reader can still hold.
+    void reclaim();
+    void pushEvent(Reader& reader, JobEventKind kind, const std::shared_ptr<Job>& job, int attempt);
+    void deliver();
+
+    ObserverRegistryOptions options_;
+    PerThreadSlots<Reader> readers_;
+    std::atomic<const Snapshot*> current_{nullptr};  // null while nothing is registered
+    std::atomic<uint64_t> epoch_{1};
+
+    mutable std::mutex mutex_;  // serializes writers and guards the members below
+    std::vector<std::pair<const Snapshot*, uint64_t>> retired_;  // replaced snapshots and the epoch that retired them
+    DrainThread delivery_;       // started with the first BatchObserver
+    std::vector<Reader*> delivery_readers_;  // delivery thread only
+};
+
+}
@@ -0,0 +1,273 @@
+/**
+ * @file PerThread.hpp
+ * @brief Defines the per-thread building blocks of the recording paths: PerThreadSlots,
+ *        SpscRing and DrainThread.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace scheduleit {
+
+namespace detail {
+
+/// Shared by every PerThreadSlots, so a stale thread_local never matches a later instance.
+inline std::atomic<uint64_t> next_slots_instance{1};
+
+inline size_t roundUpToPowerOfTwo(size_t value) {
+    size_t result = 1;
+    while (result < value) {
+        result <<= 1;
+    }
+    return result;
+}
+
+}
+
+/**
+ * @class PerThreadSlots
+ * @brief One Slot per calling thread, created on first use and found again without a lock.
+ *
+ * local() checks a thread_local cache of the last instance and slot the thread used, so the
+ * fast path is one compare. On a miss it takes the lock and finds or creates the thread's
+ * slot. Slots live as long as the PerThreadSlots, so nothing a thread wrote is lost when it
+ * exits. Other threads visit the slots with forEach(), under the same lock.
+ *
+ * @tparam Slot The per-thread state; owner and visitors synchronize on its own atomics.
+ */
+template <class Slot>
+class PerThreadSlots {
+public:
+    using Factory = std::function<std::unique_ptr<Slot>()>;
+
+    explicit PerThreadSlots(Factory make = []() { return std::make_unique<Slot>(); })
+        : make_(std::move(make)), instance_(detail::next_slots_instance.fetch_add(1)) {}
+
+    PerThreadSlots(const PerThreadSlots&) = delete;
+    PerThreadSlots& operator=(const PerThreadSlots&) = delete;
+
+    /**
+     * @brief Returns the calling thread's slot, creating it on first use.
+     */
+    Slot& local() {
+        if (cache_.instance == instance_) {
+            return *static_cast<Slot*>(cache_.slot);
+        }
+        return registerThread();
+    }
+
+    /**
+     * @brief Returns the calling thread's slot, or null if it has none yet.
+     */
+    Slot* find() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = by_thread_.find(std::this_thread::get_id());
+        return it == by_thread_.end() ? nullptr : it->second;
+    }
+
+    /**
+     * @brief Calls visit(Slot&) for every slot, in the order the threads first used them.
+     *
+     * Holds the lock throughout, so visit must not call local() for a new thread.
+     */
+    template <class Visit>
+    void forEach(Visit visit) const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (const auto& slot : slots_) {
+            visit(*slot);
+        }
+    }
+
+    /**
+     * @brief Replaces the contents of out with every slot, for visiting without the lock.
+     */
+    void collect(std::vector<Slot*>& out) const {
+        out.clear();
+        forEach([&out](Slot& slot) { out.push_back(&slot); });
+    }
+
+private:
+    struct Cache {
+        uint64_t instance = 0;
+        void* slot = nullptr;
+    };
+
+    Slot& registerThread() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        Slot*& slot = by_thread_[std::this_thread::get_id()];
+        if (!slot) {
+            slots_.push_back(make_());
+            slot = slots_.back().get();
+        }
+        cache_ = Cache{instance_, slot};
+        return *slot;
+    }
+
+    static thread_local Cache cache_;
+
+    Factory make_;
+    const uint64_t instance_;
+    mutable std::mutex mutex_;
+    std::vector<std::unique_ptr<Slot>> slots_;
+    std::unordered_map<std::thread::id, Slot*> by_thread_;
+};
+
+template <class Slot>
+thread_local typename PerThreadSlots<Slot>::Cache PerThreadSlots<Slot>::cache_;
+
+/**
+ * @class SpscRing
+ * @brief Bounded single-producer single-consumer ring.
+ *
+ * The producer fills the slot from claim() in place and publishes it with commit(); the
+ * consumer takes published elements in contiguous spans with consume(). Storage is allocated
+ * by the first claim(), so a thread that never produces costs no memory.
+ *
+ * @tparam T A default-constructible element type.
+ */
+template <class T>
+class SpscRing {
+public:
+    /**
+     * @param capacity Elements held; rounded up to a power of two, at least 2.
+     */
+    explicit SpscRing(size_t capacity) : capacity_(detail::roundUpToPowerOfTwo(capacity < 2 ? 2 : capacity)) {}
+
+    SpscRing(const SpscRing&) = delete;
+    SpscRing& operator=(const SpscRing&) = delete;
+
+    size_t capacity() const {
+        return capacity_;
+    }
+
+    /**
+     * @brief Returns the slot for the next element, or null while the ring is full. Producer only.
+     */
+    T* claim() {
+        uint64_t tail = tail_.load(std::memory_order_relaxed);
+        if (tail - cached_head_ >= capacity_) {
+            cached_head_ = head_.load(std::memory_order_acquire);
+            if (tail - cached_head_ >= capacity_) {
+                return nullptr;
+            }
+        }
+        if (!slots_) {
+            // Published to the consumer by the first commit().
+            slots_.reset(new T[capacity_]);
+        }
+        return &slots_[tail & (capacity_ - 1)];
+    }
+
+    /**
+     * @brief Publishes the claimed slot. Producer only.
+     * @return How full the ring is as the producer last saw it, this element included.
+     */
+    size_t commit() {
+        uint64_t tail = tail_.load(std::memory_order_relaxed) + 1;
+        tail_.store(tail, std::memory_order_release);
+        return static_cast<size_t>(tail - cached_head_);
+    }
+
+    /**
+     * @brief Hands every published element to take(T* first, size_t count) in at most two
+     *        contiguous spans, freeing each span's slots once take returns. Consumer only.
+     * @return The number of elements taken.
+     */
+    template <class Take>
+    uint64_t consume(Take take) {
+        uint64_t first = head_.load(std::memory_order_relaxed);
+        uint64_t tail = tail_.load(std::memory_order_acquire);
+        uint64_t head = first;
+        while (head != tail) {
+            size_t begin = static_cast<size_t>(head & (capacity_ - 1));
+            size_t count = static_cast<size_t>(std::min<uint64_t>(tail - head, capacity_ - begin));
+            take(&slots_[begin], count);
+            head += count;
+            head_.store(head, std::memory_order_release);
+        }
+        return tail - first;
+    }
+
+private:
+    const size_t capacity_;
+    std::unique_ptr<T[]> slots_;
+    alignas(64) std::atomic<uint64_t> head_{0};  // next element to take; written by the consumer
+    alignas(64) std::atomic<uint64_t> tail_{0};  // next slot to fill; written by the producer
+    uint64_t cached_head_ = 0;                   // producer's last view of head_
+};
+
+/**
+ * @class DrainThread
+ * @brief A background thread that calls a drain function every interval, when woken, and
+ *        on flush().
+ *
+ * Producers call wake() when a buffer fills up; it costs one relaxed exchange unless a wake
+ * is already pending. flush() blocks until a drain that started after the call has finished.
+ * stop() runs one last drain before the thread exits.
+ */
+class DrainThread {
+public:
+    DrainThread(std::chrono::milliseconds interval, std::function<void()> drain);
+
+    /**
+     * @brief Stops the thread if it is running.
+     */
+    ~DrainThread();
+
+    DrainThread(const DrainThread&) = delete;
+    DrainThread& operator=(const DrainThread&) = delete;
+
+    /// Starts the thread. Not thread-safe against itself, running() or stop().
+    void start();
+    bool running() const {
+        return thread_.joinable();
+    }
+
+    /**
+     * @brief Asks for a drain before the interval is up. Lock-free.
+     */
+    void wake() {
+        if (!wake_pending_.exchange(true, std::memory_order_relaxed)) {
+            cv_.notify_one();
+        }
+    }
+
+    /**
+     * @brief Blocks until everything produced before the call has been drained. The thread
+     *        must be running.
+     */
+    void flush();
+
+    /**
+     * @brief Drains one last time and joins the thread.
+     */
+    void stop();
+
+private:
+    void run();
+
+    const std::chrono::milliseconds interval_;
+    const std::function<void()> drain_;
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    std::condition_variable flushed_cv_;
+    uint64_t flush_requested_ = 0;
+    uint64_t flush_completed_ = 0;
+    bool stopping_ = false;
+    std::atomic<bool> wake_pending_{false};
+    std::thread thread_;
+};
+
+}
@@ -0,0 +1,181 @@
+/**
+ * @file PoolAllocator.hpp
+ * @brief Defines a slab-backed allocator with per-thread free lists for fixed-size objects.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <mutex>
+#include <new>
+#include <vector>
+
+namespace scheduleit {
+
+/**
+ * @class BlockPool
+ * @brief Process-wide pool of fixed-size blocks carved out of large slabs.
+ *
+ * Each thread keeps a private free list, so allocation and release are a few pointer
+ * operations with no locking. A thread only touches the shared list, under a mutex, to refill
+ * an empty cache or to hand back a batch when its cache grows past a limit, which is what
+ * happens when jobs are created on one thread and destroyed on another. Slabs are never
+ * returned to the system; the pool keeps its high-water mark.
+ *
+ * @tparam Size Block size in bytes.
+ * @tparam Align Block alignment.
+ */
+template <size_t Size, size_t Align>
+class BlockPool {
+public:
+    static void* allocate() {
+        LocalCache& cache = local();
+        if (!cache.head) {
+            refill(cache);
+        }
+        FreeBlock* block = cache.head;
+        cache.head = block->next;
+        --cache.count;
+        return block;
+    }
+
+    static void deallocate(void* pointer) noexcept {
+        LocalCache& cache = local();
+        auto* block = static_cast<FreeBlock*>(pointer);
+        block->next = cache.head;
+        cache.head = block;
+        ++cache.count;
+        if (cache.count > kCacheLimit || cache.exiting) {
+            release(cache, cache.exiting ? cache.count : cache.count / 2);
+        }
+    }
+
+private:
+    struct FreeBlock {
+        FreeBlock* next;
+    };
+
+    static constexpr size_t kAlign = Align > alignof(FreeBlock) ? Align : alignof(FreeBlock);
+    static constexpr size_t kBlockSize =
+        ((Size > sizeof(FreeBlock) ? Size : sizeof(FreeBlock)) + kAlign - 1) / kAlign * kAlign;
+    static constexpr size_t kBlocksPerSlab = 1024;
+    static constexpr size_t kBatch = 128;
+    static constexpr size_t kCacheLimit = 4 * kBatch;
+
+    struct LocalCache {
+        FreeBlock* head = nullptr;
+        size_t count = 0;
+        bool exiting = false;
+    };
+
+    // Returns a thread's blocks to the shared list when the thread exits.
+    struct CacheFlusher {
+        LocalCache* cache;
+        ~CacheFlusher() {
+            cache->exiting = true;
+            release(*cache, cache->count);
+        }
+    };
+
+    struct Shared {
+        std::mutex mutex;
+        FreeBlock* head = nullptr;
+        std::vector<void*> slabs;
+    };
+
+    static LocalCache& local() {
+        thread_local LocalCache cache;  // trivially destructible, usable until the thread ends
+        thread_local CacheFlusher flusher{&cache};
+        (void)flusher;
+        return cache;
+    }
+
+    static Shared& shared() {
+        static Shared* instance = new Shared();  // intentionally leaked: outlives static destructors
+        return *instance;
+    }
+
+    static void refill(LocalCache& cache) {
+        Shared& pool = shared();
+        std::lock_guard<std::mutex> lock(pool.mutex);
+        if (!pool.head) {
+            auto* slab = static_cast<char*>(::operator new(kBlockSize * kBlocksPerSlab, std::align_val_t(kAlign)));
+            pool.slabs.push_back(slab);
+            for (size_t i = 0; i < kBlocksPerSlab; ++i) {
+                auto* block = reinterpret_cast<FreeBlock*>(slab + i * kBlockSize);
+                block->next = pool.head;
+                pool.head = block;
+            }
+        }
+        for (size_t i = 0; i < kBatch && pool.head; ++i) {
+            FreeBlock* block = pool.head;
+            pool.head = block->next;
+            block->next = cache.head;
+            cache.head = block;
+            ++cache.count;
+        }
+    }
+
+    static void release(LocalCache& cache, size_t count) noexcept {
+        if (count == 0) {
+            return;
+        }
+        FreeBlock* first = cache.head;
+        FreeBlock* last = first;
+        for (size_t i = 1; i < count; ++i) {
+            last = last->next;
+        }
+        cache.head = last->next;
+        cache.count -= count;
+
+        Shared& pool = shared();
+        std::lock_guard<std::mutex> lock(pool.mutex);
+        last->next = pool.head;
+        pool.head = first;
+    }
+};
+
+/**
+ * @class PoolAllocator
+ * @brief Standard allocator that serves single-object requests from a BlockPool.
+ *
+ * Meant for std::allocate_shared, which places the object and its reference counts in one
+ * pooled block. Array requests fall back to operator new.
+ */
+template <class T>
+class PoolAllocator {
+public:
+    using value_type = T;
+
+    PoolAllocator() noexcept = default;
+
+    template <class U>
+    PoolAllocator(const PoolAllocator<U>&) noexcept {}
+
+    T* allocate(size_t n) {
+        if (n != 1) {
+            return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t(alignof(T))));
+        }
+        return static_cast<T*>(BlockPool<sizeof(T), alignof(T)>::allocate());
+    }
+
+    void deallocate(T* pointer, size_t n) noexcept {
+        if (n != 1) {
+            ::operator delete(pointer, std::align_val_t(alignof(T)));
+            return;
+        }
+        BlockPool<sizeof(T), alignof(T)>::deallocate(pointer);
+    }
+
+    template <class U>
+    bool operator==(const PoolAllocator<U>&) const noexcept {
+        return true;
+    }
+
+    template <class U>
+    bool operator!=(const PoolAllocator<U>&) const noexcept {
+        return false;
+    }
+};
+
+}
@@ -0,0 +1,103 @@
+/**
+ * @file PriorityJobStore.hpp
+ * @brief Defines a JobStore decorator that releases due jobs by QoS class or deadline.
+ */
+
+#pragma once
+
+#include "JobStore.hpp"
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <vector>
+
+namespace scheduleit {
+
+/**
+ * @enum PriorityPolicy
+ * @brief Chooses which job a JobQueue serves next among jobs that are already due.
+ */
+enum class PriorityPolicy {
+    None,            ///< Ignore priorities: due jobs leave in scheduled-time order.
+    WeightedFair,    ///< Smooth weighted round robin over the backlogged classes.
+    StrictWithAging, ///< Highest class first; classes waiting past the aging limit get every other turn.
+    /// Earliest Job::getDeadline() first, ignoring classes. Jobs without a deadline follow
+    /// in scheduled-time order, so they wait while any job with a deadline is due.
+    EarliestDeadlineFirst
+};
+
+/**
+ * @struct PriorityClassStats
+ * @brief Counters for one QoS class.
+ */
+struct PriorityClassStats {
+    size_t queued = 0;    ///< Jobs of this class in the queue, due or not; may include stale entries.
+    size_t ready = 0;     ///< Jobs that are due and waiting for a worker.
+    uint64_t dequeued = 0;
+    std::chrono::nanoseconds total_wait{0};  ///< Sum over dequeued jobs of (dequeue time - scheduled time).
+    std::chrono::nanoseconds max_wait{0};
+};
+
+using PriorityStats = std::array<PriorityClassStats, kJobPriorityCount>;
+
+/**
+ * @class PriorityJobStore
+ * @brief Keeps future jobs in an inner JobStore and due jobs in one FIFO per QoS class.
+ *
+ * Every popReady() first moves all due jobs out of the inner store, then picks the class to
+ * serve. A flood of due low-priority jobs therefore no longer delays a high-priority job that
+ * becomes due after them. Under WeightedFair a backlogged class with weight w gets w/W of the
+ * dequeues. Under StrictWithAging the highest backlogged class is served, except that a lower
+ * class whose head has waited longer than the aging limit gets every other dequeue; this
+ * bounds the starvation of low classes and still keeps high classes' delay bounded.
+ *
+ * Under EarliestDeadlineFirst the due jobs sit in one binary heap keyed by deadline instead
+ * of the per-class FIFOs; the per-class counters are kept all the same.
+ */
+class PriorityJobStore : public JobStore {
+public:
+    /**
+     * @brief Constructor.
+     * @param inner Store holding jobs until they are due.
+     * @param policy Selection policy; must not be None.
+     * @param weights Per-class weights for WeightedFair, highest class first. Zero counts as one.
+     * @param aging Waiting time after which StrictWithAging serves a lower class's head.
+     */
+    PriorityJobStore(std::unique_ptr<JobStore> inner,
+                     PriorityPolicy policy,
+                     const std::array<unsigned, kJobPriorityCount>& weights,
+                     std::chrono::milliseconds aging);
+
+    void push(std::shared_ptr<Job> job) override;
+    void pushBatch(std::vector<std::shared_ptr<Job>>& jobs) override;
+    std::shared_ptr<Job> popReady(Job::TimePoint now) override;
+    Job::TimePoint nextWakeTime() const override;
+    void removeStale(std::vector<std::shared_ptr<Job>>& removed) override;
+    size_t size() const override;
+
+    /**
+     * @brief Returns per-class depths and wait-time counters.
+     */
+    PriorityStats stats() const;
+
+private:
+    std::shared_ptr<Job> popStaleHead(Job::TimePoint now);
+    std::shared_ptr<Job> popEarliestDeadline();
+    size_t pickWeighted();
+    size_t pickStrict(Job::TimePoint now);
+
+    std::unique_ptr<JobStore> inner_;
+    PriorityPolicy policy_;
+    std::array<int64_t, kJobPriorityCount> weights_{};
+    Job::TimePoint::duration aging_;
+    std::array<std::deque<std::shared_ptr<Job>>, kJobPriorityCount> ready_;
+    std::vector<std::shared_ptr<Job>> deadline_heap_;  // EarliestDeadlineFirst's ready jobs
+    Job::TimePoint heap_wake_ = Job::TimePoint::max();  // at or before every heap entry's scheduled time
+    std::array<int64_t, kJobPriorityCount> credit_{};
+    size_t ready_count_ = 0;
+    bool last_pick_aged_ = false;
+    PriorityStats stats_{};
+};
+
+}
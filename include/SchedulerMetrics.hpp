@@ -0,0 +1,90 @@
+/**
+ * @file SchedulerMetrics.hpp
+ * @brief Declares SchedulerMetrics, per-worker latency histograms of a JobScheduler.
+ */
+
+#pragma once
+
+#include "Job.hpp"
+#include "LatencyHistogram.hpp"
+#include "PerThread.hpp"
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+namespace scheduleit {
+
+/**
+ * @struct MetricsSnapshot
+ * @brief The four histograms of one worker, or of several merged together.
+ *
+ * Times are in nanoseconds. A job becomes ready at its scheduled time, or when it is queued
+ * if that is later.
+ */
+struct MetricsSnapshot {
+    HistogramSnapshot queue_wait;    ///< From being queued (submission, retry or next firing) until ready.
+    HistogramSnapshot dispatch_lag;  ///< From ready until a worker starts it: lateness against getScheduledTime().
+    HistogramSnapshot execution;     ///< Time spent in the task, whether it returned or threw.
+    HistogramSnapshot retries;       ///< Retries a run needed, recorded once it succeeded or gave up.
+
+    /**
+     * @brief Adds another snapshot's values to this one.
+     */
+    void merge(const MetricsSnapshot& other);
+};
+
+/**
+ * @class SchedulerMetrics
+ * @brief Latency histograms kept per recording thread, so workers never share a cache line.
+ *
+ * Each thread that records gets its own cache-line aligned block of histograms on first use
+ * and finds it again through a thread_local, so the recording path takes no lock and does no
+ * atomic read-modify-write. Blocks outlive their threads, so nothing recorded is lost when a
+ * pool shrinks. Snapshots may be taken at any time from any thread.
+ */
+class SchedulerMetrics {
+public:
+    SchedulerMetrics();
+
+    SchedulerMetrics(const SchedulerMetrics&) = delete;
+    SchedulerMetrics& operator=(const SchedulerMetrics&) = delete;
+
+    /**
+     * @brief Records the queue wait and dispatch lag of a job a worker is starting now.
+     */
+    void recordStart(const Job& job, Job::TimePoint started);
+
+    /**
+     * @brief Records the duration of one execution.
+     */
+    void recordExecution(std::chrono::nanoseconds duration);
+
+    /**
+     * @brief Records how many retries a run took, once it will not be retried again.
+     */
+    void recordRetries(int retries);
+
+    /**
+     * @brief Returns every recording thread's histograms merged into one snapshot.
+     */
+    MetricsSnapshot snapshot() const;
+
+    /**
+     * @brief Returns one snapshot per recording thread, in the order the threads first recorded.
+     */
+    std::vector<MetricsSnapshot> snapshotWorkers() const;
+
+private:
+    struct alignas(64) Worker {
+        LatencyHistogram queue_wait;
+        LatencyHistogram dispatch_lag;
+        LatencyHistogram execution;
+        LatencyHistogram retries;
+    };
+
+    static void addTo(const Worker& worker, MetricsSnapshot& snapshot);
+
+    PerThreadSlots<Worker> workers_;
+};
+
+}
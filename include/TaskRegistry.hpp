@@ -0,0 +1,62 @@
+/**
+ * @file TaskRegistry.hpp
+ * @brief Defines TaskRegistry, which maps task names to factories so journaled jobs can be rebuilt.
+ */
+
+#pragma once
+
+#include "Job.hpp"
+#include "RetryStrategy.hpp"
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+namespace scheduleit {
+
+/**
+ * @class TaskRegistry
+ * @brief Registry of named task factories.
+ *
+ * A closure cannot be written to disk, so a durable job is described by a task name and an
+ * opaque payload; the factory registered under that name turns the payload back into a task,
+ * both when the job is first created and when a Journal recovers it after a restart. Register
+ * every task before the registry is shared with a Journal; lookups are not synchronized with
+ * add().
+ */
+class TaskRegistry {
+public:
+    using Factory = std::function<Job::Task(const std::string& payload)>;
+
+    /**
+     * @brief Registers a task factory, replacing any previous one with the same name.
+     * @param name Name stored in the journal; keep it stable across releases.
+     * @param factory Builds the task from a payload.
+     * @param retry_strategy Retry strategy for jobs of this task, also after recovery.
+     * @throws std::invalid_argument if name is empty or factory is empty.
+     */
+    void add(const std::string& name, Factory factory, std::shared_ptr<RetryStrategy> retry_strategy = nullptr);
+
+    bool contains(const std::string& name) const;
+
+    /**
+     * @brief Creates a durable job running the named task.
+     * @throws std::invalid_argument if no task has that name.
+     */
+    std::shared_ptr<Job> create(const std::string& name,
+                                std::string payload,
+                                std::chrono::milliseconds delay = std::chrono::milliseconds(0),
+                                int max_retries = 3,
+                                std::string id = "") const;
+
+private:
+    struct Entry {
+        Factory factory;
+        std::shared_ptr<RetryStrategy> retry_strategy;
+    };
+
+    std::unordered_map<std::string, Entry> entries_;
+};
+
+}
@@ -5,20 +5,84 @@
 
 #pragma once
 
+#include "PoolAllocator.hpp"
+#include "CancellationToken.hpp"
+#include "CpuTopology.hpp"
+#include "UniqueFunction.hpp"
+#include "Watchdog.hpp"
+#include "WorkStealingDeque.hpp"
+#include <atomic>
+#include <chrono>
 #include <condition_variable>
+#include <cstdint>
 #include <functional>
 #include <future>
 #include <mutex>
 #include <queue>
 #include <thread>
+#include <tuple>
 #include <vector>
 #include <iostream>
+#include <memory>
 
 namespace scheduleit {
 
+/**
+ * @struct ElasticOptions
+ * @brief Bounds and pacing of an elastic ThreadPool; see ThreadPoolOptions::elastic.
+ *
+ * Every interval a controller thread samples the queue depth, how many workers are running a
+ * task, and how much CPU time the workers used. Busy workers that used no CPU were blocked,
+ * on I/O or a sleep. The pool grows while tasks wait, every worker is busy and the workers
+ * leave a CPU unused (because they block, or because there are fewer workers than CPUs),
+ * and only once that has held for grow_after. It shrinks after shrink_after with idle
+ * workers and nothing queued. Growth is quick and shrinking slow, so a bursty load does not
+ * make the pool flap.
+ */
+struct ElasticOptions {
+    size_t min_threads = 0;  ///< Smallest size; at least 1 when elastic.
+    size_t max_threads = 0;  ///< Largest size; 0 keeps the pool at a fixed size.
+    std::chrono::milliseconds interval{10};       ///< Controller sampling period.
+    std::chrono::milliseconds grow_after{20};     ///< How long the pool must be short of workers.
+    std::chrono::milliseconds shrink_after{500};  ///< How long workers must sit idle.
+};
+
+/**
+ * @struct ElasticStats
+ * @brief What an elastic ThreadPool's controller saw at its last sample and what it did.
+ */
+struct ElasticStats {
+    size_t workers = 0;            ///< Live workers, less any told to retire.
+    size_t busy = 0;               ///< Workers running a task.
+    size_t queued = 0;             ///< Tasks waiting for a worker.
+    double cpu = 0;                ///< CPUs the workers used over the last interval.
+    double blocked = 0;            ///< Busy workers that were off CPU over the last interval.
+    size_t peak_workers = 0;
+    uint64_t grow_decisions = 0;
+    uint64_t shrink_decisions = 0;
+    uint64_t threads_started = 0;  ///< By the controller, beyond the initial workers.
+    uint64_t threads_retired = 0;
+};
+
+/**
+ * @struct ThreadPoolOptions
+ * @brief Optional configuration for a ThreadPool.
+ */
+struct ThreadPoolOptions {
+    size_t max_queue_size = 0;   ///< Maximum queued tasks (0 for unbounded).
+    bool work_stealing = false;  ///< Give each worker its own deque and let idle workers steal.
+    /// Group workers by NUMA node with one ready queue per node; implies work stealing.
+    std::shared_ptr<const CpuTopology> topology;
+    /// Pin each worker to one CPU: of its node with a topology, else of CpuTopology::detect().
+    bool pin_workers = false;
+    /// Let a controller resize the pool between min_threads and max_threads. Shared-queue
+    /// mode only: work-stealing deques are indexed by a fixed worker count.
+    ElasticOptions elastic;
+};
+
 /**
  * @class ThreadPool
- * @brief A fixed-size thread pool that runs submitted tasks concurrently.
+ * @brief A thread pool, fixed-size or elastic, that runs submitted tasks concurrently.
  *
  * Thread-safe and supports graceful shutdown.
  */
@@ -31,6 +95,25 @@ public:
      */
     explicit ThreadPool(size_t num_threads, size_t max_queue_size = 0);
 
+    /**
+     * @brief Constructs the thread pool with explicit options.
+     * @param num_threads Number of worker threads to spawn.
+     * @param options Queue bound, scheduling mode and sizing.
+     * @throws std::invalid_argument if elastic bounds are given with work stealing, or do
+     *         not satisfy 1 <= min_threads <= num_threads <= max_threads.
+     *
+     * In work-stealing mode, tasks submitted from a worker go onto that worker's own deque and
+     * idle workers steal from random victims; tasks submitted from other threads go through a
+     * shared injection queue. The queue bound is enforced exactly for external submitters; a
+     * worker that submits while the pool is full runs the task inline instead of blocking.
+     *
+     * With a topology, worker i serves node i % nodes and each node has its own injection
+     * queue. An idle worker takes from its node's queue, then steals from workers of its own
+     * node, and only then from other nodes. Each worker allocates its deque after pinning, so
+     * the memory is local to its node.
+     */
+    ThreadPool(size_t num_threads, const ThreadPoolOptions& options);
+
     /**
      * @brief Destroys the thread pool and joins all worker threads.
      */
@@ -55,12 +138,61 @@ public:
         -> std::future<typename std::invoke_result_t<F, Args...>>;
 
     /**
-     * @brief Submits a task with a timeout. If the task doesn't complete in time, it is abandoned.
+     * @brief Submits a task without creating a future.
+     *
+     * Use this when the caller never needs the result: it skips the shared state a future
+     * requires, so a small task is queued without allocating. Exceptions thrown by the task are
+     * logged and discarded.
+     * @tparam F Function type
+     * @tparam Args Arguments to the function
+     * @param f The function to execute
+     * @param args The arguments to the function
+     */
+    template <class F, class... Args>
+    void submitDetached(F&& f, Args&&... args);
+
+    /**
+     * @brief Submits a range of tasks without futures, taking the queue lock once.
+     *
+     * The callables are moved out of the range. Workers are woken up to the number of tasks
+     * added. With a bounded queue the call blocks, as submit() does, whenever the queue fills.
+     * @tparam InputIt Iterator over callables invocable as void().
+     * @param first Start of the range.
+     * @param last End of the range.
+     */
+    template <class InputIt>
+    void submitBulk(InputIt first, InputIt last);
+
+    /**
+     * @brief Submits a task without a future, preferably for a worker of one NUMA node.
+     *
+     * A hint, not a guarantee: idle workers of other nodes still steal the task. Without a
+     * topology, or with CpuTopology::kAnyNode, this is submitDetached().
+     * @param node A node id of the pool's topology (CpuTopology::getNodeId()).
+     * @throws std::invalid_argument if the topology has no node with CPUs of that id.
+     */
+    template <class F>
+    void submitDetachedToNode(size_t node, F&& f);
+
+    /**
+     * @brief submitBulk() with every task placed on one NUMA node; see submitDetachedToNode().
+     */
+    template <class InputIt>
+    void submitBulkToNode(size_t node, InputIt first, InputIt last);
+
+    /**
+     * @brief Submits a task with a timeout, enforced cooperatively.
+     *
+     * The task runs on a pool worker like any other; the shared Watchdog tracks its deadline,
+     * so no thread is created. If the task is still running at the deadline, "[ThreadPool]
+     * Task timed out." is logged and its CancellationToken is cancelled. A task that can take
+     * a CancellationToken as its last argument receives one and should poll it; the pool
+     * never interrupts a task.
      * @tparam F Function type
      * @tparam Args Arguments to the function
      * @param f The function to execute
      * @param args The arguments to the function
-     * @param timeout Maximum time allowed for the task to run.
+     * @param timeout Maximum time allowed for the task to run; 0 for none.
      */
     template <class F, class... Args>
     void submitWithTimeout(F&& f, Args&&... args, std::chrono::milliseconds timeout);
@@ -70,20 +202,140 @@ public:
      */
     void shutdown();
 
+    /**
+     * @brief Returns the number of NUMA nodes the workers are grouped into (1 without a topology).
+     */
+    size_t getNodeCount() const {
+        return nodes_.empty() ? 1 : nodes_.size();
+    }
+
+    /**
+     * @brief Returns the topology the workers are grouped by, or null without one.
+     */
+    const CpuTopology* getTopology() const {
+        return topology_.get();
+    }
+
+    /**
+     * @brief Returns the node id of the calling thread if it is a work-stealing worker of any
+     *        pool (0 without a topology), else CpuTopology::kAnyNode.
+     */
+    static size_t currentNode();
+
+    /**
+     * @brief Returns the number of tasks stolen from another worker of the thief's node.
+     */
+    uint64_t getLocalSteals() const {
+        return local_steals_.load();
+    }
+
+    /**
+     * @brief Returns the number of tasks a worker took from another node: from its queue or
+     *        by stealing from one of its workers.
+     */
+    uint64_t getRemoteSteals() const {
+        return remote_steals_.load();
+    }
+
+    /**
+     * @brief Returns the number of tasks queued and not yet taken by a worker.
+     */
+    size_t getQueuedTasks() const;
+
+    /**
+     * @brief Returns the elastic controller's latest sample and decision counts; all zero
+     *        for a fixed-size pool.
+     */
+    ElasticStats getElasticStats() const;
+
+    /**
+     * @brief Returns the number of workers successfully pinned to a CPU.
+     */
+    size_t getPinnedWorkers() const {
+        return pinned_workers_.load();
+    }
+
 private:
+    using Task = UniqueFunction<void()>;
+    using TaskNodePool = BlockPool<sizeof(Task), alignof(Task)>;
+
+    struct WorkerQueue {
+        WorkStealingDeque<Task*> deque;
+        size_t node = 0;
+    };
+
+    /// Tasks injected into one NUMA node and the workers that serve it (work-stealing mode).
+    struct NodeQueue {
+        std::mutex mutex;               // guards tasks
+        std::queue<Task> tasks;
+        std::atomic<size_t> injected{0};  // tasks.size(), readable without the lock
+        std::condition_variable wake;   // waited on with mutex_
+        size_t sleepers = 0;            // guarded by mutex_
+        std::vector<size_t> workers;
+    };
+
     std::vector<std::thread> workers_;
-    std::queue<std::function<void()>> tasks_;
+    std::queue<Task> tasks_;
 
-    std::mutex mutex_;
+    mutable std::mutex mutex_;
     std::condition_variable condition_;
     std::condition_variable queue_not_full_condition_;
     bool stop_ = false;
     size_t max_queue_size_ = 0;
 
+    // Work-stealing mode only.
+    bool work_stealing_ = false;
+    std::vector<std::unique_ptr<WorkerQueue>> local_queues_;
+    std::vector<std::unique_ptr<NodeQueue>> nodes_;
+    size_t next_node_ = 0;                // node of the next unhinted external task; guarded by mutex_
+    std::atomic<size_t> queued_{0};       // tasks in all deques plus the injection queues, and reserved ones
+    std::atomic<int> sleepers_{0};
+    std::atomic<int> blocked_submitters_{0};
+    std::atomic<uint64_t> local_steals_{0};
+    std::atomic<uint64_t> remote_steals_{0};
+    std::atomic<size_t> pinned_workers_{0};
+    std::atomic<size_t> started_workers_{0};
+    std::shared_ptr<const CpuTopology> pin_topology_;  // set when pin_workers is
+    std::shared_ptr<const CpuTopology> topology_;      // maps node ids to indices of nodes_
+
+    // Elastic mode only; the fields below the thread are guarded by mutex_.
+    ElasticOptions elastic_;
+    bool is_elastic_ = false;
+    std::atomic<size_t> busy_{0};
+    std::thread controller_;
+    std::condition_variable controller_wake_;
+    size_t retire_ = 0;                          // idle workers asked to exit
+    std::vector<std::thread::id> retired_;       // exited workers waiting to be joined
+    size_t next_worker_index_ = 0;
+    ElasticStats elastic_stats_;
+
+    void start(size_t num_threads, const ThreadPoolOptions& options);
     void workerLoop();
+    void spawnWorker();
+    void controlLoop();
+    void stealingWorkerLoop(size_t index, size_t node);
+    size_t nodeIndex(size_t node) const;
+    void enqueueStealing(Task task, size_t node = CpuTopology::kAnyNode);
+    void enqueueBulk(std::vector<Task>& tasks, size_t node = CpuTopology::kAnyNode);
+    /// Counts up to count tasks into queued_ without passing max_queue_size_; returns how many.
+    size_t reserveQueued(size_t count);
+    /// Queues count tasks that reserveQueued() has already counted.
+    void inject(Task* first, size_t count, size_t node);
+    void wakeWorkers(size_t count);
+    void wakeNodes(size_t node, size_t count);
+    bool takeTask(size_t index, Task& task);
+    bool takeInjected(size_t node, Task& task);
+    bool stealFromNode(size_t node, size_t thief, Task*& taken);
+    static Task* newTaskNode(Task&& task);
+    static void deleteTaskNode(Task* node) noexcept;
+    void runTask(Task& task);
 
     template <class Callable>
     void enqueueTask(Callable&& wrapper) {
+        if (work_stealing_) {
+            enqueueStealing(Task(std::forward<Callable>(wrapper)));
+            return;
+        }
         std::unique_lock<std::mutex> lock(mutex_);
         if (stop_) {
             throw std::runtime_error("ThreadPool is stopped");
@@ -106,29 +358,79 @@ auto ThreadPool::submit(F&& f, Args&&... args)
     -> std::future<typename std::invoke_result_t<F, Args...>> {
     using ReturnType = typename std::invoke_result_t<F, Args...>;
 
-    auto task = std::make_shared<std::packaged_task<ReturnType()>>(
-        std::bind(std::forward<F>(f), std::forward<Args>(args)...));
+    // Arguments are stored decayed and passed as lvalues, as std::bind would.
+    std::packaged_task<ReturnType()> task(
+        [f = std::forward<F>(f), args = std::make_tuple(std::forward<Args>(args)...)]() mutable {
+            return std::apply(f, args);
+        });
 
-    std::future<ReturnType> result = task->get_future();
-    enqueueTask([task]() { (*task)(); });
+    std::future<ReturnType> result = task.get_future();
+    enqueueTask([task = std::move(task)]() mutable { task(); });
     return result;
 }
 
 template <class F, class... Args>
-void ThreadPool::submitWithTimeout(F&& f, Args&&... args, std::chrono::milliseconds timeout) {
-    auto task = std::make_shared<std::packaged_task<void()>>(
-        std::bind(std::forward<F>(f), std::forward<Args>(args)...));
+void ThreadPool::submitDetached(F&& f, Args&&... args) {
+    if constexpr (sizeof...(Args) == 0) {
+        enqueueTask(std::forward<F>(f));
+    } else {
+        enqueueTask(
+            [f = std::forward<F>(f), args = std::make_tuple(std::forward<Args>(args)...)]() mutable {
+                std::apply(f, args);
+            });
+    }
+}
 
-    std::function<void()> wrapper = [task, timeout]() {
+template <class InputIt>
+void ThreadPool::submitBulk(InputIt first, InputIt last) {
+    std::vector<Task> tasks;
+    for (; first != last; ++first) {
+        tasks.emplace_back(std::move(*first));
+    }
+    enqueueBulk(tasks);
+}
+
+template <class F>
+void ThreadPool::submitDetachedToNode(size_t node, F&& f) {
+    if (work_stealing_) {
+        enqueueStealing(Task(std::forward<F>(f)), node);
+    } else {
+        enqueueTask(std::forward<F>(f));
+    }
+}
+
+template <class InputIt>
+void ThreadPool::submitBulkToNode(size_t node, InputIt first, InputIt last) {
+    std::vector<Task> tasks;
+    for (; first != last; ++first) {
+        tasks.emplace_back(std::move(*first));
+    }
+    enqueueBulk(tasks, node);
+}
+
+template <class F, class... Args>
+void ThreadPool::submitWithTimeout(F&& f, Args&&... args, std::chrono::milliseconds timeout) {
+    auto wrapper = [f = std::forward<F>(f), args = std::make_tuple(std::forward<Args>(args)...), timeout]() mutable {
+        std::shared_ptr<CancellationState> state;
         if (timeout.count() > 0) {
-            auto future = std::async(std::launch::async, [task]() { (*task)(); });
-            if (future.wait_for(timeout) == std::future_status::timeout) {
-                std::cerr << "[ThreadPool] Task timed out.\n";
-                return;
+            state = std::make_shared<CancellationState>();
+            Watchdog::instance().watch(state, Watchdog::Clock::now() + timeout,
+                                       []() { std::cerr << "[ThreadPool] Task timed out.\n"; });
+        }
+        // Disarms the deadline however the task ends.
+        struct Disarm {
+            CancellationState* state;
+            ~Disarm() {
+                if (state && !state->finish()) {
+                    state->waitForExpiry();
+                }
             }
-            future.get(); // propagate exceptions
+        } disarm{state.get()};
+        if constexpr (std::is_invocable_v<std::decay_t<F>&, std::decay_t<Args>&..., CancellationToken>) {
+            CancellationToken token(state);
+            std::apply([&](auto&... unpacked) { f(unpacked..., token); }, args);
         } else {
-            (*task)(); // no timeout
+            std::apply(f, args);
         }
     };
 
@@ -0,0 +1,86 @@
+/**
+ * @file TimingWheelJobStore.hpp
+ * @brief Defines a hierarchical timing wheel JobStore for large numbers of delayed jobs.
+ */
+
+#pragma once
+
+#include "JobStore.hpp"
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <vector>
+
+namespace scheduleit {
+
+/**
+ * @class TimingWheelJobStore
+ * @brief Hierarchical timing wheel with O(1) insert and amortized O(1) expiry.
+ *
+ * Time is divided into ticks of a configurable resolution. Level 0 holds one slot per tick,
+ * and each higher level covers 256 slots of the level below it. Jobs beyond the top level
+ * wait in an overflow list and are re-placed when the wheel reaches their range. A job is
+ * rounded up to the next tick, so it never becomes ready before its scheduled time, but may
+ * become ready up to one tick late.
+ */
+class TimingWheelJobStore : public JobStore {
+public:
+    static constexpr size_t kSlotBits = 8;
+    static constexpr size_t kSlotsPerLevel = size_t{1} << kSlotBits;
+    static constexpr size_t kMaxLevels = 7;
+
+    /**
+     * @brief Constructor.
+     * @param tick Resolution of the lowest wheel level.
+     * @param levels Number of wheel levels (1 to kMaxLevels).
+     * @param origin Time corresponding to tick zero.
+     */
+    TimingWheelJobStore(std::chrono::microseconds tick,
+                        size_t levels,
+                        Job::TimePoint origin);
+
+    void push(std::shared_ptr<Job> job) override;
+    std::shared_ptr<Job> popReady(Job::TimePoint now) override;
+    Job::TimePoint nextWakeTime() const override;
+    /// Removes entries of jobs that are no longer queued; a moved job's old entry stays until it expires.
+    void removeStale(std::vector<std::shared_ptr<Job>>& removed) override;
+    size_t size() const override;
+
+private:
+    using Slot = std::vector<std::shared_ptr<Job>>;
+
+    struct Level {
+        std::array<Slot, kSlotsPerLevel> slots;
+        std::array<uint64_t, kSlotsPerLevel / 64> occupied{};
+    };
+
+    static constexpr uint64_t kNoTick = UINT64_MAX;
+    static constexpr uint64_t kUnknownTick = UINT64_MAX - 1;
+
+    uint64_t dueTick(Job::TimePoint time) const;
+    uint64_t elapsedTicks(Job::TimePoint now) const;
+    size_t digit(uint64_t tick, size_t level) const;
+
+    void place(std::shared_ptr<Job> job);
+    void advanceTo(uint64_t target);
+    void moveCurrent(uint64_t tick);
+    void drainSlot(size_t level, size_t slot, Slot& out);
+    template <class Container>
+    void removeStaleFrom(Container& jobs, std::vector<std::shared_ptr<Job>>& removed);
+    uint64_t nextEventTick() const;
+    uint64_t scanNextEventTick() const;
+    int findOccupied(const Level& level, size_t from) const;
+
+    Job::TimePoint origin_;
+    Job::TimePoint::duration tick_;
+    std::vector<Level> levels_;
+    Slot overflow_;
+    uint64_t overflow_min_tick_ = kNoTick;
+    uint64_t current_ = 0;  // first tick whose level-0 slot has not been expired
+    std::deque<std::shared_ptr<Job>> ready_;
+    size_t size_ = 0;
+    mutable uint64_t next_event_ = kNoTick;  // cached result of scanNextEventTick()
+};
+
+}
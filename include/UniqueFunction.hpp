@@ -0,0 +1,182 @@
+/**
+ * @file UniqueFunction.hpp
+ * @brief Defines a move-only callable wrapper with inline storage for small targets.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace scheduleit {
+
+template <class Signature>
+class UniqueFunction;
+
+/**
+ * @class UniqueFunction
+ * @brief Move-only replacement for std::function.
+ *
+ * Targets of up to kInlineSize bytes that are nothrow-movable live inside the object itself, so
+ * wrapping a typical lambda does not allocate; larger targets are moved to the heap. Because
+ * the wrapper is never copied, targets may own move-only state such as std::unique_ptr or
+ * std::packaged_task. Like std::function, calling through a const wrapper invokes the target
+ * as non-const.
+ */
+template <class R, class... Args>
+class UniqueFunction<R(Args...)> {
+public:
+    static constexpr size_t kInlineSize = 48;
+
+    UniqueFunction() noexcept = default;
+    UniqueFunction(std::nullptr_t) noexcept {}
+
+    template <class F,
+              class Target = std::decay_t<F>,
+              class = std::enable_if_t<!std::is_same<Target, UniqueFunction>::value &&
+                                       std::is_invocable_r<R, Target&, Args...>::value>>
+    UniqueFunction(F&& f) {
+        if (isEmptyTarget(f)) {
+            return;
+        }
+        if constexpr (storedInline<Target>()) {
+            ::new (static_cast<void*>(storage_)) Target(std::forward<F>(f));
+            ops_ = &InlineOps<Target>::kOps;
+        } else {
+            ::new (static_cast<void*>(storage_)) Target*(new Target(std::forward<F>(f)));
+            ops_ = &HeapOps<Target>::kOps;
+        }
+    }
+
+    UniqueFunction(UniqueFunction&& other) noexcept {
+        takeFrom(other);
+    }
+
+    UniqueFunction& operator=(UniqueFunction&& other) noexcept {
+        if (this != &other) {
+            reset();
+            takeFrom(other);
+        }
+        return *this;
+    }
+
+    UniqueFunction& operator=(std::nullptr_t) noexcept {
+        reset();
+        return *this;
+    }
+
+    UniqueFunction(const UniqueFunction&) = delete;
+    UniqueFunction& operator=(const UniqueFunction&) = delete;
+
+    ~UniqueFunction() {
+        reset();
+    }
+
+    explicit operator bool() const noexcept {
+        return ops_ != nullptr;
+    }
+
+    /**
+     * @brief Invokes the target.
+     * @throws std::bad_function_call if the wrapper is empty.
+     */
+    R operator()(Args... args) const {
+        if (!ops_) {
+            throw std::bad_function_call();
+        }
+        return ops_->invoke(const_cast<unsigned char*>(storage_), std::forward<Args>(args)...);
+    }
+
+private:
+    struct Ops {
+        R (*invoke)(void* storage, Args&&... args);
+        void (*relocate)(void* from, void* to) noexcept;  // move-constructs into `to`, destroys `from`
+        void (*destroy)(void* storage) noexcept;
+    };
+
+    template <class Target>
+    static constexpr bool storedInline() {
+        return sizeof(Target) <= kInlineSize && alignof(Target) <= alignof(std::max_align_t) &&
+               std::is_nothrow_move_constructible<Target>::value;
+    }
+
+    template <class Target>
+    static R call(Target& target, Args&&... args) {
+        if constexpr (std::is_void<R>::value) {
+            std::invoke(target, std::forward<Args>(args)...);
+        } else {
+            return std::invoke(target, std::forward<Args>(args)...);
+        }
+    }
+
+    template <class Target>
+    struct InlineOps {
+        static R invoke(void* storage, Args&&... args) {
+            return call(*static_cast<Target*>(storage), std::forward<Args>(args)...);
+        }
+        static void relocate(void* from, void* to) noexcept {
+            auto* source = static_cast<Target*>(from);
+            ::new (to) Target(std::move(*source));
+            source->~Target();
+        }
+        static void destroy(void* storage) noexcept {
+            static_cast<Target*>(storage)->~Target();
+        }
+        static constexpr Ops kOps{&invoke, &relocate, &destroy};
+    };
+
+    template <class Target>
+    struct HeapOps {
+        static R invoke(void* storage, Args&&... args) {
+            return call(**static_cast<Target**>(storage), std::forward<Args>(args)...);
+        }
+        static void relocate(void* from, void* to) noexcept {
+            ::new (to) Target*(*static_cast<Target**>(from));
+        }
+        static void destroy(void* storage) noexcept {
+            delete *static_cast<Target**>(storage);
+        }
+        static constexpr Ops kOps{&invoke, &relocate, &destroy};
+    };
+
+    template <class T>
+    struct IsStdFunction : std::false_type {};
+    template <class S>
+    struct IsStdFunction<std::function<S>> : std::true_type {};
+
+    // Null function pointers and empty std::functions produce an empty wrapper, as they would
+    // for std::function.
+    template <class F>
+    static bool isEmptyTarget(const F& f) {
+        if constexpr (std::is_pointer<F>::value || std::is_member_pointer<F>::value) {
+            return f == nullptr;
+        } else if constexpr (IsStdFunction<F>::value) {
+            return !f;
+        } else {
+            return false;
+        }
+    }
+
+    void takeFrom(UniqueFunction& other) noexcept {
+        if (other.ops_) {
+            other.ops_->relocate(other.storage_, storage_);
+            ops_ = other.ops_;
+            other.ops_ = nullptr;
+        }
+    }
+
+    void reset() noexcept {
+        if (ops_) {
+            ops_->destroy(storage_);
+            ops_ = nullptr;
+        }
+    }
+
+    alignas(std::max_align_t) unsigned char storage_[kInlineSize];
+    const Ops* ops_ = nullptr;
+};
+
+}
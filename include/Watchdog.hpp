@@ -0,0 +1,94 @@
+/**
+ * @file Watchdog.hpp
+ * @brief Declares the Watchdog, one shared thread that times out work past its deadline.
+ */
+
+#pragma once
+
+#include "CancellationToken.hpp"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace scheduleit {
+
+/**
+ * @class Watchdog
+ * @brief Cancels a CancellationState with reason TimedOut once its deadline passes.
+ *
+ * Deadlines sit in a min-heap ordered by time; the thread sleeps until the earliest one.
+ * Work that ends in time calls CancellationState::finish(), which is all it takes to disarm
+ * it: the heap entry becomes stale and is dropped when it reaches the top, or earlier when
+ * stale entries pile up. Watching costs one lock and a heap push, never a thread.
+ */
+class Watchdog {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    /**
+     * @brief Returns the process-wide watchdog shared by every ThreadPool and JobExecutor.
+     *
+     * Its thread starts on first use and is joined at exit.
+     */
+    static Watchdog& instance();
+
+    Watchdog();
+    ~Watchdog();
+
+    Watchdog(const Watchdog&) = delete;
+    Watchdog& operator=(const Watchdog&) = delete;
+
+    /**
+     * @brief Times the state out at the deadline unless it has finished or been cancelled.
+     * @param state State of work that is about to start or has started.
+     * @param deadline When the work overruns.
+     * @param on_expire Run on the watchdog thread right after a timeout, e.g. to report it;
+     *                  dropped unrun if the state ends first. Must not block for long.
+     */
+    void watch(const std::shared_ptr<CancellationState>& state, Clock::time_point deadline,
+               CancellationState::ExpiryCallback on_expire = nullptr);
+
+    /**
+     * @brief Returns the number of states this watchdog has timed out.
+     */
+    uint64_t getExpiredCount() const {
+        return expired_.load();
+    }
+
+    /**
+     * @brief Returns the number of heap entries, including stale ones not yet dropped.
+     */
+    size_t getWatchedCount() const;
+
+private:
+    struct Entry {
+        Clock::time_point deadline;
+        std::shared_ptr<CancellationState> state;
+    };
+
+    /// Puts the earliest deadline on top of the heap.
+    struct Later {
+        bool operator()(const Entry& a, const Entry& b) const {
+            return a.deadline > b.deadline;
+        }
+    };
+
+    void run();
+    /// Drops entries whose state has already ended; called with the lock held.
+    void compact();
+
+    mutable std::mutex mutex_;
+    std::condition_variable cv_;
+    std::vector<Entry> heap_;  // min-heap by deadline
+    size_t compact_at_ = 1024;  // heap size at which stale entries are swept
+    bool stopping_ = false;
+    std::atomic<uint64_t> expired_{0};
+    std::thread thread_;
+};
+
+}
@@ -0,0 +1,147 @@
+/**
+ * @file WorkStealingDeque.hpp
+ * @brief Defines a Chase-Lev work-stealing deque.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+namespace scheduleit {
+
+/**
+ * @class WorkStealingDeque
+ * @brief Lock-free single-owner deque (Chase-Lev, with the C11 orderings of Le et al.).
+ *
+ * The owning thread pushes and pops at the bottom in LIFO order; any other thread may steal
+ * from the top in FIFO order. The buffer grows on demand. Old buffers are kept until the deque
+ * is destroyed because a concurrent thief may still be reading them.
+ *
+ * @tparam T A trivially copyable element type, typically a pointer.
+ */
+template <class T>
+class WorkStealingDeque {
+    static_assert(std::is_trivially_copyable<T>::value, "WorkStealingDeque stores raw values");
+
+public:
+    /**
+     * @brief Constructor.
+     * @param capacity Initial capacity; must be a power of two.
+     */
+    explicit WorkStealingDeque(int64_t capacity = 256) {
+        buffers_.push_back(std::make_unique<Buffer>(capacity));
+        buffer_.store(buffers_.back().get(), std::memory_order_relaxed);
+    }
+
+    WorkStealingDeque(const WorkStealingDeque&) = delete;
+    WorkStealingDeque& operator=(const WorkStealingDeque&) = delete;
+
+    /**
+     * @brief Pushes an item at the bottom. Owner thread only.
+     */
+    void push(T item) {
+        int64_t bottom = bottom_.load(std::memory_order_relaxed);
+        int64_t top = top_.load(std::memory_order_acquire);
+        Buffer* buffer = buffer_.load(std::memory_order_relaxed);
+        if (bottom - top > buffer->capacity - 1) {
+            buffer = grow(buffer, top, bottom);
+        }
+        buffer->put(bottom, item);
+        bottom_.store(bottom + 1, std::memory_order_release);
+    }
+
+    /**
+     * @brief Pops the most recently pushed item. Owner thread only.
+     * @return True if an item was taken.
+     */
+    bool pop(T& out) {
+        int64_t bottom = bottom_.load(std::memory_order_relaxed) - 1;
+        Buffer* buffer = buffer_.load(std::memory_order_relaxed);
+        bottom_.store(bottom, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t top = top_.load(std::memory_order_relaxed);
+
+        if (top > bottom) {
+            bottom_.store(bottom + 1, std::memory_order_relaxed);
+            return false;
+        }
+        out = buffer->get(bottom);
+        if (top == bottom) {
+            // Last item: race against thieves for it.
+            bool won = top_.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst,
+                                                    std::memory_order_relaxed);
+            bottom_.store(bottom + 1, std::memory_order_relaxed);
+            return won;
+        }
+        return true;
+    }
+
+    /**
+     * @brief Steals the oldest item. Safe from any thread.
+     * @return True if an item was taken.
+     */
+    bool steal(T& out) {
+        int64_t top = top_.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t bottom = bottom_.load(std::memory_order_acquire);
+        if (top >= bottom) {
+            return false;
+        }
+        Buffer* buffer = buffer_.load(std::memory_order_acquire);
+        T item = buffer->get(top);
+        if (!top_.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst,
+                                          std::memory_order_relaxed)) {
+            return false;
+        }
+        out = item;
+        return true;
+    }
+
+    /**
+     * @brief Returns an approximate item count.
+     */
+    int64_t sizeApprox() const {
+        int64_t size = bottom_.load(std::memory_order_relaxed) - top_.load(std::memory_order_relaxed);
+        return size > 0 ? size : 0;
+    }
+
+private:
+    struct Buffer {
+        explicit Buffer(int64_t cap)
+            : capacity(cap), mask(cap - 1), slots(new std::atomic<T>[static_cast<size_t>(cap)]) {}
+
+        T get(int64_t index) const {
+            return slots[index & mask].load(std::memory_order_relaxed);
+        }
+
+        void put(int64_t index, T item) {
+            slots[index & mask].store(item, std::memory_order_relaxed);
+        }
+
+        int64_t capacity;
+        int64_t mask;
+        std::unique_ptr<std::atomic<T>[]> slots;
+    };
+
+    Buffer* grow(Buffer* old, int64_t top, int64_t bottom) {
+        auto bigger = std::make_unique<Buffer>(old->capacity * 2);
+        for (int64_t i = top; i < bottom; ++i) {
+            bigger->put(i, old->get(i));
+        }
+        Buffer* raw = bigger.get();
+        buffers_.push_back(std::move(bigger));
+        buffer_.store(raw, std::memory_order_release);
+        return raw;
+    }
+
+    alignas(64) std::atomic<int64_t> top_{0};
+    alignas(64) std::atomic<int64_t> bottom_{0};
+    alignas(64) std::atomic<Buffer*> buffer_{nullptr};
+    std::vector<std::unique_ptr<Buffer>> buffers_;  // owner-only; retired buffers stay alive
+};
+
+}
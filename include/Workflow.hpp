@@ -0,0 +1,152 @@
+/**
+ * @file Workflow.hpp
+ * @brief Declares Workflow, a C++20 coroutine that runs as a job and suspends without a thread.
+ *
+ * Only available when built as C++20 (configure with -DSCHEDULEIT_CXX20=ON).
+ */
+
+#pragma once
+
+#if !defined(__cpp_impl_coroutine)
+#error "Workflow.hpp needs C++20 coroutines; configure with -DSCHEDULEIT_CXX20=ON"
+#endif
+
+#include "Job.hpp"
+#include "JobHandle.hpp"
+#include "JobScheduler.hpp"
+#include <chrono>
+#include <coroutine>
+#include <exception>
+#include <memory>
+#include <string>
+
+namespace scheduleit {
+
+/**
+ * @class Workflow
+ * @brief A job written as a coroutine: do a step, wait, do the next step.
+ *
+ * A function returning Workflow is a coroutine. It does not start when called; intoJob()
+ * turns it into a Job that is submitted like any other. Each time the job runs it resumes
+ * the coroutine up to its next co_await:
+ *
+ *     Workflow poll(JobScheduler& scheduler) {
+ *         while (!ready()) {
+ *             co_await scheduler.sleep(std::chrono::milliseconds(50));
+ *         }
+ *         bool ok = co_await scheduler.submit(cleanup(scheduler).intoJob());
+ *     }
+ *
+ * - `co_await scheduler.sleep(d)` puts the job back into the time-ordered queue for d.
+ * - `co_await job` (a std::shared_ptr<Job> or JobHandle) parks the job outside the queue
+ *   until the other job finishes, and yields true if it succeeded. The other job must have
+ *   been or be going to be submitted; a workflow parked on a job that never finishes is leaked.
+ *
+ * Either way the worker returns to the queue at once, so a few threads can keep a very large
+ * number of workflows in flight. A sleeping workflow can be cancelled like a queued job,
+ * which destroys the coroutine; a parked one cannot. Observers hear about a workflow only
+ * once it returns or throws. A workflow is never retried, since a coroutine cannot be rerun.
+ */
+class Workflow {
+public:
+    class SleepAwaiter {
+    public:
+        explicit SleepAwaiter(std::chrono::nanoseconds duration) : duration_(duration) {}
+
+        bool await_ready() const noexcept {
+            return duration_ <= std::chrono::nanoseconds::zero();
+        }
+
+        void await_suspend(std::coroutine_handle<>) const {
+            Job::current()->suspendFor(duration_);
+        }
+
+        void await_resume() const noexcept {}
+
+    private:
+        std::chrono::nanoseconds duration_;
+    };
+
+    class JobAwaiter final : private CompletionWaiter {
+    public:
+        explicit JobAwaiter(std::shared_ptr<Job> job) : job_(std::move(job)) {}
+
+        bool await_ready() const noexcept {
+            return !job_;
+        }
+
+        bool await_suspend(std::coroutine_handle<>);
+
+        /// Returns true if the awaited job succeeded.
+        bool await_resume() const noexcept {
+            return succeeded_;
+        }
+
+    private:
+        void onJobCompleted(bool succeeded) override;
+
+        std::shared_ptr<Job> job_;
+        Job* self_ = nullptr;  // the awaiting workflow's job
+        bool succeeded_ = false;
+    };
+
+    struct promise_type {
+        Workflow get_return_object() noexcept {
+            return Workflow(std::coroutine_handle<promise_type>::from_promise(*this));
+        }
+
+        std::suspend_always initial_suspend() noexcept {
+            return {};
+        }
+
+        std::suspend_always final_suspend() noexcept {
+            return {};
+        }
+
+        void return_void() noexcept {}
+
+        void unhandled_exception() noexcept {
+            exception = std::current_exception();
+        }
+
+        SleepAwaiter await_transform(SleepAwaitable sleep) const noexcept {
+            return SleepAwaiter(sleep.duration);
+        }
+
+        JobAwaiter await_transform(std::shared_ptr<Job> job) const noexcept {
+            return JobAwaiter(std::move(job));
+        }
+
+        JobAwaiter await_transform(JobHandle handle) const noexcept {
+            return JobAwaiter(handle.getJob());
+        }
+
+        std::exception_ptr exception;
+    };
+
+    Workflow(Workflow&& other) noexcept;
+    Workflow& operator=(Workflow&& other) noexcept;
+    ~Workflow();
+
+    Workflow(const Workflow&) = delete;
+    Workflow& operator=(const Workflow&) = delete;
+
+    /**
+     * @brief Wraps the coroutine in a job with no retries, ready to submit.
+     * @param id Job id; several workflows may share one.
+     * @throws std::runtime_error if the workflow was already moved into a job.
+     */
+    std::shared_ptr<Job> intoJob(std::string id = "") &&;
+
+private:
+    class Step;
+
+    explicit Workflow(std::coroutine_handle<promise_type> handle) : handle_(handle) {}
+
+    /// Runs the coroutine up to its next suspension; rethrows its exception once it ends.
+    void resume() const;
+
+    std::coroutine_handle<promise_type> handle_;
+};
+
+}
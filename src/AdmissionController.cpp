@@ -0,0 +1,243 @@
+/**
+ * @file AdmissionController.cpp
+ * @brief Implements the AdmissionController class.
+ */
+
+#include "AdmissionController.hpp"
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+
+namespace scheduleit {
+
+AdmissionController::AdmissionController(AdmissionOptions options, std::shared_ptr<CompletionTracker> tracker,
+                                         CancelFunction cancel)
+    : options_(std::move(options)), tracker_(std::move(tracker)), cancel_(std::move(cancel)) {
+    if (!(options_.elevated_at > 0 && options_.elevated_at <= 1)) {
+        throw std::invalid_argument("Admission elevated_at must be in (0, 1]");
+    }
+    auto now = std::chrono::steady_clock::now();
+    for (const auto& [tag, limit] : options_.rate_limits) {
+        if (!(limit.jobs_per_second > 0) || !(limit.burst >= 1)) {
+            throw std::invalid_argument("Rate limit for tag '" + tag + "' needs a positive rate and a burst of at least 1");
+        }
+        auto bucket = std::make_unique<TokenBucket>();
+        bucket->limit = limit;
+        bucket->tokens = limit.burst;
+        bucket->refilled = now;
+        buckets_.emplace(tag, std::move(bucket));
+    }
+}
+
+SubmitStatus AdmissionController::admit(const Job& job, bool may_wait) {
+    Deadline deadline = deadlineFor(may_wait);
+    bool waited = false;
+    SubmitStatus status = SubmitStatus::Accepted;
+    if (!takeToken(job, deadline, waited)) {
+        rate_limited_++;
+        status = SubmitStatus::RateLimited;
+    } else if (reserve(1, job.getPriority(), deadline, waited) == 0) {
+        refundToken(job);
+        rejected_++;
+        status = SubmitStatus::Full;
+    } else {
+        accepted_++;
+    }
+    if (waited) {
+        blocked_++;
+    }
+    return status;
+}
+
+size_t AdmissionController::admitBatch(std::vector<std::shared_ptr<Job>>& jobs,
+                                       const std::function<void(std::vector<std::shared_ptr<Job>>&)>& accept) {
+    Deadline deadline = deadlineFor(true);
+    bool waited = false;
+    if (!buckets_.empty()) {
+        auto limited = std::remove_if(jobs.begin(), jobs.end(), [&](const std::shared_ptr<Job>& job) {
+            return !takeToken(*job, deadline, waited);
+        });
+        rate_limited_ += static_cast<uint64_t>(jobs.end() - limited);
+        jobs.erase(limited, jobs.end());
+    }
+
+    size_t accepted = 0;
+    size_t next = 0;
+    while (next < jobs.size()) {
+        size_t taken = reserve(jobs.size() - next, jobs[next]->getPriority(), deadline, waited);
+        if (taken == 0) {
+            // Shedding depends on each job's priority, so a later job may still get in.
+            size_t turned_away = options_.policy == OverloadPolicy::ShedLowestPriority ? 1 : jobs.size() - next;
+            for (size_t i = next; i < next + turned_away; ++i) {
+                refundToken(*jobs[i]);
+            }
+            rejected_ += turned_away;
+            next += turned_away;
+            continue;
+        }
+        if (next == 0 && taken == jobs.size()) {
+            accept(jobs);
+        } else {
+            std::vector<std::shared_ptr<Job>> run(jobs.begin() + next, jobs.begin() + next + taken);
+            accept(run);
+        }
+        next += taken;
+        accepted += taken;
+    }
+    accepted_ += accepted;
+    if (waited) {
+        blocked_++;
+    }
+    return accepted;
+}
+
+void AdmissionController::onQueued(const std::shared_ptr<Job>& job) {
+    if (job->isRecurring()) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(shed_mutex_);
+    auto& candidates = candidates_[static_cast<size_t>(job->getPriority())];
+    // At most max_pending candidates can still be queued; sweep out the rest as they pile up.
+    if (candidates.size() >= 2 * options_.max_pending) {
+        candidates.erase(std::remove_if(candidates.begin(), candidates.end(),
+                                        [](const std::weak_ptr<Job>& entry) {
+                                            auto queued = entry.lock();
+                                            return !queued || queued->getState() != JobState::Queued;
+                                        }),
+                         candidates.end());
+    }
+    candidates.push_back(job);
+}
+
+QueuePressure AdmissionController::getPressure() const {
+    QueuePressure pressure;
+    pressure.outstanding = tracker_->getOutstandingCount();
+    pressure.capacity = options_.max_pending;
+    if (pressure.capacity > 0) {
+        pressure.utilization = static_cast<double>(pressure.outstanding) / pressure.capacity;
+        if (pressure.outstanding >= pressure.capacity) {
+            pressure.level = PressureLevel::Saturated;
+        } else if (pressure.utilization >= options_.elevated_at) {
+            pressure.level = PressureLevel::Elevated;
+        }
+    }
+    pressure.blocked_submitters = blocked_submitters_.load();
+    pressure.accepted = accepted_.load();
+    pressure.rejected = rejected_.load();
+    pressure.rate_limited = rate_limited_.load();
+    pressure.shed = shed_.load();
+    pressure.blocked = blocked_.load();
+    return pressure;
+}
+
+AdmissionController::Deadline AdmissionController::deadlineFor(bool may_wait) const {
+    auto now = std::chrono::steady_clock::now();
+    if (!may_wait || options_.policy != OverloadPolicy::Block) {
+        return now;
+    }
+    if (options_.max_block >= std::chrono::duration_cast<std::chrono::milliseconds>(Deadline::max() - now)) {
+        return Deadline::max();
+    }
+    return now + options_.max_block;
+}
+
+AdmissionController::TokenBucket* AdmissionController::bucketFor(const Job& job) const {
+    if (buckets_.empty() || job.getTag().empty()) {
+        return nullptr;
+    }
+    auto it = buckets_.find(job.getTag());
+    return it == buckets_.end() ? nullptr : it->second.get();
+}
+
+bool AdmissionController::takeToken(const Job& job, Deadline deadline, bool& waited) {
+    TokenBucket* bucket = bucketFor(job);
+    if (!bucket) {
+        return true;
+    }
+    while (true) {
+        auto now = std::chrono::steady_clock::now();
+        std::chrono::nanoseconds wait;
+        {
+            std::lock_guard<std::mutex> lock(bucket->mutex);
+            double elapsed = std::chrono::duration<double>(now - bucket->refilled).count();
+            if (elapsed > 0) {
+                bucket->tokens = std::min(bucket->limit.burst, bucket->tokens + elapsed * bucket->limit.jobs_per_second);
+                bucket->refilled = now;
+            }
+            if (bucket->tokens >= 1) {
+                bucket->tokens -= 1;
+                return true;
+            }
+            wait = std::chrono::nanoseconds(
+                static_cast<int64_t>((1 - bucket->tokens) / bucket->limit.jobs_per_second * 1e9) + 1);
+        }
+        if (deadline - now < wait) {
+            return false;
+        }
+        waited = true;
+        blocked_submitters_++;
+        std::this_thread::sleep_for(wait);
+        blocked_submitters_--;
+    }
+}
+
+void AdmissionController::refundToken(const Job& job) {
+    if (TokenBucket* bucket = bucketFor(job)) {
+        std::lock_guard<std::mutex> lock(bucket->mutex);
+        bucket->tokens = std::min(bucket->limit.burst, bucket->tokens + 1);
+    }
+}
+
+size_t AdmissionController::reserve(size_t count, JobPriority priority, Deadline deadline, bool& waited) {
+    size_t limit = options_.max_pending > 0 ? options_.max_pending : std::numeric_limits<size_t>::max();
+    if (size_t taken = tracker_->reserve(count, limit)) {
+        return taken;
+    }
+    if (options_.policy == OverloadPolicy::ShedLowestPriority) {
+        // Another submitter may take the freed slot first; then shed again.
+        while (shedBelow(priority)) {
+            if (size_t taken = tracker_->reserve(count, limit)) {
+                return taken;
+            }
+        }
+        return 0;
+    }
+    auto now = std::chrono::steady_clock::now();
+    if (deadline <= now) {
+        return 0;
+    }
+    auto timeout = deadline == Deadline::max()
+                       ? std::chrono::milliseconds::max()
+                       : std::chrono::ceil<std::chrono::milliseconds>(deadline - now);
+    waited = true;
+    blocked_submitters_++;
+    size_t taken = tracker_->waitToReserve(count, limit, timeout);
+    blocked_submitters_--;
+    return taken;
+}
+
+bool AdmissionController::shedBelow(JobPriority priority) {
+    for (size_t cls = kJobPriorityCount; cls-- > static_cast<size_t>(priority) + 1;) {
+        while (true) {
+            std::shared_ptr<Job> victim;
+            {
+                std::lock_guard<std::mutex> lock(shed_mutex_);
+                auto& candidates = candidates_[cls];
+                if (candidates.empty()) {
+                    break;
+                }
+                victim = candidates.back().lock();
+                candidates.pop_back();
+            }
+            if (victim && victim->getState() == JobState::Queued && cancel_(victim)) {
+                shed_++;
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+}
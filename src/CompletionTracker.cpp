@@ -0,0 +1,121 @@
+/**
+ * @file CompletionTracker.cpp
+ * @brief Implements the CompletionTracker class.
+ */
+
+#include "CompletionTracker.hpp"
+#include <algorithm>
+
+namespace scheduleit {
+
+void CompletionTracker::addId(const std::string& id) {
+    IdShard& shard = shardFor(id);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    ++shard.counts[id];
+}
+
+void CompletionTracker::onSubmitted(const Job& job, bool reserved) {
+    if (!job.getId().empty()) {
+        addId(job.getId());
+    }
+    if (!reserved) {
+        outstanding_.fetch_add(1);
+    }
+}
+
+void CompletionTracker::onSubmittedBatch(const std::vector<std::shared_ptr<Job>>& jobs, bool reserved) {
+    for (const auto& job : jobs) {
+        if (!job->getId().empty()) {
+            addId(job->getId());
+        }
+    }
+    if (!reserved) {
+        outstanding_.fetch_add(jobs.size());
+    }
+}
+
+size_t CompletionTracker::reserve(size_t count, size_t limit) {
+    size_t current = outstanding_.load();
+    size_t taken;
+    do {
+        if (current >= limit) {
+            return 0;
+        }
+        taken = std::min(count, limit - current);
+    } while (!outstanding_.compare_exchange_weak(current, current + taken));
+    return taken;
+}
+
+size_t CompletionTracker::waitToReserve(size_t count, size_t limit, std::chrono::milliseconds timeout) {
+    if (size_t taken = reserve(count, limit)) {
+        return taken;
+    }
+    std::unique_lock<std::mutex> lock(mutex_);
+    // Registering before the predicate check pairs with onCompleted() decrementing before it
+    // reads capacity_waiters_: one of the two sees the other.
+    capacity_waiters_.fetch_add(1);
+    size_t taken = 0;
+    waitUntil(lock, timeout, [&]() {
+        taken = reserve(count, limit);
+        return taken > 0;
+    });
+    capacity_waiters_.fetch_sub(1);
+    return taken;
+}
+
+void CompletionTracker::onCompleted(const Job& job) {
+    bool notify = false;
+    if (!job.getId().empty()) {
+        IdShard& shard = shardFor(job.getId());
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        auto it = shard.counts.find(job.getId());
+        if (it != shard.counts.end() && --it->second == 0) {
+            shard.counts.erase(it);
+            // A waiter registers before it checks this shard under the same lock: if it
+            // checked before the erase, it is counted here.
+            notify = id_waiters_.load() > 0;
+        }
+    }
+    if (outstanding_.fetch_sub(1) == 1 || capacity_waiters_.load() > 0) {
+        notify = true;
+    }
+    if (notify) {
+        // Taking the lock orders this notification after a waiter's predicate check.
+        { std::lock_guard<std::mutex> lock(mutex_); }
+        cv_.notify_all();
+    }
+}
+
+bool CompletionTracker::waitForIdle(std::chrono::milliseconds timeout) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    return waitUntil(lock, timeout, [this]() { return outstanding_.load() == 0; });
+}
+
+bool CompletionTracker::waitForJobs(const std::vector<std::string>& ids, std::chrono::milliseconds timeout) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    id_waiters_.fetch_add(1);
+    bool done = waitUntil(lock, timeout, [this, &ids]() {
+        for (const auto& id : ids) {
+            IdShard& shard = shardFor(id);
+            std::lock_guard<std::mutex> shard_lock(shard.mutex);
+            if (shard.counts.count(id) > 0) {
+                return false;
+            }
+        }
+        return true;
+    });
+    id_waiters_.fetch_sub(1);
+    return done;
+}
+
+template <class Predicate>
+bool CompletionTracker::waitUntil(std::unique_lock<std::mutex>& lock, std::chrono::milliseconds timeout,
+                                  Predicate done) {
+    if (timeout == std::chrono::milliseconds::max()) {
+        cv_.wait(lock, done);
+        return true;
+    }
+    return cv_.wait_for(lock, timeout, done);
+}
+
+}
@@ -0,0 +1,159 @@
+/**
+ * @file CpuTopology.cpp
+ * @brief Implements the CpuTopology class.
+ */
+
+#include "CpuTopology.hpp"
+#include <algorithm>
+#include <fstream>
+#include <stdexcept>
+#include <thread>
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace scheduleit {
+
+namespace {
+
+bool readLine(const std::string& path, std::string& line) {
+    std::ifstream in(path);
+    return in && std::getline(in, line) && !line.empty();
+}
+
+int parseCpu(const std::string& text) {
+    if (text.empty() || text.find_first_not_of("0123456789") != std::string::npos) {
+        throw std::invalid_argument("Invalid CPU list entry: '" + text + "'");
+    }
+    return std::stoi(text);
+}
+
+}
+
+CpuTopology::CpuTopology(std::vector<std::vector<int>> nodes) {
+    for (size_t id = 0; id < nodes.size(); ++id) {
+        if (!nodes[id].empty()) {
+            nodes_.push_back(std::move(nodes[id]));
+            node_ids_.push_back(id);
+        }
+    }
+    if (nodes_.empty()) {
+        throw std::invalid_argument("CpuTopology needs at least one CPU");
+    }
+}
+
+CpuTopology CpuTopology::detect() {
+    // Indexed by kernel node id, so that ids survive the constructor dropping empty nodes.
+    std::vector<std::vector<int>> nodes;
+    std::string line;
+    // Node ids can have gaps; stop after a run of missing ones.
+    for (int node = 0, missing = 0; missing < 8; ++node) {
+        nodes.emplace_back();
+        if (!readLine("/sys/devices/system/node/node" + std::to_string(node) + "/cpulist", line)) {
+            ++missing;
+            continue;
+        }
+        missing = 0;
+        try {
+            nodes.back() = parseCpuList(line);
+        } catch (const std::invalid_argument&) {
+            // A node without CPUs (memory only) reads as an empty line; leave anything odd empty.
+        }
+    }
+    for (const auto& cpus : nodes) {
+        if (!cpus.empty()) {
+            return CpuTopology(std::move(nodes));
+        }
+    }
+    if (readLine("/sys/devices/system/cpu/online", line)) {
+        try {
+            return fromCpuList(line);
+        } catch (const std::invalid_argument&) {
+        }
+    }
+    return simulated(1, std::max(1u, std::thread::hardware_concurrency()));
+}
+
+CpuTopology CpuTopology::fromCpuList(const std::string& cpu_list) {
+    return CpuTopology({parseCpuList(cpu_list)});
+}
+
+CpuTopology CpuTopology::simulated(size_t nodes, size_t cpus_per_node) {
+    if (nodes == 0 || cpus_per_node == 0) {
+        throw std::invalid_argument("Simulated topology needs nodes and CPUs");
+    }
+    std::vector<std::vector<int>> layout(nodes);
+    for (size_t node = 0; node < nodes; ++node) {
+        for (size_t cpu = 0; cpu < cpus_per_node; ++cpu) {
+            layout[node].push_back(static_cast<int>(node * cpus_per_node + cpu));
+        }
+    }
+    return CpuTopology(std::move(layout));
+}
+
+std::vector<int> CpuTopology::parseCpuList(const std::string& cpu_list) {
+    std::vector<int> cpus;
+    size_t begin = 0;
+    while (begin <= cpu_list.size()) {
+        size_t end = cpu_list.find(',', begin);
+        if (end == std::string::npos) {
+            end = cpu_list.size();
+        }
+        std::string item = cpu_list.substr(begin, end - begin);
+        while (!item.empty() && (item.back() == '\n' || item.back() == ' ')) {
+            item.pop_back();
+        }
+        size_t dash = item.find('-');
+        if (dash == std::string::npos) {
+            cpus.push_back(parseCpu(item));
+        } else {
+            int first = parseCpu(item.substr(0, dash));
+            int last = parseCpu(item.substr(dash + 1));
+            if (last < first) {
+                throw std::invalid_argument("Invalid CPU range: '" + item + "'");
+            }
+            for (int cpu = first; cpu <= last; ++cpu) {
+                cpus.push_back(cpu);
+            }
+        }
+        begin = end + 1;
+    }
+    return cpus;
+}
+
+size_t CpuTopology::findNode(size_t node_id) const {
+    auto it = std::lower_bound(node_ids_.begin(), node_ids_.end(), node_id);
+    return it != node_ids_.end() && *it == node_id ? static_cast<size_t>(it - node_ids_.begin()) : kAnyNode;
+}
+
+size_t CpuTopology::getCpuCount() const {
+    size_t count = 0;
+    for (const auto& cpus : nodes_) {
+        count += cpus.size();
+    }
+    return count;
+}
+
+int CpuTopology::getCpuForWorker(size_t worker) const {
+    const auto& cpus = nodes_[worker % nodes_.size()];
+    return cpus[(worker / nodes_.size()) % cpus.size()];
+}
+
+bool CpuTopology::pinCurrentThread(int cpu) {
+#if defined(__linux__)
+    if (cpu < 0 || cpu >= CPU_SETSIZE) {
+        return false;
+    }
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+#else
+    (void)cpu;
+    return false;
+#endif
+}
+
+}
@@ -17,7 +17,7 @@ bool ExponentialBackoffStrategy::shouldRetry(int attempt) const {
 }
 
 std::chrono::milliseconds ExponentialBackoffStrategy::getBackoffDelay(int attempt) const {
-    auto delay = base_delay_.count() * (1LL << attempt);  // exponential backoff
+    auto delay = base_delay_.count() * (std::chrono::milliseconds::rep{1} << attempt);  // exponential backoff
     return std::chrono::milliseconds(std::min(delay, max_delay_.count()));
 }
 
@@ -0,0 +1,71 @@
+/**
+ * @file HeapJobStore.cpp
+ * @brief Implements the HeapJobStore class.
+ */
+
+#include "HeapJobStore.hpp"
+#include <algorithm>
+
+namespace scheduleit {
+
+void HeapJobStore::push(std::shared_ptr<Job> job) {
+    auto time = job->getScheduledTime();
+    heap_.push_back(Entry{time, std::move(job)});
+    std::push_heap(heap_.begin(), heap_.end(), CompareEntry());
+}
+
+void HeapJobStore::pushBatch(std::vector<std::shared_ptr<Job>>& jobs) {
+    size_t old_size = heap_.size();
+    for (auto& job : jobs) {
+        auto time = job->getScheduledTime();
+        heap_.push_back(Entry{time, std::move(job)});
+    }
+
+    // Sifting k jobs up costs up to k * log2(n); a rebuild costs about 2n.
+    size_t log_n = 1;
+    while ((size_t{1} << log_n) < heap_.size()) {
+        ++log_n;
+    }
+    if (jobs.size() * log_n > 2 * heap_.size()) {
+        std::make_heap(heap_.begin(), heap_.end(), CompareEntry());
+        return;
+    }
+    for (size_t end = old_size + 1; end <= heap_.size(); ++end) {
+        std::push_heap(heap_.begin(), heap_.begin() + static_cast<std::ptrdiff_t>(end), CompareEntry());
+    }
+}
+
+std::shared_ptr<Job> HeapJobStore::popReady(Job::TimePoint now) {
+    if (heap_.empty() || heap_.front().time > now) {
+        return nullptr;
+    }
+    std::pop_heap(heap_.begin(), heap_.end(), CompareEntry());
+    auto job = std::move(heap_.back().job);
+    heap_.pop_back();
+    return job;
+}
+
+Job::TimePoint HeapJobStore::nextWakeTime() const {
+    return heap_.front().time;
+}
+
+void HeapJobStore::removeStale(std::vector<std::shared_ptr<Job>>& removed) {
+    // The entry's copy of the time tells a moved job's old entry from its current one.
+    auto live_end = std::partition(heap_.begin(), heap_.end(), [](const Entry& entry) {
+        return !isStale(*entry.job) && entry.time == entry.job->getScheduledTime();
+    });
+    if (live_end == heap_.end()) {
+        return;
+    }
+    for (auto it = live_end; it != heap_.end(); ++it) {
+        removed.push_back(std::move(it->job));
+    }
+    heap_.erase(live_end, heap_.end());
+    std::make_heap(heap_.begin(), heap_.end(), CompareEntry());
+}
+
+size_t HeapJobStore::size() const {
+    return heap_.size();
+}
+
+}
@@ -0,0 +1,32 @@
+/**
+ * @file JitterRetryStrategy.cpp
+ * @brief Implements the JitterRetryStrategy class.
+ */
+
+#include "JitterRetryStrategy.hpp"
+#include <algorithm>
+#include <random>
+#include <stdexcept>
+
+namespace scheduleit {
+
+JitterRetryStrategy::JitterRetryStrategy(std::shared_ptr<RetryStrategy> base, double jitter_ratio)
+    : base_(std::move(base)), jitter_ratio_(std::clamp(jitter_ratio, 0.0, 1.0)) {
+    if (!base_) {
+        throw std::invalid_argument("JitterRetryStrategy requires a base strategy");
+    }
+}
+
+bool JitterRetryStrategy::shouldRetry(int attempt) const {
+    return base_->shouldRetry(attempt);
+}
+
+std::chrono::milliseconds JitterRetryStrategy::getBackoffDelay(int attempt) const {
+    thread_local std::minstd_rand rng(std::random_device{}());
+    auto delay = base_->getBackoffDelay(attempt);
+    std::uniform_real_distribution<double> cut(0.0, jitter_ratio_);
+    auto removed = static_cast<std::chrono::milliseconds::rep>(delay.count() * cut(rng));
+    return delay - std::chrono::milliseconds(removed);
+}
+
+}
@@ -1,8 +1,20 @@
 #include "Job.hpp"
+#include "JobExecutor.hpp"
 #include "Utils.hpp"
+#include <stdexcept>
+#include <thread>
+#include <utility>
 
 namespace scheduleit {
 
+namespace {
+
+constexpr uintptr_t kWaitersClosed = 1;  // completion_waiters_ once the job has finished
+
+}
+
+thread_local Job* Job::current_ = nullptr;
+
 Job::Job(std::string id,
          Task task,
          std::shared_ptr<RetryStrategy> retry_strategy,
@@ -24,8 +36,12 @@ Job::TimePoint Job::getScheduledTime() const {
     return scheduled_time_;
 }
 
+Job::TimePoint Job::getEnqueuedTime() const {
+    return enqueued_time_.load(std::memory_order_relaxed);
+}
+
 void Job::reschedule(std::chrono::milliseconds delay) {
-    scheduled_time_ = utils::now() + delay;
+    scheduled_time_.store(utils::now() + delay);
 }
 
 void Job::execute() const {
@@ -54,4 +70,286 @@ std::shared_ptr<RetryStrategy> Job::getRetryStrategy() const {
     return retry_strategy_;
 }
 
-}
\ No newline at end of file
+void Job::setRetryHook(RetryHook hook) {
+    retry_hook_ = std::move(hook);
+}
+
+bool Job::approveRetry(int attempt) const {
+    return !retry_hook_ || retry_hook_(*this, attempt);
+}
+
+void Job::setCompletionHook(CompletionHook hook) {
+    completion_hook_ = std::move(hook);
+}
+
+void Job::notifyCompleted(bool succeeded) const {
+    if (completion_hook_) {
+        completion_hook_(*this, succeeded);
+    }
+    completed_ok_ = succeeded;
+    uintptr_t head = completion_waiters_.exchange(kWaitersClosed, std::memory_order_acq_rel);
+    while (head != 0 && head != kWaitersClosed) {
+        auto* waiter = reinterpret_cast<CompletionWaiter*>(head);
+        // The waiter may be gone once it has run.
+        head = reinterpret_cast<uintptr_t>(waiter->next_);
+        waiter->onJobCompleted(succeeded);
+    }
+}
+
+bool Job::addCompletionWaiter(CompletionWaiter* waiter) {
+    uintptr_t head = completion_waiters_.load(std::memory_order_acquire);
+    do {
+        if (head == kWaitersClosed) {
+            return false;
+        }
+        waiter->next_ = reinterpret_cast<CompletionWaiter*>(head);
+    } while (!completion_waiters_.compare_exchange_weak(head, reinterpret_cast<uintptr_t>(waiter),
+                                                        std::memory_order_release, std::memory_order_acquire));
+    return true;
+}
+
+bool Job::completedSuccessfully() const {
+    return completion_waiters_.load(std::memory_order_acquire) == kWaitersClosed && completed_ok_;
+}
+
+void Job::setTimeout(std::chrono::milliseconds timeout) {
+    if (timeout.count() < 0) {
+        throw std::invalid_argument("Job timeout must not be negative");
+    }
+    timeout_ = timeout;
+}
+
+std::chrono::milliseconds Job::getTimeout() const {
+    return timeout_;
+}
+
+void Job::setPreferredNode(size_t node) {
+    preferred_node_ = node;
+}
+
+size_t Job::getPreferredNode() const {
+    return preferred_node_;
+}
+
+void Job::setTag(std::string tag) {
+    tag_ = std::move(tag);
+}
+
+const std::string& Job::getTag() const {
+    return tag_;
+}
+
+void Job::setDeadline(TimePoint deadline, std::chrono::microseconds expected_run) {
+    deadline_ = deadline;
+    expected_run_ = expected_run;
+}
+
+Job::TimePoint Job::getDeadline() const {
+    return deadline_;
+}
+
+bool Job::hasDeadline() const {
+    return deadline_ != TimePoint::max();
+}
+
+Job::TimePoint Job::getLatestStart() const {
+    return deadline_ - expected_run_;
+}
+
+CancellationToken Job::getCancellationToken() const {
+    return CancellationToken(attempt_cancel_);
+}
+
+Job* Job::current() {
+    return current_;
+}
+
+void Job::suspendFor(std::chrono::nanoseconds delay) {
+    scheduled_time_.store(utils::now() + std::chrono::duration_cast<TimePoint::duration>(delay));
+    suspension_ = Suspension::Sleep;
+}
+
+void Job::suspendUntilWoken() {
+    // The previous park, if any, is over: both its arrivals happened before this run.
+    park_arrivals_.store(0, std::memory_order_relaxed);
+    suspension_ = Suspension::Park;
+}
+
+void Job::cancelSuspension() {
+    suspension_ = Suspension::None;
+}
+
+void Job::wake() {
+    if (park_arrivals_.fetch_add(1, std::memory_order_acq_rel) == 1) {
+        parked_by_->resumeParked(std::move(parked_self_));
+    }
+}
+
+void Job::setDurableTask(std::string name, std::string payload) {
+    durable_task_ = std::make_unique<const DurableTask>(DurableTask{std::move(name), std::move(payload)});
+}
+
+const DurableTask* Job::getDurableTask() const {
+    return durable_task_.get();
+}
+
+void Job::setPriority(JobPriority priority) {
+    priority_ = priority;
+}
+
+JobPriority Job::getPriority() const {
+    return priority_;
+}
+
+void Job::setExecutionClass(ExecutionClass execution_class) {
+    execution_class_ = execution_class;
+}
+
+ExecutionClass Job::getExecutionClass() const {
+    return execution_class_;
+}
+
+JobState Job::getState() const {
+    uint64_t word = waitUntilSettled();
+    return static_cast<JobState>(word & kStateMask);
+}
+
+uint64_t Job::waitUntilSettled() const {
+    uint64_t word = state_.load();
+    while ((word & kStateMask) == kMoving) {
+        std::this_thread::yield();
+        word = state_.load();
+    }
+    return word;
+}
+
+bool Job::markQueued() {
+    uint64_t word = waitUntilSettled();
+    if ((word & kStateMask) == static_cast<uint64_t>(JobState::Created)) {
+        // No queue holds the job yet, so nothing can race with this first transition; the
+        // queue lock taken by the caller publishes it to consumers.
+        state_.store(packState(JobState::Queued, 1), std::memory_order_release);
+        return false;
+    }
+    while (!state_.compare_exchange_weak(word, packState(JobState::Queued, (word >> kStateBits) + 1))) {
+        word = waitUntilSettled();
+    }
+    return (word & kStateMask) == static_cast<uint64_t>(JobState::Queued);
+}
+
+bool Job::claim(TimePoint now) {
+    uint64_t word = state_.load();
+    while ((word & kStateMask) == static_cast<uint64_t>(JobState::Queued)) {
+        // A move bumps the generation before publishing the new time, so the exchange below
+        // fails if the time read here is not the one belonging to `word`.
+        if (scheduled_time_.load() > now) {
+            return false;
+        }
+        if (state_.compare_exchange_weak(word, packState(JobState::Running, word >> kStateBits))) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool Job::cancelQueued() {
+    uint64_t word = waitUntilSettled();
+    while ((word & kStateMask) == static_cast<uint64_t>(JobState::Queued)) {
+        if (state_.compare_exchange_weak(word, packState(JobState::Cancelled, word >> kStateBits))) {
+            return true;
+        }
+        word = waitUntilSettled();
+    }
+    return false;
+}
+
+bool Job::cancelUnqueued() {
+    uint64_t word = packState(JobState::Created, 0);
+    return state_.compare_exchange_strong(word, packState(JobState::Cancelled, 0));
+}
+
+bool Job::moveQueued(TimePoint time) {
+    uint64_t word = waitUntilSettled();
+    while ((word & kStateMask) == static_cast<uint64_t>(JobState::Queued)) {
+        uint64_t moving = ((word >> kStateBits) + 1) << kStateBits | kMoving;
+        if (state_.compare_exchange_weak(word, moving)) {
+            scheduled_time_.store(time);
+            state_.store(packState(JobState::Queued, moving >> kStateBits));
+            return true;
+        }
+        word = waitUntilSettled();
+    }
+    return false;
+}
+
+void Job::markFinished() {
+    uint64_t word = waitUntilSettled();
+    state_.store(packState(JobState::Finished, word >> kStateBits));
+}
+
+void Job::markExpired() {
+    uint64_t word = waitUntilSettled();
+    state_.store(packState(JobState::Expired, word >> kStateBits));
+}
+
+void Job::setRecurrence(const Recurrence& recurrence) {
+    if (recurrence.period.count() < 0) {
+        throw std::invalid_argument("Recurrence period must not be negative");
+    }
+    recurrence_ = recurrence;
+}
+
+const Recurrence& Job::getRecurrence() const {
+    return recurrence_;
+}
+
+bool Job::isRecurring() const {
+    return recurrence_.period.count() > 0;
+}
+
+uint64_t Job::getFiringCount() const {
+    return firings_;
+}
+
+void Job::beginFiring() {
+    firing_time_.store(scheduled_time_.load(), std::memory_order_relaxed);
+    ++firings_;
+}
+
+bool Job::planNextFiring() {
+    if (!isRecurring() || recurrence_stopped_ ||
+        (recurrence_.max_firings != 0 && firings_ >= recurrence_.max_firings)) {
+        return false;
+    }
+    // Fixed-rate catch-up needs no clock read: the grid alone gives the next time.
+    TimePoint next;
+    if (recurrence_.mode == RecurrenceMode::FixedDelay) {
+        next = utils::now() + recurrence_.period;
+    } else {
+        TimePoint firing = firing_time_.load(std::memory_order_relaxed);
+        next = firing + recurrence_.period;
+        if (recurrence_.missed == MissedFiringPolicy::Skip) {
+            auto now = utils::now();
+            if (next <= now) {
+                auto missed = (now - firing) / recurrence_.period;
+                next = firing + recurrence_.period * (missed + 1);
+            }
+        }
+    }
+    if (hasDeadline()) {
+        deadline_ = next + (deadline_ - firing_time_.load(std::memory_order_relaxed));
+    }
+    attempt_ = 0;
+    scheduled_time_.store(next);
+    return true;
+}
+
+bool Job::stopRecurrence() {
+    return isRecurring() && !recurrence_stopped_.exchange(true);
+}
+
+bool Job::recurrenceStopped() const {
+    return recurrence_stopped_;
+}
+
+}
@@ -5,49 +5,285 @@
 
 #include "JobExecutor.hpp"
 #include "Utils.hpp"
+#include "Watchdog.hpp"
 #include <thread>
 #include <iostream>
 #include <atomic>
 
 namespace scheduleit {
 
-JobExecutor::JobExecutor(std::shared_ptr<JobQueue> job_queue)
-    : job_queue_(std::move(job_queue)), active_jobs_(0) {}
+JobExecutor::JobExecutor(std::shared_ptr<JobQueue> job_queue, std::shared_ptr<CompletionTracker> tracker)
+    : tracker_(std::move(tracker)), active_jobs_(0) {
+    for (auto& queue : queues_) {
+        queue = job_queue;
+    }
+}
 
 void JobExecutor::registerObserver(std::shared_ptr<Observer> observer) {
-    if (observer) {
-        observers_.emplace_back(std::move(observer));
+    observers_.add(std::move(observer));
+}
+
+void JobExecutor::registerBatchObserver(std::shared_ptr<BatchObserver> observer) {
+    observers_.add(std::move(observer));
+}
+
+bool JobExecutor::unregisterObserver(const std::shared_ptr<Observer>& observer) {
+    return observers_.remove(observer);
+}
+
+bool JobExecutor::unregisterBatchObserver(const std::shared_ptr<BatchObserver>& observer) {
+    return observers_.remove(observer);
+}
+
+void JobExecutor::flushObservers() {
+    observers_.flush();
+}
+
+void JobExecutor::setJournal(std::shared_ptr<Journal> journal) {
+    journal_ = std::move(journal);
+}
+
+void JobExecutor::setMetrics(std::shared_ptr<SchedulerMetrics> metrics) {
+    for (auto& slot : metrics_) {
+        slot = metrics;
+    }
+}
+
+void JobExecutor::setLane(ExecutionClass execution_class, std::shared_ptr<JobQueue> queue,
+                          std::shared_ptr<SchedulerMetrics> metrics) {
+    queues_[static_cast<size_t>(execution_class)] = std::move(queue);
+    metrics_[static_cast<size_t>(execution_class)] = std::move(metrics);
+}
+
+void JobExecutor::adoptRecovered(const std::vector<std::shared_ptr<Job>>& jobs) {
+    for (const auto& job : jobs) {
+        if (job->getAttempt() > 0) {
+            pending_retries_++;
+            queueFor(*job).incrementPending();
+        }
     }
 }
 
 void JobExecutor::run(std::shared_ptr<Job> job) {
+    // A resumed suspension continues an attempt that was already counted and may not be late.
+    bool resuming = job->resuming_;
+    job->resuming_ = false;
+    if (!resuming) {
+        if (job->getAttempt() > 0) {
+            pending_retries_--;
+        } else {
+            job->beginFiring();
+        }
+    }
+    if (!resuming && job->hasDeadline() && utils::now() > job->getLatestStart()) {
+        expire(job);
+        return;
+    }
     active_jobs_++;
+    // Looked up now: a retry hands the job itself back to the queue.
+    JobQueue& queue = queueFor(*job);
+    SchedulerMetrics* metrics = metricsFor(*job);
+    Job::TimePoint started;
+    if (metrics) {
+        started = utils::now();
+        metrics->recordStart(*job, started);
+    }
+    if (job->timeout_.count() > 0) {
+        armTimeout(job);
+    }
+    bool retried = false;
+    bool succeeded = false;
+    bool suspended = false;
     try {
-        job->execute();
-        // notify observers of success
-        for (const auto& obs : observers_) {
-            if (obs) obs->onJobSuccess(*job);
+        {
+            // Records the execution time on the way out, whether the task returns or throws.
+            struct ExecutionTimer {
+                SchedulerMetrics* metrics;
+                Job::TimePoint started;
+                ~ExecutionTimer() {
+                    if (metrics) metrics->recordExecution(utils::now() - started);
+                }
+            } timer{metrics, started};
+            // Lets the task find its own job, e.g. to suspend it.
+            struct CurrentJob {
+                explicit CurrentJob(Job* job) {
+                    Job::current_ = job;
+                }
+                ~CurrentJob() {
+                    Job::current_ = nullptr;
+                }
+            } current(job.get());
+            job->execute();
         }
-    } catch (const std::exception& e) {
-        // notify observers of failure
-        for (const auto& obs : observers_) {
-            if (obs) obs->onJobFailed(*job, job->getAttempt());
-        }
-        // retry logic
-        if (job->shouldRetry()) {
-            job->incrementAttempt();
-            auto strategy = job->getRetryStrategy();
-            if (strategy) {
-                auto delay = strategy->getBackoffDelay(job->getAttempt());
-                job->reschedule(delay);
-                utils::sleepForMillis(delay);  // simulate backoff before retry enqueue
-                job_queue_->incrementPending();
-                job_queue_->enqueue(std::move(job));
+        if (endAttempt(*job)) {
+            // Overran: a failure even though the task returned.
+            retried = handleFailure(job);
+        } else {
+            succeeded = true;
+            suspended = job->suspension_ != Job::Suspension::None;
+            if (!suspended) {
+                // notify observers of success
+                observers_.notifySuccess(job);
             }
         }
+    } catch (const std::exception& e) {
+        endAttempt(*job);
+        retried = handleFailure(job);
+    } catch (...) {
+        endAttempt(*job);
+        retried = handleFailure(job);
     }
-    job_queue_->decrementPending();
+    queue.decrementPending();
     active_jobs_--;
+    if (suspended) {
+        suspend(job);
+        return;
+    }
+    if (metrics && !retried) {
+        metrics->recordRetries(job->getAttempt());
+    }
+    if (retried || (job->isRecurring() && scheduleNextFiring(job))) {
+        return;
+    }
+    job->markFinished();
+    if (journal_) {
+        journal_->recordDone(job);
+    }
+    job->notifyCompleted(succeeded);
+    if (tracker_) {
+        tracker_->onCompleted(*job);
+    }
+}
+
+void JobExecutor::onCancelled(const std::shared_ptr<Job>& job) {
+    // Undo what run() would have done for this job; a sleeping job's retry was counted off.
+    if (job->getAttempt() > 0 && !job->resuming_) {
+        pending_retries_--;
+    }
+    queueFor(*job).decrementPending();
+    jobs_cancelled_++;
+    if (journal_) {
+        journal_->recordDone(job);
+    }
+    observers_.notifyCancelled(job);
+    job->notifyCompleted(false);
+    if (tracker_) {
+        tracker_->onCompleted(*job);
+    }
+}
+
+void JobExecutor::expire(const std::shared_ptr<Job>& job) {
+    queueFor(*job).decrementPending();
+    jobs_expired_++;
+    observers_.notifyExpired(job);
+    if (job->isRecurring() && scheduleNextFiring(job)) {
+        return;
+    }
+    job->markExpired();
+    if (journal_) {
+        journal_->recordDone(job);
+    }
+    job->notifyCompleted(false);
+    if (tracker_) {
+        tracker_->onCompleted(*job);
+    }
+}
+
+void JobExecutor::armTimeout(const std::shared_ptr<Job>& job) {
+    job->attempt_cancel_ = std::make_shared<CancellationState>();
+    int attempt = job->getAttempt();
+    Watchdog::instance().watch(job->attempt_cancel_, Watchdog::Clock::now() + job->timeout_,
+                               [this, job, attempt]() { observers_.notifyTimedOut(job, attempt); });
+}
+
+bool JobExecutor::endAttempt(Job& job) {
+    if (!job.attempt_cancel_) {
+        return false;
+    }
+    std::shared_ptr<CancellationState> state = std::move(job.attempt_cancel_);
+    if (state->finish()) {
+        return false;
+    }
+    // The watchdog got there first; let it finish reporting before the failure is.
+    state->waitForExpiry();
+    timeouts_++;
+    return true;
+}
+
+void JobExecutor::resumeParked(std::shared_ptr<Job> job) {
+    job->scheduled_time_.store(utils::now());
+    JobQueue& queue = queueFor(*job);
+    queue.incrementPending();
+    queue.enqueue(std::move(job));
 }
 
-}
\ No newline at end of file
+void JobExecutor::suspend(std::shared_ptr<Job>& job) {
+    Job::Suspension suspension = job->suspension_;
+    job->suspension_ = Job::Suspension::None;
+    suspensions_++;
+    job->resuming_ = true;
+    if (suspension == Job::Suspension::Sleep) {
+        // Like a retry: the queue holds the job until its time, the worker moves on.
+        JobQueue& queue = queueFor(*job);
+        queue.incrementPending();
+        queue.enqueue(std::move(job));
+        return;
+    }
+    // The waker may already have been; whichever of this and Job::wake() comes second
+    // queues the job. The job must not be touched after the count is bumped.
+    job->parked_by_ = this;
+    job->parked_self_ = job;
+    if (job->park_arrivals_.fetch_add(1, std::memory_order_acq_rel) == 1) {
+        resumeParked(std::move(job->parked_self_));
+    }
+}
+
+bool JobExecutor::handleFailure(std::shared_ptr<Job>& job) {
+    job->suspension_ = Job::Suspension::None;
+    // notify observers of failure
+    observers_.notifyFailure(job, job->getAttempt());
+    // retry logic
+    return job->shouldRetry() && scheduleRetry(job);
+}
+
+bool JobExecutor::scheduleRetry(std::shared_ptr<Job>& job) {
+    if (!job->approveRetry(job->getAttempt() + 1)) {
+        retries_cancelled_++;
+        return false;
+    }
+    job->incrementAttempt();
+    auto delay = job->getRetryStrategy()->getBackoffDelay(job->getAttempt());
+    job->reschedule(delay);
+
+    // The queue holds the job until its backoff expires, so the worker is free immediately.
+    pending_retries_++;
+    retries_scheduled_++;
+    JobQueue& queue = queueFor(*job);
+    queue.incrementPending();
+    if (journal_) {
+        journal_->recordUpdate(job);
+    }
+    queue.enqueue(std::move(job));
+    return true;
+}
+
+bool JobExecutor::scheduleNextFiring(const std::shared_ptr<Job>& job) {
+    if (!job->planNextFiring()) {
+        return false;
+    }
+    firings_scheduled_++;
+    JobQueue& queue = queueFor(*job);
+    queue.incrementPending();
+    if (journal_) {
+        journal_->recordUpdate(job);
+    }
+    queue.enqueue(job);
+    // A cancel that ran between planning and enqueueing found the job running and only
+    // stopped the series; withdraw the firing it could not see. Only one side can win.
+    if (job->recurrenceStopped() && queue.cancel(*job)) {
+        onCancelled(job);
+    }
+    return true;
+}
+
+}
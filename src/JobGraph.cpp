@@ -0,0 +1,248 @@
+/**
+ * @file JobGraph.cpp
+ * @brief Implements JobGraph and the scheduler-side state of a submitted graph.
+ */
+
+#include "JobGraph.hpp"
+#include "JobScheduler.hpp"
+#include <atomic>
+#include <stdexcept>
+#include <vector>
+
+namespace scheduleit {
+
+JobGraph::NodeId JobGraph::add(std::shared_ptr<Job> job) {
+    if (!job) {
+        throw std::invalid_argument("JobGraph node must not be null");
+    }
+    jobs_.push_back(std::move(job));
+    return static_cast<NodeId>(jobs_.size() - 1);
+}
+
+void JobGraph::addEdge(NodeId parent, NodeId child) {
+    if (parent >= jobs_.size() || child >= jobs_.size() || parent == child) {
+        throw std::invalid_argument("JobGraph edge must connect two distinct existing nodes");
+    }
+    edges_.emplace_back(parent, child);
+}
+
+/**
+ * @class JobScheduler::GraphRun
+ * @brief Fan-in counters and successor lists of one submitted graph.
+ *
+ * Each job's completion hook reports back here with the job's node id. Successors are kept
+ * in one flat array indexed by per-node offsets. A node's claim flag decides, exactly once,
+ * whether the node is queued or cancelled, since a success and a failure of two of its
+ * predecessors may race. The scheduler owns the run until its last node has finished.
+ */
+class JobScheduler::GraphRun {
+public:
+    GraphRun(JobScheduler* scheduler, JobGraph& graph)
+        : scheduler_(scheduler),
+          policy_(graph.policy_),
+          jobs_(std::move(graph.jobs_)),
+          child_begin_(jobs_.size() + 1, 0),
+          waiting_on_(new std::atomic<uint32_t>[jobs_.size()]),
+          claimed_(new std::atomic<bool>[jobs_.size()]),
+          remaining_(jobs_.size()) {
+        size_t count = jobs_.size();
+        std::vector<uint32_t> parents(count, 0);
+        for (const auto& edge : graph.edges_) {
+            ++child_begin_[edge.first + 1];
+            ++parents[edge.second];
+        }
+        for (size_t i = 0; i < count; ++i) {
+            child_begin_[i + 1] += child_begin_[i];
+        }
+        children_.resize(graph.edges_.size());
+        std::vector<uint32_t> fill(child_begin_.begin(), child_begin_.end() - 1);
+        for (const auto& edge : graph.edges_) {
+            children_[fill[edge.first]++] = edge.second;
+        }
+        checkAcyclic(parents);
+
+        for (size_t i = 0; i < count; ++i) {
+            waiting_on_[i].store(parents[i], std::memory_order_relaxed);
+            claimed_[i].store(parents[i] == 0, std::memory_order_relaxed);
+            installHook(static_cast<uint32_t>(i));
+        }
+    }
+
+    const std::vector<std::shared_ptr<Job>>& jobs() const {
+        return jobs_;
+    }
+
+    /**
+     * @brief Returns the nodes without predecessors, which are queued on submission.
+     */
+    std::vector<std::shared_ptr<Job>> roots() const {
+        std::vector<std::shared_ptr<Job>> result;
+        for (size_t i = 0; i < jobs_.size(); ++i) {
+            if (waiting_on_[i].load(std::memory_order_relaxed) == 0) {
+                result.push_back(jobs_[i]);
+            }
+        }
+        return result;
+    }
+
+private:
+    struct Finished {
+        GraphRun* run;
+        uint32_t node;
+        bool succeeded;
+    };
+
+    void checkAcyclic(const std::vector<uint32_t>& parents) const {
+        // Kahn's algorithm: a graph is acyclic iff repeatedly removing parentless nodes
+        // removes them all.
+        std::vector<uint32_t> waiting(parents);
+        std::vector<uint32_t> ready;
+        for (uint32_t i = 0; i < waiting.size(); ++i) {
+            if (waiting[i] == 0) {
+                ready.push_back(i);
+            }
+        }
+        size_t visited = 0;
+        while (!ready.empty()) {
+            uint32_t node = ready.back();
+            ready.pop_back();
+            ++visited;
+            for (uint32_t c = child_begin_[node]; c < child_begin_[node + 1]; ++c) {
+                if (--waiting[children_[c]] == 0) {
+                    ready.push_back(children_[c]);
+                }
+            }
+        }
+        if (visited != waiting.size()) {
+            throw std::invalid_argument("JobGraph has a cycle");
+        }
+    }
+
+    void installHook(uint32_t node) {
+        Job& job = *jobs_[node];
+        if (!job.completion_hook_) {
+            job.completion_hook_ = [this, node](const Job&, bool succeeded) {
+                onFinished({this, node, succeeded});
+            };
+            return;
+        }
+        job.completion_hook_ = [this, node, chained = std::move(job.completion_hook_)](const Job& done,
+                                                                                        bool succeeded) {
+            chained(done, succeeded);
+            onFinished({this, node, succeeded});
+        };
+    }
+
+    /**
+     * @brief Processes a finished node, flattening the cascade it may start.
+     *
+     * Cancelling a successor runs its completion hook, which lands back here; on the same
+     * thread that only queues the event, so a long chain of cancellations neither recurses
+     * nor grows the stack.
+     */
+    static void onFinished(Finished event) {
+        thread_local std::vector<Finished> pending;
+        thread_local bool draining = false;
+        pending.push_back(event);
+        if (draining) {
+            return;
+        }
+        draining = true;
+        while (!pending.empty()) {
+            Finished next = pending.back();
+            pending.pop_back();
+            next.run->finish(next.node, next.succeeded);
+        }
+        draining = false;
+    }
+
+    void finish(uint32_t node, bool succeeded) {
+        bool failed = !succeeded && policy_ != GraphFailurePolicy::RunDependents;
+        if (failed && policy_ == GraphFailurePolicy::CancelGraph && !aborted_.exchange(true)) {
+            for (uint32_t i = 0; i < jobs_.size(); ++i) {
+                if (i != node) {
+                    cancelNode(i);
+                }
+            }
+        }
+        // Successors released together go in with one queue lock; a chain needs no vector.
+        std::shared_ptr<Job> first_ready;
+        std::vector<std::shared_ptr<Job>> ready;
+        for (uint32_t c = child_begin_[node]; c < child_begin_[node + 1]; ++c) {
+            uint32_t child = children_[c];
+            if (failed) {
+                cancelNode(child);
+            }
+            if (waiting_on_[child].fetch_sub(1, std::memory_order_acq_rel) == 1 &&
+                !claimed_[child].exchange(true, std::memory_order_acq_rel)) {
+                if (!first_ready) {
+                    first_ready = jobs_[child];
+                } else {
+                    ready.push_back(jobs_[child]);
+                }
+            }
+        }
+        if (!ready.empty()) {
+            ready.push_back(std::move(first_ready));
+            scheduler_->enqueueJobs(ready);
+        } else if (first_ready) {
+            scheduler_->queueFor(*first_ready).enqueue(std::move(first_ready));
+        }
+        // Last access to this run: once every node has passed here, the scheduler drops it.
+        if (remaining_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            scheduler_->releaseGraph(this);
+        }
+    }
+
+    void cancelNode(uint32_t node) {
+        const auto& job = jobs_[node];
+        if (!claimed_[node].exchange(true, std::memory_order_acq_rel)) {
+            // Held back and now never to be queued.
+            job->cancelUnqueued();
+            scheduler_->executor_->onCancelled(job);
+        } else if (scheduler_->queueFor(*job).cancel(*job)) {
+            scheduler_->executor_->onCancelled(job);
+        }
+    }
+
+    JobScheduler* scheduler_;
+    GraphFailurePolicy policy_;
+    std::vector<std::shared_ptr<Job>> jobs_;
+    std::vector<uint32_t> child_begin_;  // node i's successors are children_[child_begin_[i], child_begin_[i + 1])
+    std::vector<uint32_t> children_;
+    std::unique_ptr<std::atomic<uint32_t>[]> waiting_on_;  // unfinished predecessors
+    std::unique_ptr<std::atomic<bool>[]> claimed_;         // queued or cancelled already
+    std::atomic<size_t> remaining_;                        // nodes whose hook has not run
+    std::atomic<bool> aborted_{false};                     // CancelGraph sweep done
+};
+
+void JobScheduler::submitGraph(JobGraph graph) {
+    if (graph.size() == 0) {
+        return;
+    }
+    auto run = std::make_shared<GraphRun>(this, graph);
+    {
+        std::lock_guard<std::mutex> lock(graphs_mutex_);
+        graphs_.emplace(run.get(), run);
+    }
+    tracker_->onSubmittedBatch(run->jobs());
+    for (const auto& job : run->jobs()) {
+        if (job->isRecurring()) {
+            trackRecurring(job);
+        }
+    }
+    auto roots = run->roots();
+    enqueueJobs(roots);
+}
+
+void JobScheduler::releaseGraph(const GraphRun* run) {
+    std::shared_ptr<GraphRun> last;
+    std::lock_guard<std::mutex> lock(graphs_mutex_);
+    auto it = graphs_.find(run);
+    if (it != graphs_.end()) {
+        last = std::move(it->second);
+        graphs_.erase(it);
+    }
+}
+
+}
@@ -0,0 +1,31 @@
+/**
+ * @file JobHandle.cpp
+ * @brief Implements the JobHandle class.
+ */
+
+#include "JobHandle.hpp"
+#include "JobScheduler.hpp"
+#include "Utils.hpp"
+
+namespace scheduleit {
+
+JobHandle::JobHandle(std::shared_ptr<Job> job, JobScheduler* scheduler)
+    : job_(std::move(job)), scheduler_(scheduler) {}
+
+bool JobHandle::cancel() {
+    return job_ && scheduler_ && scheduler_->cancel(job_);
+}
+
+bool JobHandle::reschedule(Job::TimePoint time) {
+    return job_ && scheduler_ && scheduler_->reschedule(job_, time);
+}
+
+bool JobHandle::reschedule(std::chrono::milliseconds delay) {
+    return reschedule(utils::now() + delay);
+}
+
+JobState JobHandle::getState() const {
+    return job_ ? job_->getState() : JobState::Created;
+}
+
+}
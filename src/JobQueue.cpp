@@ -4,37 +4,505 @@
  */
 
 #include "JobQueue.hpp"
+#include "HeapJobStore.hpp"
+#include "TimingWheelJobStore.hpp"
+#include <algorithm>
 #include <chrono>
+#include <functional>
+#include <string>
 #include "Utils.hpp"
 #include <iostream>
 
 namespace scheduleit {
 
+namespace {
+
+std::unique_ptr<JobStore> makeBackend(const QueueOptions& options) {
+    switch (options.backend) {
+        case QueueBackend::TimingWheel:
+            return std::make_unique<TimingWheelJobStore>(options.wheel_tick, options.wheel_levels, utils::now());
+        case QueueBackend::Heap:
+        default:
+            return std::make_unique<HeapJobStore>();
+    }
+}
+
+}
+
+std::unique_ptr<JobStore> JobQueue::makeStore(const QueueOptions& options) {
+    auto backend = makeBackend(options);
+    if (options.priority_policy == PriorityPolicy::None) {
+        return backend;
+    }
+    auto store = std::make_unique<PriorityJobStore>(std::move(backend), options.priority_policy,
+                                                    options.priority_weights, options.priority_aging);
+    priority_stores_.push_back(store.get());
+    return store;
+}
+
+JobQueue::JobQueue(const QueueOptions& options) {
+    if (options.shards > 1) {
+        shard_selection_ = options.shard_selection;
+        shard_skew_ = std::chrono::duration_cast<Job::TimePoint::duration>(options.shard_skew).count();
+        for (size_t i = 0; i < options.shards; ++i) {
+            shards_.push_back(std::make_unique<Shard>());
+            shards_.back()->store = makeStore(options);
+        }
+    } else {
+        store_ = makeStore(options);
+    }
+}
+
 void JobQueue::enqueue(std::shared_ptr<Job> job) {
+    if (job->markQueued()) {
+        stale_entries_.fetch_add(1);  // queued twice: one of the two entries will be dropped
+    }
+    auto now = utils::now();
+    job->enqueued_time_.store(now, std::memory_order_relaxed);
+    insert(std::move(job), now);
+}
+
+void JobQueue::insert(std::shared_ptr<Job> job, Job::TimePoint now) {
+    auto time = job->getScheduledTime();
+    bool due = time <= now;
+    if (sharded()) {
+        Shard& shard = *shards_[shardFor(*job)];
+        {
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            shard.store->push(std::move(job));
+            publish(shard);
+        }
+        notifySharded(time, due ? 1 : 0);
+        return;
+    }
+    Wakeup wakeup;
     {
         std::lock_guard<std::mutex> lock(mutex_);
-        queue_.push(std::move(job));
+        wakeup = planWakeup(time, due ? 1 : 0);
+        store_->push(std::move(job));
+    }
+    wake(wakeup);
+}
+
+void JobQueue::enqueueBatch(std::vector<std::shared_ptr<Job>>& jobs) {
+    if (jobs.empty()) {
+        return;
+    }
+    auto now = utils::now();
+    for (const auto& job : jobs) {
+        if (job->markQueued()) {
+            stale_entries_.fetch_add(1);
+        }
+        job->enqueued_time_.store(now, std::memory_order_relaxed);
+    }
+    if (sharded()) {
+        enqueueSharded(jobs, now);
+        return;
+    }
+    size_t due = 0;
+    auto earliest = Job::TimePoint::max();
+    for (const auto& job : jobs) {
+        due += job->getScheduledTime() <= now;
+        earliest = std::min(earliest, job->getScheduledTime());
+    }
+
+    Wakeup wakeup;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        wakeup = planWakeup(earliest, due);
+        store_->pushBatch(jobs);
+    }
+    jobs.clear();
+    wake(wakeup);
+}
+
+bool JobQueue::cancel(Job& job) {
+    if (!job.cancelQueued()) {
+        return false;
+    }
+    stale_entries_.fetch_add(1);
+    compactIfStale();
+    return true;
+}
+
+bool JobQueue::reschedule(const std::shared_ptr<Job>& job, Job::TimePoint time) {
+    if (!job->moveQueued(time)) {
+        return false;
+    }
+    stale_entries_.fetch_add(1);
+    insert(job, utils::now());
+    compactIfStale();
+    return true;
+}
+
+std::shared_ptr<Job> JobQueue::popClaimed(JobStore& store, Job::TimePoint now) {
+    while (auto job = store.popReady(now)) {
+        if (job->claim(now)) {
+            return job;
+        }
+        stale_entries_.fetch_sub(1);
+    }
+    return nullptr;
+}
+
+size_t JobQueue::liveCount(size_t entries) const {
+    int64_t stale = stale_entries_.load();
+    return stale <= 0 ? entries : entries - std::min(entries, static_cast<size_t>(stale));
+}
+
+size_t JobQueue::entryCount() const {
+    if (sharded()) {
+        size_t total = 0;
+        for (const auto& shard : shards_) {
+            total += shard->size.load();
+        }
+        return total;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    return store_->size();
+}
+
+void JobQueue::compactIfStale() {
+    int64_t stale = stale_entries_.load();
+    if (stale < compact_at_.load()) {
+        return;
+    }
+    if (2 * stale < static_cast<int64_t>(entryCount())) {
+        // Mostly live entries: wait until the stale ones are half of the current size.
+        compact_at_.store(std::max(kMinCompaction, static_cast<int64_t>(entryCount()) / 2));
+        return;
+    }
+    if (compacting_.exchange(true)) {
+        return;
+    }
+    std::vector<std::shared_ptr<Job>> removed;
+    if (sharded()) {
+        for (auto& shard : shards_) {
+            std::lock_guard<std::mutex> lock(shard->mutex);
+            shard->store->removeStale(removed);
+            publish(*shard);
+        }
+    } else {
+        std::lock_guard<std::mutex> lock(mutex_);
+        store_->removeStale(removed);
+    }
+    int64_t left = stale_entries_.fetch_sub(static_cast<int64_t>(removed.size())) -
+                   static_cast<int64_t>(removed.size());
+    // Whatever could not be removed (old entries of moved jobs in a timing wheel) must not
+    // trigger another full pass right away.
+    compact_at_.store(std::max(kMinCompaction, 2 * left));
+    compacting_.store(false);
+    // The removed jobs are released here, outside the queue lock.
+}
+
+JobQueue::Wakeup JobQueue::planWakeup(Job::TimePoint earliest, size_t due) const {
+    Wakeup wakeup;
+    // Wake the deadline sleeper if the new work is due sooner or nobody else is waiting.
+    wakeup.timed = has_timed_waiter_ && (earliest < timed_deadline_ || idle_waiters_ == 0);
+    // Idle waiters help only with jobs that are already due, or to take the deadline role.
+    size_t wanted = std::max<size_t>(due, has_timed_waiter_ ? 0 : 1);
+    if (wakeup.timed && wanted > 0) {
+        --wanted;
+    }
+    wakeup.idle_waiters = static_cast<size_t>(idle_waiters_);
+    wakeup.idle = std::min(wanted, wakeup.idle_waiters);
+    return wakeup;
+}
+
+void JobQueue::wake(const Wakeup& wakeup) {
+    if (wakeup.timed) {
+        timed_cv_.notify_one();
+    }
+    if (wakeup.idle > 1 && wakeup.idle == wakeup.idle_waiters) {
+        cv_.notify_all();
+        return;
+    }
+    for (size_t i = 0; i < wakeup.idle; ++i) {
+        cv_.notify_one();
     }
-    cv_.notify_one();
 }
 
 std::shared_ptr<Job> JobQueue::dequeueReady() {
+    if (sharded()) {
+        return popOrWaitSharded(false);
+    }
+    std::unique_lock<std::mutex> lock(mutex_);
+    return popOrWait(lock, false);
+}
+
+std::shared_ptr<Job> JobQueue::waitDequeue() {
+    if (sharded()) {
+        return popOrWaitSharded(true);
+    }
     std::unique_lock<std::mutex> lock(mutex_);
-    while (!queue_.empty()) {
-        auto next_job = queue_.top();
+    return popOrWait(lock, true);
+}
+
+size_t JobQueue::waitDequeueBatch(std::vector<std::shared_ptr<Job>>& out, size_t max_jobs) {
+    if (sharded()) {
+        auto first = popOrWaitSharded(true);
+        if (!first) {
+            return 0;
+        }
+        out.push_back(std::move(first));
+        size_t taken = 1;
         auto now = utils::now();
-        if (now >= next_job->getScheduledTime()) {
-            queue_.pop();
-            return next_job;
+        while (taken < max_jobs) {
+            auto job = tryPopSharded(now);
+            if (!job) {
+                break;
+            }
+            out.push_back(std::move(job));
+            ++taken;
         }
-        cv_.wait_until(lock, next_job->getScheduledTime());
+        return taken;
+    }
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    auto first = popOrWait(lock, true);
+    if (!first) {
+        return 0;
+    }
+    out.push_back(std::move(first));
+    size_t taken = 1;
+    auto now = utils::now();
+    while (taken < max_jobs) {
+        auto job = popClaimed(*store_, now);
+        if (!job) {
+            break;
+        }
+        out.push_back(std::move(job));
+        ++taken;
+    }
+    return taken;
+}
+
+void JobQueue::close() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        closed_ = true;
+    }
+    cv_.notify_all();
+    timed_cv_.notify_all();
+}
+
+std::shared_ptr<Job> JobQueue::popOrWait(std::unique_lock<std::mutex>& lock, bool wait_when_empty) {
+    while (true) {
+        if (!store_->empty()) {
+            auto next_job = popClaimed(*store_, utils::now());
+            if (next_job) {
+                // Hand the deadline role to another waiter if work remains.
+                if (!store_->empty() && !has_timed_waiter_) {
+                    cv_.notify_one();
+                }
+                return next_job;
+            }
+        }
+        // Entries left only by cancelled jobs are not worth waiting for.
+        bool drained = liveCount(store_->size()) == 0;
+        if (!drained && !has_timed_waiter_) {
+            has_timed_waiter_ = true;
+            timed_deadline_ = store_->nextWakeTime();
+            timed_cv_.wait_until(lock, timed_deadline_);
+            has_timed_waiter_ = false;
+            continue;
+        }
+        if (drained && !wait_when_empty) {
+            return nullptr;
+        }
+        if (drained && closed_) {
+            cv_.notify_all();  // let the other idle waiters see the drained queue too
+            return nullptr;
+        }
+        ++idle_waiters_;
+        cv_.wait(lock);
+        --idle_waiters_;
     }
-    return nullptr;
 }
 
 bool JobQueue::empty() const {
-    std::lock_guard<std::mutex> lock(mutex_);
-    return queue_.empty();
+    return size() == 0;
 }
 
-}
\ No newline at end of file
+size_t JobQueue::size() const {
+    return liveCount(entryCount());
+}
+
+PriorityStats JobQueue::getPriorityStats() const {
+    PriorityStats total{};
+    auto add = [&total](const PriorityStats& stats) {
+        for (size_t i = 0; i < kJobPriorityCount; ++i) {
+            total[i].queued += stats[i].queued;
+            total[i].ready += stats[i].ready;
+            total[i].dequeued += stats[i].dequeued;
+            total[i].total_wait += stats[i].total_wait;
+            total[i].max_wait = std::max(total[i].max_wait, stats[i].max_wait);
+        }
+    };
+    if (priority_stores_.empty()) {
+        return total;
+    }
+    if (sharded()) {
+        for (size_t i = 0; i < shards_.size(); ++i) {
+            std::lock_guard<std::mutex> lock(shards_[i]->mutex);
+            add(priority_stores_[i]->stats());
+        }
+    } else {
+        std::lock_guard<std::mutex> lock(mutex_);
+        add(priority_stores_.front()->stats());
+    }
+    return total;
+}
+
+size_t JobQueue::shardFor(const Job& job) const {
+    if (shard_selection_ == ShardSelection::JobIdHash && !job.getId().empty()) {
+        return std::hash<std::string>()(job.getId()) % shards_.size();
+    }
+    return homeShard();
+}
+
+size_t JobQueue::homeShard() const {
+    static std::atomic<size_t> next_home{0};
+    thread_local size_t home = next_home.fetch_add(1, std::memory_order_relaxed);
+    return home % shards_.size();
+}
+
+void JobQueue::publish(Shard& shard) {
+    shard.earliest.store(shard.store->empty() ? kNoDeadline
+                                              : shard.store->nextWakeTime().time_since_epoch().count());
+    shard.size.store(shard.store->size());
+}
+
+JobQueue::Ticks JobQueue::scanEarliest() const {
+    Ticks earliest = kNoDeadline;
+    for (const auto& shard : shards_) {
+        earliest = std::min(earliest, shard->earliest.load());
+    }
+    return earliest;
+}
+
+void JobQueue::enqueueSharded(std::vector<std::shared_ptr<Job>>& jobs, Job::TimePoint now) {
+    size_t due = 0;
+    auto earliest = Job::TimePoint::max();
+    for (const auto& job : jobs) {
+        due += job->getScheduledTime() <= now;
+        earliest = std::min(earliest, job->getScheduledTime());
+    }
+
+    if (shard_selection_ == ShardSelection::SubmittingThread) {
+        Shard& shard = *shards_[homeShard()];
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        shard.store->pushBatch(jobs);
+        publish(shard);
+    } else {
+        std::vector<std::vector<std::shared_ptr<Job>>> buckets(shards_.size());
+        for (auto& job : jobs) {
+            size_t index = shardFor(*job);
+            buckets[index].push_back(std::move(job));
+        }
+        for (size_t i = 0; i < buckets.size(); ++i) {
+            if (!buckets[i].empty()) {
+                std::lock_guard<std::mutex> lock(shards_[i]->mutex);
+                shards_[i]->store->pushBatch(buckets[i]);
+                publish(*shards_[i]);
+            }
+        }
+    }
+    jobs.clear();
+    notifySharded(earliest, due);
+}
+
+void JobQueue::notifySharded(Job::TimePoint earliest, size_t due) {
+    // The caller's publish() and this load pair with the waiter's announce-then-recheck, so
+    // either the waiter sees the new deadline or this call sees the waiter.
+    if (sharded_waiters_.load() == 0) {
+        return;
+    }
+    Wakeup wakeup;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        wakeup = planWakeup(earliest, due);
+    }
+    wake(wakeup);
+}
+
+std::shared_ptr<Job> JobQueue::tryPopSharded(Job::TimePoint now) {
+    Ticks now_ticks = now.time_since_epoch().count();
+    size_t home = homeShard();
+    while (true) {
+        size_t best = 0;
+        Ticks best_deadline = kNoDeadline;
+        for (size_t i = 0; i < shards_.size(); ++i) {
+            Ticks deadline = shards_[i]->earliest.load();
+            if (deadline < best_deadline) {
+                best_deadline = deadline;
+                best = i;
+            }
+        }
+        if (best_deadline > now_ticks) {
+            return nullptr;
+        }
+
+        // Prefer the consumer's own shard when its head is due and close enough to the earliest.
+        Ticks home_deadline = shards_[home]->earliest.load();
+        size_t pick = (home_deadline <= now_ticks && home_deadline - best_deadline <= shard_skew_) ? home : best;
+
+        Shard& shard = *shards_[pick];
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        auto job = popClaimed(*shard.store, now);
+        publish(shard);
+        if (job) {
+            return job;
+        }
+        // The published deadline was stale or only a backend event; rescan with the new one.
+    }
+}
+
+std::shared_ptr<Job> JobQueue::popOrWaitSharded(bool wait_when_empty) {
+    while (true) {
+        if (auto job = tryPopSharded(utils::now())) {
+            // Hand the deadline role to another waiter if work remains.
+            if (sharded_waiters_.load() > 0 && scanEarliest() != kNoDeadline) {
+                std::lock_guard<std::mutex> lock(mutex_);
+                if (!has_timed_waiter_ && idle_waiters_ > 0) {
+                    cv_.notify_one();
+                }
+            }
+            return job;
+        }
+
+        std::unique_lock<std::mutex> lock(mutex_);
+        sharded_waiters_.fetch_add(1);
+        Ticks earliest = scanEarliest();  // re-checked after announcing this waiter
+        bool drained = earliest == kNoDeadline || size() == 0;
+        if (!drained && earliest <= utils::now().time_since_epoch().count()) {
+            sharded_waiters_.fetch_sub(1);
+            continue;
+        }
+        if (!drained && !has_timed_waiter_) {
+            has_timed_waiter_ = true;
+            timed_deadline_ = Job::TimePoint(Job::TimePoint::duration(earliest));
+            timed_cv_.wait_until(lock, timed_deadline_);
+            has_timed_waiter_ = false;
+            sharded_waiters_.fetch_sub(1);
+            continue;
+        }
+        if (drained) {
+            if (!wait_when_empty) {
+                sharded_waiters_.fetch_sub(1);
+                return nullptr;
+            }
+            if (closed_) {
+                sharded_waiters_.fetch_sub(1);
+                cv_.notify_all();  // let the other idle waiters see the drained queue too
+                return nullptr;
+            }
+        }
+        ++idle_waiters_;
+        cv_.wait(lock);
+        --idle_waiters_;
+        sharded_waiters_.fetch_sub(1);
+    }
+}
+
+}
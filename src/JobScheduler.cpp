@@ -4,15 +4,77 @@
  */
 
 #include "JobScheduler.hpp"
+#include <algorithm>
 #include <iostream>
 
 namespace scheduleit {
 
-JobScheduler::JobScheduler(size_t num_workers)
-    : job_queue_(std::make_shared<JobQueue>()),
-      thread_pool_(std::make_unique<ThreadPool>(num_workers)),
-      executor_(std::make_unique<JobExecutor>(job_queue_)),
-      running_(false) {}
+JobScheduler::JobScheduler(size_t num_workers, const SchedulerOptions& options)
+    : dispatch_mode_(options.dispatch),
+      num_workers_(num_workers),
+      job_queue_(std::make_shared<JobQueue>(options.queue)),
+      tracker_(std::make_shared<CompletionTracker>()),
+      executor_(std::make_unique<JobExecutor>(job_queue_, tracker_)),
+      journal_(options.journal),
+      metrics_(options.collect_metrics ? std::make_shared<SchedulerMetrics>() : nullptr),
+      running_(false) {
+    executor_->setMetrics(metrics_);
+    if (options.admission.max_pending > 0 || !options.admission.rate_limits.empty()) {
+        admission_ = std::make_unique<AdmissionController>(
+            options.admission, tracker_, [this](const std::shared_ptr<Job>& job) { return cancel(job); });
+    }
+    if (dispatch_mode_ == DispatchMode::Dispatcher) {
+        ThreadPoolOptions pool_options;
+        pool_options.topology = options.topology;
+        pool_options.pin_workers = options.pin_workers;
+        pool_options.elastic = options.elastic;
+        pool_options.max_queue_size = options.max_pool_queue_size;
+        if (options.queue.priority_policy != PriorityPolicy::None) {
+            // Keep the backlog in the JobQueue, where it is ordered by class or deadline, rather
+            // than in the pool's FIFO: hand over only as much as the workers can start right away.
+            dispatch_batch_ = std::max<size_t>(num_workers, 1);
+            if (pool_options.max_queue_size == 0) {
+                pool_options.max_queue_size = dispatch_batch_;
+            }
+        }
+        thread_pool_ = std::make_unique<ThreadPool>(num_workers, pool_options);
+    } else if (options.pin_workers) {
+        pin_topology_ = options.topology ? options.topology
+                                         : std::make_shared<CpuTopology>(CpuTopology::detect());
+    }
+    if (options.blocking.workers > 0) {
+        blocking_workers_ = options.blocking.workers;
+        blocking_queue_ = std::make_shared<JobQueue>(options.queue);
+        blocking_metrics_ = options.collect_metrics ? std::make_shared<SchedulerMetrics>() : nullptr;
+        executor_->setLane(ExecutionClass::Blocking, blocking_queue_, blocking_metrics_);
+        if (dispatch_mode_ == DispatchMode::Dispatcher) {
+            ThreadPoolOptions pool_options;
+            pool_options.max_queue_size = options.blocking.max_queue_size;
+            pool_options.elastic = options.blocking.elastic;
+            if (options.queue.priority_policy != PriorityPolicy::None) {
+                blocking_batch_ = blocking_workers_;
+                if (pool_options.max_queue_size == 0) {
+                    pool_options.max_queue_size = blocking_batch_;
+                }
+            }
+            blocking_pool_ = std::make_unique<ThreadPool>(blocking_workers_, pool_options);
+        }
+    }
+    if (journal_) {
+        executor_->setJournal(journal_);
+        auto recovered = journal_->recover();
+        if (!recovered.empty()) {
+            tracker_->onSubmittedBatch(recovered);
+            executor_->adoptRecovered(recovered);
+            for (const auto& job : recovered) {
+                if (job->isRecurring()) {
+                    trackRecurring(job);
+                }
+            }
+            enqueueJobs(recovered);
+        }
+    }
+}
 
 JobScheduler::~JobScheduler() {
     shutdown();
@@ -20,54 +82,315 @@ JobScheduler::~JobScheduler() {
 
 void JobScheduler::start() {
     running_ = true;
-    dispatcher_thread_ = std::thread([this]() {
-        while (running_ || !job_queue_->empty() || job_queue_->getPendingCount() > 0 || executor_->getActiveJobCount() > 0) {
-            auto job = job_queue_->dequeueReady();
-            if (!job) {
-                std::this_thread::sleep_for(std::chrono::milliseconds(100));
-                continue;
-            }
-            thread_pool_->submit([this, job]() {
+    if (dispatch_mode_ == DispatchMode::Direct) {
+        for (size_t i = 0; i < num_workers_; ++i) {
+            int cpu = pin_topology_ ? pin_topology_->getCpuForWorker(i) : -1;
+            direct_workers_.emplace_back([this, cpu]() {
+                if (cpu >= 0) {
+                    CpuTopology::pinCurrentThread(cpu);
+                }
+                directWorkerLoop(*job_queue_);
+            });
+        }
+        for (size_t i = 0; i < blocking_workers_; ++i) {
+            direct_workers_.emplace_back([this]() { directWorkerLoop(*blocking_queue_); });
+        }
+        return;
+    }
+    dispatcher_thread_ = std::thread([this]() { dispatchLoop(*job_queue_, *thread_pool_, dispatch_batch_); });
+    if (blocking_pool_) {
+        blocking_dispatcher_ = std::thread([this]() {
+            dispatchLoop(*blocking_queue_, *blocking_pool_, blocking_batch_);
+        });
+    }
+}
+
+void JobScheduler::dispatchLoop(JobQueue& queue, ThreadPool& pool, size_t batch_size) {
+    std::vector<std::shared_ptr<Job>> ready;
+    std::vector<UniqueFunction<void()>> tasks;
+    // Jobs with a preferred node, one batch per node index; unused without a topology.
+    const CpuTopology* topology = pool.getTopology();
+    std::vector<std::vector<UniqueFunction<void()>>> placed(topology ? topology->getNodeCount() : 0);
+    while (queue.waitDequeueBatch(ready, batch_size) > 0) {
+        for (auto& job : ready) {
+            size_t node = job->getPreferredNode();
+            // An id the topology does not have places the job anywhere.
+            size_t index = topology && node != CpuTopology::kAnyNode ? topology->findNode(node) : CpuTopology::kAnyNode;
+            auto& batch = index == CpuTopology::kAnyNode || placed.size() == 1 ? tasks : placed[index];
+            batch.emplace_back([this, job = std::move(job)]() {
                 executor_->run(job);
             });
         }
-    });
+        ready.clear();
+        pool.submitBulk(tasks.begin(), tasks.end());
+        tasks.clear();
+        for (size_t index = 0; index < placed.size(); ++index) {
+            if (!placed[index].empty()) {
+                pool.submitBulkToNode(topology->getNodeId(index), placed[index].begin(), placed[index].end());
+                placed[index].clear();
+            }
+        }
+    }
+}
+
+void JobScheduler::directWorkerLoop(JobQueue& queue) {
+    while (auto job = queue.waitDequeue()) {
+        try {
+            executor_->run(std::move(job));
+        } catch (...) {
+            std::cerr << "[JobScheduler] Job threw unknown exception.\n";
+        }
+    }
 }
 
-void JobScheduler::submit(std::shared_ptr<Job> job) {
+JobHandle JobScheduler::submit(std::shared_ptr<Job> job) {
     if (!job) {
         std::cerr << "[JobScheduler] Warning: Attempted to submit null job. Ignoring.\n";
+        return JobHandle();
+    }
+    if (admission_ && admission_->admit(*job, true) != SubmitStatus::Accepted) {
+        return JobHandle();
+    }
+    return accept(std::move(job), admission_ != nullptr);
+}
+
+SubmitResult JobScheduler::trySubmit(std::shared_ptr<Job> job) {
+    SubmitResult result;
+    if (!job) {
+        return result;
+    }
+    result.status = admission_ ? admission_->admit(*job, false) : SubmitStatus::Accepted;
+    if (result.status == SubmitStatus::Accepted) {
+        result.handle = accept(std::move(job), admission_ != nullptr);
+    }
+    return result;
+}
+
+size_t JobScheduler::submitBatch(std::vector<std::shared_ptr<Job>> jobs) {
+    auto null_begin = std::remove(jobs.begin(), jobs.end(), nullptr);
+    if (null_begin != jobs.end()) {
+        std::cerr << "[JobScheduler] Warning: Attempted to submit null job. Ignoring.\n";
+        jobs.erase(null_begin, jobs.end());
+    }
+    if (admission_) {
+        return admission_->admitBatch(jobs, [this](std::vector<std::shared_ptr<Job>>& admitted) {
+            acceptBatch(admitted, true);
+        });
+    }
+    size_t count = jobs.size();
+    acceptBatch(jobs, false);
+    return count;
+}
+
+JobHandle JobScheduler::accept(std::shared_ptr<Job> job, bool reserved) {
+    tracker_->onSubmitted(*job, reserved);
+    if (job->isRecurring()) {
+        trackRecurring(job);
+    }
+    if (journal_) {
+        journal_->recordSubmit(job);
+    }
+    JobHandle handle(job, this);
+    if (admission_ && admission_->shedsLoad()) {
+        queueFor(*job).enqueue(job);
+        admission_->onQueued(job);
+    } else {
+        queueFor(*job).enqueue(std::move(job));
+    }
+    return handle;
+}
+
+void JobScheduler::acceptBatch(std::vector<std::shared_ptr<Job>>& jobs, bool reserved) {
+    tracker_->onSubmittedBatch(jobs, reserved);
+    for (const auto& job : jobs) {
+        if (job->isRecurring()) {
+            trackRecurring(job);
+        }
+    }
+    if (journal_) {
+        journal_->recordSubmitBatch(jobs);
+    }
+    if (!admission_ || !admission_->shedsLoad()) {
+        enqueueJobs(jobs);
         return;
     }
-    job_queue_->enqueue(std::move(job));
+    // enqueueJobs() moves the blocking jobs out of the vector; keep them for onQueued().
+    std::vector<std::shared_ptr<Job>> queued = jobs;
+    enqueueJobs(jobs);
+    for (const auto& job : queued) {
+        admission_->onQueued(job);
+    }
+}
+
+JobQueue& JobScheduler::queueFor(const Job& job) const {
+    return blocking_queue_ && job.getExecutionClass() == ExecutionClass::Blocking ? *blocking_queue_ : *job_queue_;
+}
+
+void JobScheduler::enqueueJobs(std::vector<std::shared_ptr<Job>>& jobs) {
+    if (blocking_queue_) {
+        auto blocking = std::stable_partition(jobs.begin(), jobs.end(), [](const std::shared_ptr<Job>& job) {
+            return job->getExecutionClass() != ExecutionClass::Blocking;
+        });
+        if (blocking != jobs.end()) {
+            std::vector<std::shared_ptr<Job>> moved(std::make_move_iterator(blocking),
+                                                    std::make_move_iterator(jobs.end()));
+            jobs.erase(blocking, jobs.end());
+            blocking_queue_->enqueueBatch(moved);
+        }
+    }
+    job_queue_->enqueueBatch(jobs);
+}
+
+void JobScheduler::trackRecurring(const std::shared_ptr<Job>& job) {
+    std::lock_guard<std::mutex> lock(recurring_mutex_);
+    if (recurring_jobs_.size() == recurring_jobs_.capacity()) {
+        recurring_jobs_.erase(std::remove_if(recurring_jobs_.begin(), recurring_jobs_.end(),
+                                             [](const std::weak_ptr<Job>& entry) { return entry.expired(); }),
+                              recurring_jobs_.end());
+    }
+    recurring_jobs_.push_back(job);
+}
+
+void JobScheduler::stopRecurringJobs() {
+    std::vector<std::weak_ptr<Job>> jobs;
+    {
+        std::lock_guard<std::mutex> lock(recurring_mutex_);
+        jobs.swap(recurring_jobs_);
+    }
+    for (const auto& entry : jobs) {
+        if (auto job = entry.lock()) {
+            cancel(job);
+        }
+    }
+}
+
+bool JobScheduler::cancel(const std::shared_ptr<Job>& job) {
+    if (!job) {
+        return false;
+    }
+    if (queueFor(*job).cancel(*job)) {
+        executor_->onCancelled(job);
+        return true;
+    }
+    // A recurring job that is running right now: end the series after this firing. If the
+    // executor queued the next firing in the meantime, withdraw it; it checks the same flag
+    // after queueing, so one of the two sides sees the other.
+    JobState state = job->getState();
+    if (state == JobState::Finished || state == JobState::Cancelled || state == JobState::Expired ||
+        !job->stopRecurrence()) {
+        return false;
+    }
+    if (queueFor(*job).cancel(*job)) {
+        executor_->onCancelled(job);
+    }
+    return true;
+}
+
+bool JobScheduler::reschedule(const std::shared_ptr<Job>& job, Job::TimePoint time) {
+    if (!job || !queueFor(*job).reschedule(job, time)) {
+        return false;
+    }
+    if (journal_) {
+        journal_->recordUpdate(job);
+    }
+    return true;
 }
 
 void JobScheduler::shutdown() {
-    running_ = false;
+    if (running_.exchange(false)) {
+        // Recurring series never finish on their own; end them so the wait below can.
+        stopRecurringJobs();
+        tracker_->waitForIdle();
+    }
+    job_queue_->close();
+    if (blocking_queue_) {
+        blocking_queue_->close();
+    }
     if (dispatcher_thread_.joinable()) {
         dispatcher_thread_.join();
     }
-    thread_pool_->shutdown();
+    if (blocking_dispatcher_.joinable()) {
+        blocking_dispatcher_.join();
+    }
+    if (thread_pool_) {
+        thread_pool_->shutdown();
+    }
+    if (blocking_pool_) {
+        blocking_pool_->shutdown();
+    }
+    for (auto& worker : direct_workers_) {
+        if (worker.joinable()) {
+            worker.join();
+        }
+    }
+}
+
+PriorityStats JobScheduler::getPriorityStats() const {
+    return job_queue_->getPriorityStats();
+}
+
+PriorityStats JobScheduler::getPriorityStats(ExecutionClass execution_class) const {
+    bool blocking = blocking_queue_ && execution_class == ExecutionClass::Blocking;
+    return blocking ? blocking_queue_->getPriorityStats() : job_queue_->getPriorityStats();
+}
+
+MetricsSnapshot JobScheduler::getMetrics() const {
+    MetricsSnapshot snapshot = metrics_ ? metrics_->snapshot() : MetricsSnapshot();
+    if (blocking_metrics_) {
+        snapshot.merge(blocking_metrics_->snapshot());
+    }
+    return snapshot;
+}
+
+MetricsSnapshot JobScheduler::getMetrics(ExecutionClass execution_class) const {
+    if (blocking_queue_ && execution_class == ExecutionClass::Blocking) {
+        return blocking_metrics_ ? blocking_metrics_->snapshot() : MetricsSnapshot();
+    }
+    return metrics_ ? metrics_->snapshot() : MetricsSnapshot();
+}
+
+std::vector<MetricsSnapshot> JobScheduler::getWorkerMetrics() const {
+    std::vector<MetricsSnapshot> workers = metrics_ ? metrics_->snapshotWorkers() : std::vector<MetricsSnapshot>();
+    if (blocking_metrics_) {
+        auto blocking = blocking_metrics_->snapshotWorkers();
+        workers.insert(workers.end(), blocking.begin(), blocking.end());
+    }
+    return workers;
 }
 
 JobExecutor* JobScheduler::getExecutor() const {
     return executor_.get();
 }
 
+ElasticStats JobScheduler::getElasticStats(ExecutionClass execution_class) const {
+    ThreadPool* pool = execution_class == ExecutionClass::Blocking && blocking_pool_ ? blocking_pool_.get()
+                                                                                     : thread_pool_.get();
+    return pool ? pool->getElasticStats() : ElasticStats();
+}
+
 void JobScheduler::waitForIdle() {
-    const int idle_threshold = 5;
-    int stable_count = 0;
-
-    while (stable_count < idle_threshold) {
-        if (!job_queue_->empty() ||
-            job_queue_->getPendingCount() > 0 ||
-            executor_->getActiveJobCount() > 0) {
-            stable_count = 0;
-        } else {
-            ++stable_count;
-        }
-        std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    tracker_->waitForIdle();
+}
+
+bool JobScheduler::waitForIdle(std::chrono::milliseconds timeout) {
+    return tracker_->waitForIdle(timeout);
+}
+
+bool JobScheduler::waitForJobs(const std::vector<std::string>& ids, std::chrono::milliseconds timeout) {
+    return tracker_->waitForJobs(ids, timeout);
+}
+
+size_t JobScheduler::getOutstandingCount() const {
+    return tracker_->getOutstandingCount();
+}
+
+QueuePressure JobScheduler::getQueuePressure() const {
+    if (admission_) {
+        return admission_->getPressure();
     }
+    QueuePressure pressure;
+    pressure.outstanding = tracker_->getOutstandingCount();
+    return pressure;
 }
 
-}
\ No newline at end of file
+}
@@ -0,0 +1,71 @@
+/**
+ * @file LatencyHistogram.cpp
+ * @brief Implements LatencyHistogram and HistogramSnapshot.
+ */
+
+#include "LatencyHistogram.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace scheduleit {
+
+void HistogramSnapshot::merge(const HistogramSnapshot& other) {
+    if (other.counts.empty()) {
+        return;
+    }
+    if (counts.empty()) {
+        counts.assign(LatencyHistogram::kBucketCount, 0);
+    }
+    for (size_t i = 0; i < counts.size(); ++i) {
+        counts[i] += other.counts[i];
+    }
+    count += other.count;
+    sum += other.sum;
+    max = std::max(max, other.max);
+}
+
+uint64_t HistogramSnapshot::percentile(double percentile) const {
+    if (count == 0) {
+        return 0;
+    }
+    double clamped = std::min(std::max(percentile, 0.0), 100.0);
+    auto rank = std::max<uint64_t>(1, static_cast<uint64_t>(std::ceil(clamped / 100.0 * static_cast<double>(count))));
+    uint64_t seen = 0;
+    for (size_t i = 0; i < counts.size(); ++i) {
+        seen += counts[i];
+        if (seen >= rank) {
+            return std::min(LatencyHistogram::bucketUpperBound(i), max);
+        }
+    }
+    return max;
+}
+
+double HistogramSnapshot::mean() const {
+    return count == 0 ? 0.0 : static_cast<double>(sum) / static_cast<double>(count);
+}
+
+void LatencyHistogram::snapshotInto(HistogramSnapshot& snapshot) const {
+    if (snapshot.counts.empty()) {
+        snapshot.counts.assign(kBucketCount, 0);
+    }
+    for (size_t i = 0; i < kBucketCount; ++i) {
+        uint64_t n = counts_[i].load(std::memory_order_relaxed);
+        snapshot.counts[i] += n;
+        snapshot.count += n;
+    }
+    snapshot.sum += sum_.load(std::memory_order_relaxed);
+    snapshot.max = std::max(snapshot.max, max_.load(std::memory_order_relaxed));
+}
+
+uint64_t LatencyHistogram::bucketUpperBound(size_t bucket) noexcept {
+    if (bucket < (size_t{1} << kExactBits)) {
+        return bucket;
+    }
+    size_t octave = (bucket - (size_t{1} << kExactBits)) / kSubBuckets;
+    size_t sub_bucket = (bucket - (size_t{1} << kExactBits)) % kSubBuckets;
+    unsigned shift = static_cast<unsigned>(octave) + 1;  // exponent - (kExactBits - 1)
+    uint64_t lower = static_cast<uint64_t>(kSubBuckets + sub_bucket) << shift;
+    return lower + ((uint64_t{1} << shift) - 1);
+}
+
+}
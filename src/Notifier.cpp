@@ -5,25 +5,122 @@
 
 #include "Notifier.hpp"
 #include "Utils.hpp"
-#include <iostream>
+#include <algorithm>
+#include <cstring>
+#include <ctime>
 
 namespace scheduleit {
 
+Notifier::Notifier(NotifierOptions options)
+    : options_(std::move(options)),
+      rings_([capacity = options_.ring_capacity]() { return std::make_unique<Ring>(capacity); }),
+      writer_(options_.flush_interval, [this]() { drain(); }) {
+    writer_.start();
+}
+
+Notifier::~Notifier() {
+    writer_.stop();
+}
+
 void Notifier::onJobFailed(const Job& job, int attempt) {
-    std::cerr << "[Notifier] Job failed: " << job.getId()
-              << " | Attempt: " << attempt
-              << " | Time: " << utils::timestampToString(
-                   std::chrono::duration_cast<std::chrono::milliseconds>(
-                       utils::now().time_since_epoch()))
-              << '\n';
+    push(EventKind::Failure, job, attempt);
 }
 
 void Notifier::onJobSuccess(const Job& job) {
-    std::cout << "[Notifier] Job succeeded: " << job.getId()
-              << " | Time: " << utils::timestampToString(
-                   std::chrono::duration_cast<std::chrono::milliseconds>(
-                       utils::now().time_since_epoch()))
-              << '\n';
+    push(EventKind::Success, job, job.getAttempt());
+}
+
+void Notifier::onJobTimedOut(const Job& job, int attempt) {
+    push(EventKind::TimedOut, job, attempt);
+}
+
+void Notifier::push(EventKind kind, const Job& job, int attempt) {
+    Ring& ring = rings_.local();
+    Record* record = ring.records.claim();
+    while (!record) {
+        writer_.wake();
+        if (options_.drop_policy == NotifierDropPolicy::DropNewest) {
+            ring.dropped.store(ring.dropped.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+            return;
+        }
+        std::this_thread::yield();
+        record = ring.records.claim();
+    }
+
+    record->time_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(utils::now().time_since_epoch()).count();
+    record->attempt = attempt;
+    record->kind = kind;
+    const std::string& id = job.getId();
+    size_t id_size = std::min(id.size(), Record::kIdBytes);
+    std::memcpy(record->id, id.data(), id_size);
+    record->id_size = static_cast<uint8_t>(id_size);
+    record->id_truncated = id_size < id.size();
+
+    // Wake the writer early once the ring is half full, rather than waiting for its timer.
+    if (ring.records.commit() == ring.records.capacity() / 2) {
+        writer_.wake();
+    }
 }
 
-}
\ No newline at end of file
+void Notifier::flush() {
+    writer_.flush();
+}
+
+uint64_t Notifier::getDroppedCount() const {
+    uint64_t dropped = 0;
+    rings_.forEach([&dropped](const Ring& ring) { dropped += ring.dropped.load(std::memory_order_relaxed); });
+    return dropped;
+}
+
+bool Notifier::drain() {
+    uint64_t count = 0;
+    rings_.collect(drain_rings_);
+    for (Ring* ring : drain_rings_) {
+        count += ring->records.consume([this](const Record* records, size_t span) {
+            for (const Record* record = records; record != records + span; ++record) {
+                format(*record);
+            }
+        });
+    }
+    if (!out_buffer_.empty()) {
+        options_.out->write(out_buffer_.data(), static_cast<std::streamsize>(out_buffer_.size()));
+        options_.out->flush();
+        out_buffer_.clear();
+    }
+    if (!err_buffer_.empty()) {
+        options_.err->write(err_buffer_.data(), static_cast<std::streamsize>(err_buffer_.size()));
+        options_.err->flush();
+        err_buffer_.clear();
+    }
+    written_.fetch_add(count, std::memory_order_relaxed);
+    return count > 0;
+}
+
+void Notifier::format(const Record& record) {
+    int64_t second = record.time_ns / 1000000000;
+    if (second != cached_second_) {
+        std::time_t time = static_cast<std::time_t>(second);
+        std::tm local{};
+        localtime_r(&time, &local);
+        char buf[32];
+        cached_timestamp_.assign(buf, std::strftime(buf, sizeof(buf), "%F %T", &local));
+        cached_second_ = second;
+    }
+    std::string& out = record.kind == EventKind::Success ? out_buffer_ : err_buffer_;
+    out += record.kind == EventKind::Success  ? "[Notifier] Job succeeded: "
+           : record.kind == EventKind::Failure ? "[Notifier] Job failed: "
+                                               : "[Notifier] Job timed out: ";
+    out.append(record.id, record.id_size);
+    if (record.id_truncated) {
+        out += "...";
+    }
+    if (record.kind != EventKind::Success) {
+        out += " | Attempt: ";
+        out += std::to_string(record.attempt);
+    }
+    out += " | Time: ";
+    out += cached_timestamp_;
+    out += '\n';
+}
+
+}
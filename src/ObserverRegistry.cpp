@@ -0,0 +1,315 @@
+/**
+ * @file ObserverRegistry.cpp
+ * @brief Implements the ObserverRegistry class.
+ */
+
+#include "ObserverRegistry.hpp"
+#include "Utils.hpp"
+#include <algorithm>
+#include <iostream>
+#include <limits>
+
+namespace scheduleit {
+
+/// Keeps the snapshot it loaded alive until it goes out of scope. Wait-free.
+class ObserverRegistry::ReadSection {
+public:
+    explicit ReadSection(ObserverRegistry& registry) : reader_(registry.readers_.local()) {
+        if (reader_.depth++ == 0) {
+            // Sequentially consistent with the writer's swap and epoch scan: either the writer
+            // sees this epoch, or this thread sees the writer's new snapshot.
+            reader_.epoch.exchange(registry.epoch_.load(std::memory_order_acquire), std::memory_order_seq_cst);
+        }
+        snapshot_ = registry.current_.load(std::memory_order_seq_cst);
+    }
+
+    ~ReadSection() {
+        if (--reader_.depth == 0) {
+            reader_.epoch.store(0, std::memory_order_release);
+        }
+    }
+
+    ReadSection(const ReadSection&) = delete;
+    ReadSection& operator=(const ReadSection&) = delete;
+
+    const Snapshot* snapshot() const {
+        return snapshot_;
+    }
+
+    Reader& reader() const {
+        return reader_;
+    }
+
+private:
+    Reader& reader_;
+    const Snapshot* snapshot_;
+};
+
+ObserverRegistry::ObserverRegistry(ObserverRegistryOptions options)
+    : options_(options),
+      readers_([capacity = options.batch_capacity]() { return std::make_unique<Reader>(capacity); }),
+      delivery_(options.batch_interval, [this]() { deliver(); }) {}
+
+ObserverRegistry::~ObserverRegistry() {
+    delivery_.stop();
+    delete current_.load();
+    for (const auto& retired : retired_) {
+        delete retired.first;
+    }
+}
+
+void ObserverRegistry::add(std::shared_ptr<Observer> observer) {
+    if (!observer) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    const Snapshot* current = current_.load();
+    auto next = current ? std::make_unique<Snapshot>(*current) : std::make_unique<Snapshot>();
+    next->observers.push_back(std::move(observer));
+    publish(std::move(next));
+    reclaim();
+}
+
+void ObserverRegistry::add(std::shared_ptr<BatchObserver> observer) {
+    if (!observer) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    const Snapshot* current = current_.load();
+    auto next = current ? std::make_unique<Snapshot>(*current) : std::make_unique<Snapshot>();
+    next->batch_observers.push_back(std::move(observer));
+    if (!delivery_.running()) {
+        delivery_.start();
+    }
+    publish(std::move(next));
+    reclaim();
+}
+
+template <class Edit>
+bool ObserverRegistry::removeWhere(Edit edit) {
+    uint64_t epoch;
+    std::vector<Reader*> others;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        const Snapshot* current = current_.load();
+        if (!current) {
+            return false;
+        }
+        auto next = std::make_unique<Snapshot>(*current);
+        if (!edit(*next)) {
+            return false;
+        }
+        epoch = publish(std::move(next));
+        // A callback removing an observer is itself inside a read section; skip its own slot.
+        Reader* self = readers_.find();
+        readers_.forEach([&others, self](Reader& reader) {
+            if (&reader != self) {
+                others.push_back(&reader);
+            }
+        });
+    }
+    // Wait without the lock, so callbacks that add observers meanwhile do not deadlock.
+    for (Reader* reader : others) {
+        while (true) {
+            uint64_t entered = reader->epoch.load(std::memory_order_seq_cst);
+            if (entered == 0 || entered >= epoch) {
+                break;
+            }
+            std::this_thread::yield();
+        }
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    reclaim();
+    return true;
+}
+
+bool ObserverRegistry::remove(const std::shared_ptr<Observer>& observer) {
+    return removeWhere([&](Snapshot& snapshot) {
+        auto it = std::find(snapshot.observers.begin(), snapshot.observers.end(), observer);
+        if (it == snapshot.observers.end()) {
+            return false;
+        }
+        snapshot.observers.erase(it);
+        return true;
+    });
+}
+
+bool ObserverRegistry::remove(const std::shared_ptr<BatchObserver>& observer) {
+    return removeWhere([&](Snapshot& snapshot) {
+        auto it = std::find(snapshot.batch_observers.begin(), snapshot.batch_observers.end(), observer);
+        if (it == snapshot.batch_observers.end()) {
+            return false;
+        }
+        snapshot.batch_observers.erase(it);
+        return true;
+    });
+}
+
+uint64_t ObserverRegistry::publish(std::unique_ptr<Snapshot> next) {
+    if (next->observers.empty() && next->batch_observers.empty()) {
+        next.reset();  // lets notify skip the read section entirely
+    }
+    const Snapshot* old = current_.exchange(next.release(), std::memory_order_seq_cst);
+    uint64_t epoch = epoch_.fetch_add(1, std::memory_order_seq_cst) + 1;
+    if (old) {
+        retired_.emplace_back(old, epoch);
+    }
+    return epoch;
+}
+
+void ObserverRegistry::reclaim() {
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    // A snapshot retired at an epoch no active reader entered before is unreachable.
+    uint64_t oldest = std::numeric_limits<uint64_t>::max();
+    readers_.forEach([&oldest](const Reader& reader) {
+        uint64_t entered = reader.epoch.load(std::memory_order_seq_cst);
+        if (entered != 0) {
+            oldest = std::min(oldest, entered);
+        }
+    });
+    retired_.erase(std::remove_if(retired_.begin(), retired_.end(),
+                                  [&](const std::pair<const Snapshot*, uint64_t>& retired) {
+                                      if (oldest < retired.second) {
+                                          return false;
+                                      }
+                                      delete retired.first;
+                                      return true;
+                                  }),
+                   retired_.end());
+}
+
+void ObserverRegistry::notifySuccess(const std::shared_ptr<Job>& job) {
+    if (!current_.load(std::memory_order_relaxed)) {
+        return;
+    }
+    ReadSection section(*this);
+    const Snapshot* snapshot = section.snapshot();
+    if (!snapshot) {
+        return;
+    }
+    for (const auto& observer : snapshot->observers) {
+        observer->onJobSuccess(*job);
+    }
+    if (!snapshot->batch_observers.empty()) {
+        pushEvent(section.reader(), JobEventKind::Succeeded, job, job->getAttempt());
+    }
+}
+
+void ObserverRegistry::notifyFailure(const std::shared_ptr<Job>& job, int attempt) {
+    if (!current_.load(std::memory_order_relaxed)) {
+        return;
+    }
+    ReadSection section(*this);
+    const Snapshot* snapshot = section.snapshot();
+    if (!snapshot) {
+        return;
+    }
+    for (const auto& observer : snapshot->observers) {
+        observer->onJobFailed(*job, attempt);
+    }
+    if (!snapshot->batch_observers.empty()) {
+        pushEvent(section.reader(), JobEventKind::Failed, job, attempt);
+    }
+}
+
+void ObserverRegistry::notifyCancelled(const std::shared_ptr<Job>& job) {
+    if (!current_.load(std::memory_order_relaxed)) {
+        return;
+    }
+    ReadSection section(*this);
+    const Snapshot* snapshot = section.snapshot();
+    if (!snapshot) {
+        return;
+    }
+    for (const auto& observer : snapshot->observers) {
+        observer->onJobCancelled(*job);
+    }
+    if (!snapshot->batch_observers.empty()) {
+        pushEvent(section.reader(), JobEventKind::Cancelled, job, job->getAttempt());
+    }
+}
+
+void ObserverRegistry::notifyExpired(const std::shared_ptr<Job>& job) {
+    if (!current_.load(std::memory_order_relaxed)) {
+        return;
+    }
+    ReadSection section(*this);
+    const Snapshot* snapshot = section.snapshot();
+    if (!snapshot) {
+        return;
+    }
+    for (const auto& observer : snapshot->observers) {
+        observer->onJobExpired(*job);
+    }
+    if (!snapshot->batch_observers.empty()) {
+        pushEvent(section.reader(), JobEventKind::Expired, job, job->getAttempt());
+    }
+}
+
+void ObserverRegistry::notifyTimedOut(const std::shared_ptr<Job>& job, int attempt) {
+    if (!current_.load(std::memory_order_relaxed)) {
+        return;
+    }
+    ReadSection section(*this);
+    const Snapshot* snapshot = section.snapshot();
+    if (!snapshot) {
+        return;
+    }
+    for (const auto& observer : snapshot->observers) {
+        observer->onJobTimedOut(*job, attempt);
+    }
+    if (!snapshot->batch_observers.empty()) {
+        pushEvent(section.reader(), JobEventKind::TimedOut, job, attempt);
+    }
+}
+
+void ObserverRegistry::pushEvent(Reader& reader, JobEventKind kind, const std::shared_ptr<Job>& job, int attempt) {
+    JobEvent* event = reader.events.claim();
+    while (!event) {
+        delivery_.wake();
+        std::this_thread::yield();
+        event = reader.events.claim();
+    }
+    *event = JobEvent{kind, attempt, utils::now(), job};
+
+    // Wake the delivery thread early once the ring is half full.
+    if (reader.events.commit() == reader.events.capacity() / 2) {
+        delivery_.wake();
+    }
+}
+
+void ObserverRegistry::flush() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!delivery_.running()) {
+            return;
+        }
+    }
+    delivery_.flush();
+}
+
+void ObserverRegistry::deliver() {
+    readers_.collect(delivery_readers_);
+    ReadSection section(*this);
+    const Snapshot* snapshot = section.snapshot();
+    for (Reader* reader : delivery_readers_) {
+        reader->events.consume([snapshot](JobEvent* events, size_t count) {
+            if (snapshot) {
+                for (const auto& observer : snapshot->batch_observers) {
+                    try {
+                        observer->onJobEvents(events, count);
+                    } catch (const std::exception& e) {
+                        std::cerr << "[ObserverRegistry] Batch observer threw: " << e.what() << '\n';
+                    } catch (...) {
+                        std::cerr << "[ObserverRegistry] Batch observer threw unknown exception.\n";
+                    }
+                }
+            }
+            for (size_t i = 0; i < count; ++i) {
+                events[i].job.reset();
+            }
+        });
+    }
+}
+
+}
@@ -0,0 +1,60 @@
+/**
+ * @file PerThread.cpp
+ * @brief Implements the DrainThread class.
+ */
+
+#include "PerThread.hpp"
+
+namespace scheduleit {
+
+DrainThread::DrainThread(std::chrono::milliseconds interval, std::function<void()> drain)
+    : interval_(interval), drain_(std::move(drain)) {}
+
+DrainThread::~DrainThread() {
+    stop();
+}
+
+void DrainThread::start() {
+    thread_ = std::thread([this]() { run(); });
+}
+
+void DrainThread::flush() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    uint64_t ticket = ++flush_requested_;
+    cv_.notify_one();
+    flushed_cv_.wait(lock, [&]() { return flush_completed_ >= ticket; });
+}
+
+void DrainThread::stop() {
+    if (!thread_.joinable()) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    cv_.notify_one();
+    thread_.join();
+}
+
+void DrainThread::run() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+        uint64_t ticket = flush_requested_;
+        bool stopping = stopping_;
+        lock.unlock();
+        wake_pending_.store(false, std::memory_order_relaxed);
+        drain_();
+        lock.lock();
+        flush_completed_ = ticket;
+        flushed_cv_.notify_all();
+        if (stopping) {
+            return;
+        }
+        cv_.wait_for(lock, interval_, [&]() {
+            return stopping_ || flush_requested_ != flush_completed_ || wake_pending_.load(std::memory_order_relaxed);
+        });
+    }
+}
+
+}
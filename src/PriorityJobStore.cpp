@@ -0,0 +1,234 @@
+/**
+ * @file PriorityJobStore.cpp
+ * @brief Implements the PriorityJobStore class.
+ */
+
+#include "PriorityJobStore.hpp"
+#include <algorithm>
+#include <iterator>
+#include <stdexcept>
+
+namespace scheduleit {
+
+namespace {
+
+size_t classOf(const Job& job) {
+    return static_cast<size_t>(job.getPriority());
+}
+
+// Heap order for EarliestDeadlineFirst: true if a leaves after b.
+bool laterDeadline(const std::shared_ptr<Job>& a, const std::shared_ptr<Job>& b) {
+    if (a->getDeadline() != b->getDeadline()) {
+        return a->getDeadline() > b->getDeadline();
+    }
+    return a->getScheduledTime() > b->getScheduledTime();
+}
+
+}
+
+PriorityJobStore::PriorityJobStore(std::unique_ptr<JobStore> inner,
+                                   PriorityPolicy policy,
+                                   const std::array<unsigned, kJobPriorityCount>& weights,
+                                   std::chrono::milliseconds aging)
+    : inner_(std::move(inner)),
+      policy_(policy),
+      aging_(std::chrono::duration_cast<Job::TimePoint::duration>(aging)) {
+    if (policy_ == PriorityPolicy::None) {
+        throw std::invalid_argument("PriorityJobStore needs a priority policy");
+    }
+    for (size_t i = 0; i < kJobPriorityCount; ++i) {
+        weights_[i] = std::max<int64_t>(weights[i], 1);
+    }
+}
+
+void PriorityJobStore::push(std::shared_ptr<Job> job) {
+    ++stats_[classOf(*job)].queued;
+    inner_->push(std::move(job));
+}
+
+void PriorityJobStore::pushBatch(std::vector<std::shared_ptr<Job>>& jobs) {
+    for (const auto& job : jobs) {
+        ++stats_[classOf(*job)].queued;
+    }
+    inner_->pushBatch(jobs);
+}
+
+std::shared_ptr<Job> PriorityJobStore::popReady(Job::TimePoint now) {
+    bool by_deadline = policy_ == PriorityPolicy::EarliestDeadlineFirst;
+    while (auto due = inner_->popReady(now)) {
+        if (by_deadline) {
+            heap_wake_ = std::min(heap_wake_, due->getScheduledTime());
+            deadline_heap_.push_back(std::move(due));
+            std::push_heap(deadline_heap_.begin(), deadline_heap_.end(), laterDeadline);
+        } else {
+            ready_[classOf(*due)].push_back(std::move(due));
+        }
+        ++ready_count_;
+    }
+    if (ready_count_ == 0) {
+        return nullptr;
+    }
+
+    std::shared_ptr<Job> job;
+    if (by_deadline) {
+        job = popEarliestDeadline();
+        if (isStale(*job) || job->getScheduledTime() > now) {
+            --stats_[classOf(*job)].queued;
+            return job;
+        }
+    } else {
+        // Hand stale entries back first, so a cancelled job never uses up its class's turn.
+        if (auto stale = popStaleHead(now)) {
+            return stale;
+        }
+        size_t chosen = policy_ == PriorityPolicy::WeightedFair ? pickWeighted() : pickStrict(now);
+        job = std::move(ready_[chosen].front());
+        ready_[chosen].pop_front();
+        --ready_count_;
+    }
+
+    auto& stats = stats_[classOf(*job)];
+    --stats.queued;
+    ++stats.dequeued;
+    auto wait = std::chrono::duration_cast<std::chrono::nanoseconds>(now - job->getScheduledTime());
+    if (wait.count() > 0) {
+        stats.total_wait += wait;
+        stats.max_wait = std::max(stats.max_wait, wait);
+    }
+    return job;
+}
+
+std::shared_ptr<Job> PriorityJobStore::popStaleHead(Job::TimePoint now) {
+    for (size_t i = 0; i < kJobPriorityCount; ++i) {
+        if (ready_[i].empty()) {
+            continue;
+        }
+        const Job& head = *ready_[i].front();
+        if (isStale(head) || head.getScheduledTime() > now) {
+            auto job = std::move(ready_[i].front());
+            ready_[i].pop_front();
+            --ready_count_;
+            --stats_[i].queued;
+            return job;
+        }
+    }
+    return nullptr;
+}
+
+std::shared_ptr<Job> PriorityJobStore::popEarliestDeadline() {
+    std::pop_heap(deadline_heap_.begin(), deadline_heap_.end(), laterDeadline);
+    auto job = std::move(deadline_heap_.back());
+    deadline_heap_.pop_back();
+    --ready_count_;
+    if (deadline_heap_.empty()) {
+        heap_wake_ = Job::TimePoint::max();
+    }
+    return job;
+}
+
+size_t PriorityJobStore::pickWeighted() {
+    // Smooth weighted round robin: every backlogged class earns its weight, the richest class
+    // is served and pays back the total, so service interleaves in proportion to weight.
+    int64_t total = 0;
+    size_t best = kJobPriorityCount;
+    for (size_t i = 0; i < kJobPriorityCount; ++i) {
+        if (ready_[i].empty()) {
+            credit_[i] = 0;
+            continue;
+        }
+        credit_[i] += weights_[i];
+        total += weights_[i];
+        if (best == kJobPriorityCount || credit_[i] > credit_[best]) {
+            best = i;
+        }
+    }
+    credit_[best] -= total;
+    return best;
+}
+
+size_t PriorityJobStore::pickStrict(Job::TimePoint now) {
+    size_t highest = kJobPriorityCount;
+    for (size_t i = 0; i < kJobPriorityCount && highest == kJobPriorityCount; ++i) {
+        if (!ready_[i].empty()) {
+            highest = i;
+        }
+    }
+
+    // An aged lower-class head may take every other dequeue, so aging bounds starvation
+    // without letting an aged backlog lock out the higher classes.
+    if (!last_pick_aged_) {
+        size_t oldest = kJobPriorityCount;
+        for (size_t i = highest + 1; i < kJobPriorityCount; ++i) {
+            if (ready_[i].empty() || now - ready_[i].front()->getScheduledTime() < aging_) {
+                continue;
+            }
+            if (oldest == kJobPriorityCount ||
+                ready_[i].front()->getScheduledTime() < ready_[oldest].front()->getScheduledTime()) {
+                oldest = i;
+            }
+        }
+        if (oldest != kJobPriorityCount) {
+            last_pick_aged_ = true;
+            return oldest;
+        }
+    }
+    last_pick_aged_ = false;
+    return highest;
+}
+
+Job::TimePoint PriorityJobStore::nextWakeTime() const {
+    if (ready_count_ == 0) {
+        return inner_->nextWakeTime();
+    }
+    if (policy_ == PriorityPolicy::EarliestDeadlineFirst) {
+        return heap_wake_;
+    }
+    auto earliest = Job::TimePoint::max();
+    for (const auto& queue : ready_) {
+        if (!queue.empty()) {
+            earliest = std::min(earliest, queue.front()->getScheduledTime());
+        }
+    }
+    return earliest;
+}
+
+void PriorityJobStore::removeStale(std::vector<std::shared_ptr<Job>>& removed) {
+    size_t first = removed.size();
+    inner_->removeStale(removed);
+    for (auto& queue : ready_) {
+        auto live_end = std::stable_partition(queue.begin(), queue.end(), [](const std::shared_ptr<Job>& job) {
+            return !isStale(*job);
+        });
+        ready_count_ -= static_cast<size_t>(queue.end() - live_end);
+        std::move(live_end, queue.end(), std::back_inserter(removed));
+        queue.erase(live_end, queue.end());
+    }
+    if (!deadline_heap_.empty()) {
+        auto live_end = std::partition(deadline_heap_.begin(), deadline_heap_.end(),
+                                       [](const std::shared_ptr<Job>& job) { return !isStale(*job); });
+        ready_count_ -= static_cast<size_t>(deadline_heap_.end() - live_end);
+        std::move(live_end, deadline_heap_.end(), std::back_inserter(removed));
+        deadline_heap_.erase(live_end, deadline_heap_.end());
+        std::make_heap(deadline_heap_.begin(), deadline_heap_.end(), laterDeadline);
+    }
+    for (size_t i = first; i < removed.size(); ++i) {
+        --stats_[classOf(*removed[i])].queued;
+    }
+}
+
+size_t PriorityJobStore::size() const {
+    return inner_->size() + ready_count_;
+}
+
+PriorityStats PriorityJobStore::stats() const {
+    PriorityStats result = stats_;
+    for (size_t i = 0; i < kJobPriorityCount; ++i) {
+        result[i].ready = ready_[i].size();
+    }
+    for (const auto& job : deadline_heap_) {
+        ++result[classOf(*job)].ready;
+    }
+    return result;
+}
+
+}
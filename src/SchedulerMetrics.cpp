@@ -0,0 +1,67 @@
+/**
+ * @file SchedulerMetrics.cpp
+ * @brief Implements SchedulerMetrics.
+ */
+
+#include "SchedulerMetrics.hpp"
+#include <algorithm>
+
+namespace scheduleit {
+
+namespace {
+
+uint64_t nanosBetween(Job::TimePoint from, Job::TimePoint to) {
+    auto nanos = std::chrono::duration_cast<std::chrono::nanoseconds>(to - from).count();
+    return nanos > 0 ? static_cast<uint64_t>(nanos) : 0;
+}
+
+}
+
+void MetricsSnapshot::merge(const MetricsSnapshot& other) {
+    queue_wait.merge(other.queue_wait);
+    dispatch_lag.merge(other.dispatch_lag);
+    execution.merge(other.execution);
+    retries.merge(other.retries);
+}
+
+SchedulerMetrics::SchedulerMetrics() = default;
+
+void SchedulerMetrics::recordStart(const Job& job, Job::TimePoint started) {
+    Worker& worker = workers_.local();
+    auto queued = job.getEnqueuedTime();
+    auto ready = std::max(job.getScheduledTime(), queued);
+    worker.queue_wait.record(nanosBetween(queued, ready));
+    worker.dispatch_lag.record(nanosBetween(ready, started));
+}
+
+void SchedulerMetrics::recordExecution(std::chrono::nanoseconds duration) {
+    workers_.local().execution.record(duration.count() > 0 ? static_cast<uint64_t>(duration.count()) : 0);
+}
+
+void SchedulerMetrics::recordRetries(int retries) {
+    workers_.local().retries.record(retries > 0 ? static_cast<uint64_t>(retries) : 0);
+}
+
+void SchedulerMetrics::addTo(const Worker& worker, MetricsSnapshot& snapshot) {
+    worker.queue_wait.snapshotInto(snapshot.queue_wait);
+    worker.dispatch_lag.snapshotInto(snapshot.dispatch_lag);
+    worker.execution.snapshotInto(snapshot.execution);
+    worker.retries.snapshotInto(snapshot.retries);
+}
+
+MetricsSnapshot SchedulerMetrics::snapshot() const {
+    MetricsSnapshot merged;
+    workers_.forEach([&merged](const Worker& worker) { addTo(worker, merged); });
+    return merged;
+}
+
+std::vector<MetricsSnapshot> SchedulerMetrics::snapshotWorkers() const {
+    std::vector<MetricsSnapshot> snapshots;
+    workers_.forEach([&snapshots](const Worker& worker) {
+        snapshots.emplace_back();
+        addTo(worker, snapshots.back());
+    });
+    return snapshots;
+}
+
+}
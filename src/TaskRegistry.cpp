@@ -0,0 +1,36 @@
+/**
+ * @file TaskRegistry.cpp
+ * @brief Implements the TaskRegistry class.
+ */
+
+#include "TaskRegistry.hpp"
+#include <stdexcept>
+
+namespace scheduleit {
+
+void TaskRegistry::add(const std::string& name, Factory factory, std::shared_ptr<RetryStrategy> retry_strategy) {
+    if (name.empty() || !factory) {
+        throw std::invalid_argument("TaskRegistry needs a name and a factory");
+    }
+    entries_[name] = Entry{std::move(factory), std::move(retry_strategy)};
+}
+
+bool TaskRegistry::contains(const std::string& name) const {
+    return entries_.count(name) > 0;
+}
+
+std::shared_ptr<Job> TaskRegistry::create(const std::string& name,
+                                          std::string payload,
+                                          std::chrono::milliseconds delay,
+                                          int max_retries,
+                                          std::string id) const {
+    auto it = entries_.find(name);
+    if (it == entries_.end()) {
+        throw std::invalid_argument("TaskRegistry has no task named '" + name + "'");
+    }
+    auto job = Job::create(std::move(id), it->second.factory(payload), it->second.retry_strategy, delay, max_retries);
+    job->setDurableTask(name, std::move(payload));
+    return job;
+}
+
+}
@@ -6,19 +6,150 @@
 #include "ThreadPool.hpp"
 #include <iostream>
 #include <future>
+#include <algorithm>
 #include <chrono>
+#include <random>
+#include <stdexcept>
+#include <unordered_map>
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <time.h>
+#endif
 
 namespace scheduleit {
 
+namespace {
+
+// Identifies the pool and deque owned by the current thread, if it is a work-stealing worker.
+thread_local ThreadPool* current_pool = nullptr;
+thread_local size_t current_index = 0;
+thread_local size_t current_node = CpuTopology::kAnyNode;
+
+// CPU time a thread has used so far; zero where it cannot be read.
+std::chrono::nanoseconds threadCpuTime(std::thread& thread) {
+#if defined(__linux__)
+    clockid_t clock;
+    timespec used;
+    if (pthread_getcpuclockid(thread.native_handle(), &clock) == 0 && clock_gettime(clock, &used) == 0) {
+        return std::chrono::seconds(used.tv_sec) + std::chrono::nanoseconds(used.tv_nsec);
+    }
+#else
+    (void)thread;
+#endif
+    return std::chrono::nanoseconds(0);
+}
+
+}
+
+ThreadPool::Task* ThreadPool::newTaskNode(Task&& task) {
+    return ::new (TaskNodePool::allocate()) Task(std::move(task));
+}
+
+void ThreadPool::deleteTaskNode(Task* node) noexcept {
+    node->~Task();
+    TaskNodePool::deallocate(node);
+}
+
 ThreadPool::ThreadPool(size_t num_threads, size_t max_queue_size)
     : max_queue_size_(max_queue_size) {
-    for (size_t i = 0; i < num_threads; ++i) {
-        workers_.emplace_back([this]() { workerLoop(); });
-    }
+    start(num_threads, ThreadPoolOptions{});
+}
+
+ThreadPool::ThreadPool(size_t num_threads, const ThreadPoolOptions& options)
+    : max_queue_size_(options.max_queue_size),
+      work_stealing_(options.work_stealing || options.topology) {
+    start(num_threads, options);
 }
 
 ThreadPool::~ThreadPool() {
     shutdown();
+    for (auto& queue : local_queues_) {
+        Task* task = nullptr;
+        while (queue->deque.pop(task)) {
+            deleteTaskNode(task);
+        }
+    }
+}
+
+void ThreadPool::start(size_t num_threads, const ThreadPoolOptions& options) {
+    if (options.elastic.max_threads > 0) {
+        const ElasticOptions& elastic = options.elastic;
+        if (work_stealing_) {
+            throw std::invalid_argument("Elastic ThreadPool cannot use work stealing");
+        }
+        if (elastic.min_threads == 0 || elastic.min_threads > num_threads || num_threads > elastic.max_threads) {
+            throw std::invalid_argument("Elastic ThreadPool needs 1 <= min_threads <= num_threads <= max_threads");
+        }
+        if (elastic.interval.count() <= 0) {
+            throw std::invalid_argument("Elastic ThreadPool needs a positive interval");
+        }
+        is_elastic_ = true;
+        elastic_ = elastic;
+    }
+
+    std::shared_ptr<const CpuTopology> topology = options.topology;
+    if (!topology && options.pin_workers) {
+        topology = std::make_shared<CpuTopology>(CpuTopology::detect());
+    }
+    if (options.pin_workers) {
+        pin_topology_ = topology;
+    }
+    topology_ = options.topology;  // implies work stealing
+    // Without an explicit topology, pinning alone keeps a single ready queue.
+    size_t node_count = options.topology ? options.topology->getNodeCount() : 1;
+
+    if (work_stealing_) {
+        for (size_t node = 0; node < node_count; ++node) {
+            nodes_.push_back(std::make_unique<NodeQueue>());
+        }
+        local_queues_.resize(num_threads);
+    }
+
+    for (size_t i = 0; i < num_threads; ++i) {
+        if (!work_stealing_) {
+            spawnWorker();
+            continue;
+        }
+        size_t node = i % node_count;
+        int cpu = pin_topology_ ? pin_topology_->getCpuForWorker(i) : -1;
+        nodes_[node]->workers.push_back(i);
+        workers_.emplace_back([this, i, node, cpu, num_threads]() {
+            if (cpu >= 0 && CpuTopology::pinCurrentThread(cpu)) {
+                pinned_workers_.fetch_add(1);
+            }
+            // Allocated after pinning so that first touch puts the deque on the worker's node.
+            local_queues_[i] = std::make_unique<WorkerQueue>();
+            local_queues_[i]->node = node;
+            started_workers_.fetch_add(1);
+            while (started_workers_.load() < num_threads) {
+                std::this_thread::yield();
+            }
+            stealingWorkerLoop(i, node);
+        });
+    }
+    // Thieves index local_queues_ freely, so every deque must exist before any worker or
+    // submitter touches them.
+    while (started_workers_.load() < num_threads) {
+        std::this_thread::yield();
+    }
+    if (is_elastic_) {
+        elastic_stats_.workers = num_threads;
+        elastic_stats_.peak_workers = num_threads;
+        controller_ = std::thread([this]() { controlLoop(); });
+    }
+}
+
+void ThreadPool::spawnWorker() {
+    size_t index = next_worker_index_++;
+    int cpu = pin_topology_ ? pin_topology_->getCpuForWorker(index) : -1;
+    workers_.emplace_back([this, cpu]() {
+        if (cpu >= 0 && CpuTopology::pinCurrentThread(cpu)) {
+            pinned_workers_.fetch_add(1);
+        }
+        started_workers_.fetch_add(1);
+        workerLoop();
+    });
 }
 
 void ThreadPool::shutdown() {
@@ -27,7 +158,15 @@ void ThreadPool::shutdown() {
         stop_ = true;
     }
     condition_.notify_all();
+    for (auto& node : nodes_) {
+        node->wake.notify_all();
+    }
     queue_not_full_condition_.notify_all();
+    controller_wake_.notify_all();
+    // The controller adds and joins workers; stop it before joining the rest.
+    if (controller_.joinable()) {
+        controller_.join();
+    }
     for (auto& worker : workers_) {
         if (worker.joinable()) {
             worker.join();
@@ -37,13 +176,18 @@ void ThreadPool::shutdown() {
 
 void ThreadPool::workerLoop() {
     while (true) {
-        std::function<void()> task;
+        Task task;
 
         {
             std::unique_lock<std::mutex> lock(mutex_);
-            condition_.wait(lock, [this]() { return stop_ || !tasks_.empty(); });
+            condition_.wait(lock, [this]() { return stop_ || !tasks_.empty() || retire_ > 0; });
 
-            if (stop_ && tasks_.empty()) {
+            if (tasks_.empty()) {
+                if (!stop_) {
+                    // Told to retire by the elastic controller, which joins this thread.
+                    --retire_;
+                    retired_.push_back(std::this_thread::get_id());
+                }
                 return;
             }
 
@@ -52,16 +196,420 @@ void ThreadPool::workerLoop() {
             queue_not_full_condition_.notify_one();
         }
 
-        if (task) {
-            try {
-                task();
-            } catch (const std::exception& e) {
-                std::cerr << "[ThreadPool] Task threw exception: " << e.what() << '\n';
-            } catch (...) {
-                std::cerr << "[ThreadPool] Task threw unknown exception.\n";
+        if (is_elastic_) {
+            busy_.fetch_add(1, std::memory_order_relaxed);
+            runTask(task);
+            busy_.fetch_sub(1, std::memory_order_relaxed);
+        } else {
+            runTask(task);
+        }
+    }
+}
+
+void ThreadPool::controlLoop() {
+    using Clock = std::chrono::steady_clock;
+    const double cpus = std::max(1u, std::thread::hardware_concurrency());
+    const long grow_ticks = std::max<long>(1, elastic_.grow_after / elastic_.interval);
+    const long shrink_ticks = std::max<long>(1, elastic_.shrink_after / elastic_.interval);
+    long short_ticks = 0;  // consecutive samples short of workers
+    long idle_ticks = 0;   // consecutive samples with idle workers and nothing queued
+    std::unordered_map<std::thread::id, std::chrono::nanoseconds> cpu_seen;
+    auto last = Clock::now();
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+        controller_wake_.wait_for(lock, elastic_.interval, [this] { return stop_; });
+        if (stop_) {
+            return;
+        }
+
+        std::vector<std::thread> exited;
+        for (const auto& id : retired_) {
+            auto it = std::find_if(workers_.begin(), workers_.end(),
+                                   [&id](const std::thread& worker) { return worker.get_id() == id; });
+            exited.push_back(std::move(*it));
+            workers_.erase(it);
+            cpu_seen.erase(id);
+        }
+        retired_.clear();
+        elastic_stats_.threads_retired += exited.size();
+
+        auto now = Clock::now();
+        double elapsed = std::chrono::duration<double>(now - last).count();
+        last = now;
+        double cpu_seconds = 0;
+        for (auto& worker : workers_) {
+            auto used = threadCpuTime(worker);
+            auto& seen = cpu_seen[worker.get_id()];
+            if (used > seen) {
+                cpu_seconds += std::chrono::duration<double>(used - seen).count();
+            }
+            seen = used;
+        }
+
+        size_t size = workers_.size() - retire_;
+        size_t busy = std::min(busy_.load(std::memory_order_relaxed), size);
+        size_t queued = tasks_.size();
+        double cpu = elapsed > 0 ? cpu_seconds / elapsed : 0;
+
+        // Short of workers: tasks wait, everyone is busy, and a CPU is left unused.
+        bool short_of_workers = queued > 0 && busy >= size && size < elastic_.max_threads && cpu + 0.5 < cpus;
+        bool idle = queued == 0 && busy < size && size > elastic_.min_threads;
+        short_ticks = short_of_workers ? short_ticks + 1 : 0;
+        idle_ticks = idle ? idle_ticks + 1 : 0;
+
+        if (short_ticks >= grow_ticks) {
+            // At most double per decision, and never more than there are tasks waiting.
+            size_t add = std::min({elastic_.max_threads - size, queued, size});
+            // Take back retirements not yet carried out before starting threads.
+            size_t kept = std::min(retire_, add);
+            retire_ -= kept;
+            for (size_t i = kept; i < add; ++i) {
+                spawnWorker();
             }
+            size += add;
+            elastic_stats_.threads_started += add - kept;
+            ++elastic_stats_.grow_decisions;
+            short_ticks = 0;
+        } else if (idle_ticks >= shrink_ticks) {
+            size_t remove = std::min(std::max<size_t>(1, (size - busy) / 2), size - elastic_.min_threads);
+            retire_ += remove;
+            size -= remove;
+            condition_.notify_all();
+            ++elastic_stats_.shrink_decisions;
+            idle_ticks = 0;
         }
+
+        elastic_stats_.workers = size;
+        elastic_stats_.busy = busy;
+        elastic_stats_.queued = queued;
+        elastic_stats_.cpu = cpu;
+        elastic_stats_.blocked = std::max(0.0, static_cast<double>(busy) - cpu);
+        elastic_stats_.peak_workers = std::max(elastic_stats_.peak_workers, size);
+
+        if (!exited.empty()) {
+            lock.unlock();
+            for (auto& worker : exited) {
+                worker.join();
+            }
+            lock.lock();
+        }
+    }
+}
+
+size_t ThreadPool::getQueuedTasks() const {
+    if (work_stealing_) {
+        return queued_.load();
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    return tasks_.size();
+}
+
+ElasticStats ThreadPool::getElasticStats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return elastic_stats_;
+}
+
+void ThreadPool::runTask(Task& task) {
+    if (task) {
+        try {
+            task();
+        } catch (const std::exception& e) {
+            std::cerr << "[ThreadPool] Task threw exception: " << e.what() << '\n';
+        } catch (...) {
+            std::cerr << "[ThreadPool] Task threw unknown exception.\n";
+        }
+    }
+}
+
+size_t ThreadPool::currentNode() {
+    if (current_pool && current_pool->topology_) {
+        return current_pool->topology_->getNodeId(current_node);
+    }
+    return current_node;
+}
+
+size_t ThreadPool::nodeIndex(size_t node) const {
+    if (node == CpuTopology::kAnyNode || !topology_) {
+        return CpuTopology::kAnyNode;
+    }
+    size_t index = topology_->findNode(node);
+    if (index == CpuTopology::kAnyNode) {
+        throw std::invalid_argument("ThreadPool topology has no NUMA node " + std::to_string(node));
     }
+    return index;
 }
 
-}
\ No newline at end of file
+void ThreadPool::enqueueStealing(Task task, size_t node) {
+    node = nodeIndex(node);
+    if (current_pool == this && (node == CpuTopology::kAnyNode || node == current_node)) {
+        // Caller-runs when full: a worker blocking on its own pool could deadlock it.
+        if (reserveQueued(1) == 0) {
+            runTask(task);
+            return;
+        }
+        local_queues_[current_index]->deque.push(newTaskNode(std::move(task)));
+        if (sleepers_.load() > 0) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            wakeNodes(current_node, 1);
+        }
+        return;
+    }
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (stop_) {
+        throw std::runtime_error("ThreadPool is stopped");
+    }
+    if (reserveQueued(1) == 0) {
+        if (current_pool == this) {
+            lock.unlock();
+            runTask(task);
+            return;
+        }
+        blocked_submitters_.fetch_add(1);
+        queue_not_full_condition_.wait(lock, [this] { return stop_ || reserveQueued(1) > 0; });
+        blocked_submitters_.fetch_sub(1);
+        if (stop_) {
+            throw std::runtime_error("ThreadPool is stopped");
+        }
+    }
+    inject(&task, 1, node);
+}
+
+void ThreadPool::enqueueBulk(std::vector<Task>& tasks, size_t node) {
+    if (tasks.empty()) {
+        return;
+    }
+    if (work_stealing_) {
+        node = nodeIndex(node);
+    }
+    if (work_stealing_ && current_pool == this && (node == CpuTopology::kAnyNode || node == current_node)) {
+        auto& deque = local_queues_[current_index]->deque;
+        size_t pushed = 0;
+        for (auto& task : tasks) {
+            if (reserveQueued(1) == 0) {
+                runTask(task);
+                continue;
+            }
+            deque.push(newTaskNode(std::move(task)));
+            ++pushed;
+        }
+        if (pushed > 0 && sleepers_.load() > 0) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            wakeNodes(current_node, pushed);
+        }
+        return;
+    }
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (work_stealing_) {
+        size_t next = 0;
+        while (next < tasks.size()) {
+            if (stop_) {
+                throw std::runtime_error("ThreadPool is stopped");
+            }
+            size_t room = reserveQueued(tasks.size() - next);
+            if (room == 0) {
+                if (current_pool == this) {
+                    // A worker must not block on its own pool; run the rest inline.
+                    lock.unlock();
+                    for (; next < tasks.size(); ++next) {
+                        runTask(tasks[next]);
+                    }
+                    return;
+                }
+                blocked_submitters_.fetch_add(1);
+                queue_not_full_condition_.wait(lock, [this] { return stop_ || queued_.load() < max_queue_size_; });
+                blocked_submitters_.fetch_sub(1);
+                continue;
+            }
+            inject(&tasks[next], room, node);
+            next += room;
+        }
+        return;
+    }
+
+    size_t unannounced = 0;  // tasks added since workers were last woken
+    for (auto& task : tasks) {
+        if (stop_) {
+            throw std::runtime_error("ThreadPool is stopped");
+        }
+        if (max_queue_size_ > 0) {
+            auto has_room = [this] { return stop_ || tasks_.size() < max_queue_size_; };
+            if (!has_room()) {
+                // Let workers drain what this call has added so far before blocking on them.
+                wakeWorkers(unannounced);
+                unannounced = 0;
+                blocked_submitters_.fetch_add(1);
+                queue_not_full_condition_.wait(lock, has_room);
+                blocked_submitters_.fetch_sub(1);
+                if (stop_) {
+                    throw std::runtime_error("ThreadPool is stopped");
+                }
+            }
+        }
+        tasks_.push(std::move(task));
+        ++unannounced;
+    }
+    wakeWorkers(unannounced);
+}
+
+size_t ThreadPool::reserveQueued(size_t count) {
+    if (max_queue_size_ == 0) {
+        queued_.fetch_add(count);
+        return count;
+    }
+    // Every enqueue path reserves before it pushes, so queued_ never passes the bound, even
+    // with workers pushing onto their own deques without mutex_.
+    size_t current = queued_.load();
+    size_t taken;
+    do {
+        if (current >= max_queue_size_) {
+            return 0;
+        }
+        taken = std::min(count, max_queue_size_ - current);
+    } while (!queued_.compare_exchange_weak(current, current + taken));
+    return taken;
+}
+
+void ThreadPool::inject(Task* first, size_t count, size_t node) {
+    // Unhinted tasks are dealt out round-robin, in one chunk per node.
+    size_t targets = node == CpuTopology::kAnyNode ? std::min(count, nodes_.size()) : 1;
+    for (size_t t = 0; t < targets; ++t) {
+        size_t target = node;
+        if (node == CpuTopology::kAnyNode) {
+            target = next_node_;
+            next_node_ = (next_node_ + 1) % nodes_.size();
+        }
+        size_t chunk = count / targets + (t < count % targets ? 1 : 0);
+        NodeQueue& queue = *nodes_[target];
+        {
+            std::lock_guard<std::mutex> node_lock(queue.mutex);
+            for (size_t i = 0; i < chunk; ++i) {
+                queue.tasks.push(std::move(*first++));
+            }
+        }
+        queue.injected.fetch_add(chunk);
+        wakeNodes(target, chunk);
+    }
+}
+
+void ThreadPool::wakeWorkers(size_t count) {
+    if (count >= workers_.size()) {
+        condition_.notify_all();
+        return;
+    }
+    for (size_t i = 0; i < count; ++i) {
+        condition_.notify_one();
+    }
+}
+
+void ThreadPool::wakeNodes(size_t node, size_t count) {
+    if (sleepers_.load() == 0) {
+        return;
+    }
+    // Sleepers of the task's node first; the rest go to other nodes, which will steal it.
+    for (size_t i = 0; i < nodes_.size() && count > 0; ++i) {
+        NodeQueue& queue = *nodes_[(node + i) % nodes_.size()];
+        size_t woken = std::min(count, queue.sleepers);
+        if (woken == queue.sleepers) {
+            queue.wake.notify_all();
+        } else {
+            for (size_t n = 0; n < woken; ++n) {
+                queue.wake.notify_one();
+            }
+        }
+        count -= woken;
+    }
+}
+
+bool ThreadPool::takeInjected(size_t node, Task& task) {
+    NodeQueue& queue = *nodes_[node];
+    if (queue.injected.load() == 0) {
+        return false;
+    }
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    if (queue.tasks.empty()) {
+        return false;
+    }
+    task = std::move(queue.tasks.front());
+    queue.tasks.pop();
+    queue.injected.fetch_sub(1);
+    return true;
+}
+
+bool ThreadPool::stealFromNode(size_t node, size_t thief, Task*& taken) {
+    thread_local std::minstd_rand rng(std::random_device{}());
+    const auto& victims = nodes_[node]->workers;
+    size_t count = victims.size();
+    if (count == 0) {
+        return false;  // more nodes than workers
+    }
+    size_t start = rng() % count;
+    for (size_t i = 0; i < count; ++i) {
+        size_t victim = victims[(start + i) % count];
+        if (victim != thief && local_queues_[victim]->deque.steal(taken)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool ThreadPool::takeTask(size_t index, Task& task) {
+    Task* taken = nullptr;
+    size_t home = local_queues_[index]->node;
+    bool found = local_queues_[index]->deque.pop(taken) || takeInjected(home, task);
+
+    if (!found && stealFromNode(home, index, taken)) {
+        local_steals_.fetch_add(1, std::memory_order_relaxed);
+        found = true;
+    }
+    // Other nodes last, nearest first: their tasks touch memory that is remote to this worker.
+    for (size_t i = 1; i < nodes_.size() && !found; ++i) {
+        size_t node = (home + i) % nodes_.size();
+        if (takeInjected(node, task) || stealFromNode(node, index, taken)) {
+            remote_steals_.fetch_add(1, std::memory_order_relaxed);
+            found = true;
+        }
+    }
+
+    if (!found) {
+        return false;
+    }
+    if (taken) {
+        task = std::move(*taken);
+        deleteTaskNode(taken);
+    }
+    queued_.fetch_sub(1);
+    if (max_queue_size_ > 0 && blocked_submitters_.load() > 0) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        queue_not_full_condition_.notify_one();
+    }
+    return true;
+}
+
+void ThreadPool::stealingWorkerLoop(size_t index, size_t node) {
+    current_pool = this;
+    current_index = index;
+    current_node = node;
+    NodeQueue& home = *nodes_[node];
+    while (true) {
+        Task task;
+        if (takeTask(index, task)) {
+            runTask(task);
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(mutex_);
+        sleepers_.fetch_add(1);
+        ++home.sleepers;
+        home.wake.wait(lock, [this]() { return stop_ || queued_.load() > 0; });
+        --home.sleepers;
+        sleepers_.fetch_sub(1);
+        if (stop_ && queued_.load() == 0) {
+            return;
+        }
+    }
+}
+
+}
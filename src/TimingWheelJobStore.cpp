@@ -0,0 +1,259 @@
+/**
+ * @file TimingWheelJobStore.cpp
+ * @brief Implements the hierarchical timing wheel JobStore.
+ */
+
+#include "TimingWheelJobStore.hpp"
+#include <algorithm>
+#include <iterator>
+#include <stdexcept>
+
+namespace scheduleit {
+
+namespace {
+
+int lowestSetBit(uint64_t bits) {
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_ctzll(bits);
+#else
+    int index = 0;
+    while ((bits & 1) == 0) {
+        bits >>= 1;
+        ++index;
+    }
+    return index;
+#endif
+}
+
+}
+
+TimingWheelJobStore::TimingWheelJobStore(std::chrono::microseconds tick,
+                                         size_t levels,
+                                         Job::TimePoint origin)
+    : origin_(origin),
+      tick_(std::chrono::duration_cast<Job::TimePoint::duration>(tick)) {
+    if (tick_.count() <= 0) {
+        throw std::invalid_argument("TimingWheelJobStore tick must be positive");
+    }
+    if (levels == 0 || levels > kMaxLevels) {
+        throw std::invalid_argument("TimingWheelJobStore levels must be between 1 and 7");
+    }
+    levels_.resize(levels);
+}
+
+void TimingWheelJobStore::push(std::shared_ptr<Job> job) {
+    place(std::move(job));
+    ++size_;
+}
+
+std::shared_ptr<Job> TimingWheelJobStore::popReady(Job::TimePoint now) {
+    if (now >= origin_) {
+        advanceTo(elapsedTicks(now));
+    }
+    if (ready_.empty()) {
+        return nullptr;
+    }
+    auto job = std::move(ready_.front());
+    ready_.pop_front();
+    --size_;
+    return job;
+}
+
+Job::TimePoint TimingWheelJobStore::nextWakeTime() const {
+    if (!ready_.empty()) {
+        return ready_.front()->getScheduledTime();
+    }
+    return origin_ + tick_ * static_cast<Job::TimePoint::rep>(nextEventTick());
+}
+
+size_t TimingWheelJobStore::size() const {
+    return size_;
+}
+
+void TimingWheelJobStore::removeStale(std::vector<std::shared_ptr<Job>>& removed) {
+    size_t before = removed.size();
+    for (auto& level : levels_) {
+        for (size_t word = 0; word < level.occupied.size(); ++word) {
+            uint64_t bits = level.occupied[word];
+            while (bits != 0) {
+                size_t slot = word * 64 + static_cast<size_t>(lowestSetBit(bits));
+                bits &= bits - 1;
+                removeStaleFrom(level.slots[slot], removed);
+                if (level.slots[slot].empty()) {
+                    level.occupied[word] &= ~(uint64_t{1} << (slot % 64));
+                }
+            }
+        }
+    }
+    if (!overflow_.empty()) {
+        removeStaleFrom(overflow_, removed);
+        overflow_min_tick_ = kNoTick;
+        for (const auto& job : overflow_) {
+            overflow_min_tick_ = std::min(overflow_min_tick_, dueTick(job->getScheduledTime()));
+        }
+    }
+    removeStaleFrom(ready_, removed);
+    size_ -= removed.size() - before;
+    next_event_ = kUnknownTick;
+}
+
+template <class Container>
+void TimingWheelJobStore::removeStaleFrom(Container& jobs, std::vector<std::shared_ptr<Job>>& removed) {
+    auto live_end = std::stable_partition(jobs.begin(), jobs.end(), [](const std::shared_ptr<Job>& job) {
+        return !isStale(*job);
+    });
+    std::move(live_end, jobs.end(), std::back_inserter(removed));
+    jobs.erase(live_end, jobs.end());
+}
+
+uint64_t TimingWheelJobStore::dueTick(Job::TimePoint time) const {
+    if (time <= origin_) {
+        return 0;
+    }
+    auto offset = (time - origin_).count();
+    return static_cast<uint64_t>((offset + tick_.count() - 1) / tick_.count());
+}
+
+uint64_t TimingWheelJobStore::elapsedTicks(Job::TimePoint now) const {
+    return static_cast<uint64_t>((now - origin_).count() / tick_.count());
+}
+
+size_t TimingWheelJobStore::digit(uint64_t tick, size_t level) const {
+    return static_cast<size_t>((tick >> (level * kSlotBits)) & (kSlotsPerLevel - 1));
+}
+
+void TimingWheelJobStore::place(std::shared_ptr<Job> job) {
+    uint64_t due = dueTick(job->getScheduledTime());
+    if (due < current_) {
+        ready_.push_back(std::move(job));
+        return;
+    }
+
+    // The job goes on the level of the highest digit in which it differs from the current tick.
+    uint64_t diff = due ^ current_;
+    size_t level = 0;
+    while (level < levels_.size() && (diff >> ((level + 1) * kSlotBits)) != 0) {
+        ++level;
+    }
+    if (level == levels_.size()) {
+        overflow_min_tick_ = std::min(overflow_min_tick_, due);
+        overflow_.push_back(std::move(job));
+        if (next_event_ != kUnknownTick) {
+            size_t shift = levels_.size() * kSlotBits;
+            next_event_ = std::min(next_event_, (due >> shift) << shift);
+        }
+        return;
+    }
+
+    size_t slot = digit(due, level);
+    levels_[level].slots[slot].push_back(std::move(job));
+    levels_[level].occupied[slot / 64] |= uint64_t{1} << (slot % 64);
+
+    if (next_event_ != kUnknownTick) {
+        size_t shift = (level + 1) * kSlotBits;
+        uint64_t base = (current_ >> shift) << shift;
+        next_event_ = std::min(next_event_, base | (static_cast<uint64_t>(slot) << (level * kSlotBits)));
+    }
+}
+
+void TimingWheelJobStore::advanceTo(uint64_t target) {
+    while (current_ <= target) {
+        uint64_t next = nextEventTick();
+        if (next > target) {
+            moveCurrent(target + 1);
+            return;
+        }
+        moveCurrent(next);
+
+        size_t slot = digit(current_, 0);
+        if (levels_[0].occupied[slot / 64] & (uint64_t{1} << (slot % 64))) {
+            Slot expired;
+            drainSlot(0, slot, expired);
+            for (auto& job : expired) {
+                ready_.push_back(std::move(job));
+            }
+        }
+    }
+}
+
+void TimingWheelJobStore::moveCurrent(uint64_t tick) {
+    if (tick == current_) {
+        return;
+    }
+    uint64_t previous = current_;
+    current_ = tick;
+
+    // Only the slots the new tick points into can have become current, since advanceTo()
+    // never skips over an occupied slot. Cascade them top-down into the lower levels.
+    Slot cascaded;
+    size_t top_shift = levels_.size() * kSlotBits;
+    if (!overflow_.empty() && (tick >> top_shift) != (previous >> top_shift)) {
+        cascaded.swap(overflow_);
+        overflow_min_tick_ = kNoTick;
+        next_event_ = kUnknownTick;
+    }
+    for (size_t level = levels_.size() - 1; level > 0; --level) {
+        size_t slot = digit(tick, level);
+        if (levels_[level].occupied[slot / 64] & (uint64_t{1} << (slot % 64))) {
+            drainSlot(level, slot, cascaded);
+        }
+    }
+    for (auto& job : cascaded) {
+        place(std::move(job));
+    }
+}
+
+void TimingWheelJobStore::drainSlot(size_t level, size_t slot, Slot& out) {
+    auto& jobs = levels_[level].slots[slot];
+    if (out.empty()) {
+        out.swap(jobs);
+    } else {
+        std::move(jobs.begin(), jobs.end(), std::back_inserter(out));
+        jobs.clear();
+    }
+    levels_[level].occupied[slot / 64] &= ~(uint64_t{1} << (slot % 64));
+    next_event_ = kUnknownTick;
+}
+
+uint64_t TimingWheelJobStore::nextEventTick() const {
+    if (next_event_ == kUnknownTick) {
+        next_event_ = scanNextEventTick();
+    }
+    return next_event_;
+}
+
+uint64_t TimingWheelJobStore::scanNextEventTick() const {
+    // Occupied slots on a lower level always precede those on higher levels.
+    for (size_t level = 0; level < levels_.size(); ++level) {
+        size_t from = digit(current_, level) + (level == 0 ? 0 : 1);
+        if (from >= kSlotsPerLevel) {
+            continue;
+        }
+        int slot = findOccupied(levels_[level], from);
+        if (slot >= 0) {
+            size_t shift = (level + 1) * kSlotBits;
+            uint64_t base = (current_ >> shift) << shift;
+            return base | (static_cast<uint64_t>(slot) << (level * kSlotBits));
+        }
+    }
+    if (!overflow_.empty()) {
+        size_t shift = levels_.size() * kSlotBits;
+        return (overflow_min_tick_ >> shift) << shift;
+    }
+    return kNoTick;
+}
+
+int TimingWheelJobStore::findOccupied(const Level& level, size_t from) const {
+    for (size_t word = from / 64; word < level.occupied.size(); ++word) {
+        uint64_t bits = level.occupied[word];
+        if (word == from / 64) {
+            bits &= ~uint64_t{0} << (from % 64);
+        }
+        if (bits != 0) {
+            return static_cast<int>(word * 64) + lowestSetBit(bits);
+        }
+    }
+    return -1;
+}
+
+}
@@ -0,0 +1,95 @@
+/**
+ * @file Watchdog.cpp
+ * @brief Implements the Watchdog class.
+ */
+
+#include "Watchdog.hpp"
+#include <algorithm>
+#include <iostream>
+
+namespace scheduleit {
+
+Watchdog& Watchdog::instance() {
+    static Watchdog watchdog;
+    return watchdog;
+}
+
+Watchdog::Watchdog() : thread_([this]() { run(); }) {}
+
+Watchdog::~Watchdog() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    cv_.notify_one();
+    thread_.join();
+}
+
+void Watchdog::watch(const std::shared_ptr<CancellationState>& state, Clock::time_point deadline,
+                     CancellationState::ExpiryCallback on_expire) {
+    // Written before the entry is published under the lock; read only by whoever ends the state.
+    state->on_expire_ = std::move(on_expire);
+    bool earliest;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (heap_.size() >= compact_at_) {
+            compact();
+        }
+        heap_.push_back(Entry{deadline, state});
+        std::push_heap(heap_.begin(), heap_.end(), Later());
+        earliest = heap_.front().state == state;
+    }
+    if (earliest) {
+        cv_.notify_one();
+    }
+}
+
+size_t Watchdog::getWatchedCount() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return heap_.size();
+}
+
+void Watchdog::compact() {
+    heap_.erase(std::remove_if(heap_.begin(), heap_.end(), [](const Entry& entry) { return !entry.state->isRunning(); }),
+                heap_.end());
+    std::make_heap(heap_.begin(), heap_.end(), Later());
+    compact_at_ = std::max<size_t>(1024, heap_.size() * 2);
+}
+
+void Watchdog::run() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (!stopping_) {
+        if (heap_.empty()) {
+            cv_.wait(lock);
+            continue;
+        }
+        Clock::time_point deadline = heap_.front().deadline;
+        if (heap_.front().state->isRunning() && deadline > Clock::now()) {
+            cv_.wait_until(lock, deadline);
+            continue;
+        }
+        std::pop_heap(heap_.begin(), heap_.end(), Later());
+        std::shared_ptr<CancellationState> state = std::move(heap_.back().state);
+        heap_.pop_back();
+        if (!state->transition(CancellationState::kTimedOut)) {
+            continue;  // finished or cancelled in time
+        }
+        expired_++;
+        CancellationState::ExpiryCallback on_expire = std::move(state->on_expire_);
+        lock.unlock();
+        if (on_expire) {
+            try {
+                on_expire();
+            } catch (const std::exception& e) {
+                std::cerr << "[Watchdog] Expiry callback threw: " << e.what() << '\n';
+            } catch (...) {
+                std::cerr << "[Watchdog] Expiry callback threw unknown exception.\n";
+            }
+            on_expire = nullptr;  // release what it captured before the worker moves on
+        }
+        state->expired_.store(true, std::memory_order_release);
+        lock.lock();
+    }
+}
+
+}
@@ -0,0 +1,82 @@
+/**
+ * @file Workflow.cpp
+ * @brief Implements the Workflow class. Empty unless built as C++20.
+ */
+
+#if defined(__cpp_impl_coroutine)
+
+#include "Workflow.hpp"
+#include <stdexcept>
+#include <utility>
+
+namespace scheduleit {
+
+/// The task of a workflow's job: owns the coroutine and resumes it once per run.
+class Workflow::Step {
+public:
+    explicit Step(Workflow workflow) : workflow_(std::move(workflow)) {}
+
+    void operator()() const {
+        workflow_.resume();
+    }
+
+private:
+    Workflow workflow_;
+};
+
+bool Workflow::JobAwaiter::await_suspend(std::coroutine_handle<>) {
+    self_ = Job::current();
+    self_->suspendUntilWoken();
+    if (job_->addCompletionWaiter(this)) {
+        return true;
+    }
+    // Already finished: carry on without leaving the worker.
+    self_->cancelSuspension();
+    succeeded_ = job_->completedSuccessfully();
+    return false;
+}
+
+void Workflow::JobAwaiter::onJobCompleted(bool succeeded) {
+    succeeded_ = succeeded;
+    // The workflow may resume on another worker from here on, destroying this awaiter.
+    self_->wake();
+}
+
+Workflow::Workflow(Workflow&& other) noexcept : handle_(std::exchange(other.handle_, nullptr)) {}
+
+Workflow& Workflow::operator=(Workflow&& other) noexcept {
+    if (this != &other) {
+        if (handle_) {
+            handle_.destroy();
+        }
+        handle_ = std::exchange(other.handle_, nullptr);
+    }
+    return *this;
+}
+
+Workflow::~Workflow() {
+    if (handle_) {
+        handle_.destroy();
+    }
+}
+
+std::shared_ptr<Job> Workflow::intoJob(std::string id) && {
+    if (!handle_) {
+        throw std::runtime_error("Workflow was already turned into a job");
+    }
+    return Job::create(std::move(id), Step(std::move(*this)), nullptr, std::chrono::milliseconds(0), 0);
+}
+
+void Workflow::resume() const {
+    if (handle_.done()) {
+        throw std::runtime_error("Workflow has already finished");
+    }
+    handle_.resume();
+    if (handle_.done() && handle_.promise().exception) {
+        std::rethrow_exception(handle_.promise().exception);
+    }
+}
+
+}
+
+#endif
@@ -73,6 +73,7 @@ int main() {
 
     scheduler.start();
     scheduler.waitForIdle();
+    notifier->flush();
 
     std::cout << "[Main] Shutting down scheduler...\n";
     scheduler.shutdown();
@@ -0,0 +1,191 @@
+#include "AdmissionController.hpp"
+#include "JobScheduler.hpp"
+#include <catch2/catch_test_macros.hpp>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+using namespace scheduleit;
+using namespace std::chrono;
+
+namespace {
+
+// A job that holds its worker until the gate opens.
+std::shared_ptr<Job> gatedJob(const std::atomic<bool>& gate, std::atomic<int>& ran,
+                              JobPriority priority = JobPriority::Normal) {
+    auto job = Job::create("", [&gate, &ran]() {
+        while (!gate.load()) {
+            std::this_thread::sleep_for(milliseconds(1));
+        }
+        ++ran;
+    }, nullptr, milliseconds(0), 0);
+    job->setPriority(priority);
+    return job;
+}
+
+}
+
+TEST_CASE("Admission rejects jobs beyond max_pending and reports the pressure", "[Admission]") {
+    SchedulerOptions options;
+    options.admission.max_pending = 4;
+    options.admission.policy = OverloadPolicy::Reject;
+    JobScheduler scheduler(1, options);
+    scheduler.start();
+
+    std::atomic<bool> gate{false};
+    std::atomic<int> ran{0};
+    for (int i = 0; i < 3; ++i) {
+        REQUIRE(scheduler.trySubmit(gatedJob(gate, ran)));
+    }
+    REQUIRE(scheduler.getQueuePressure().level == PressureLevel::Elevated);
+    REQUIRE(scheduler.submit(gatedJob(gate, ran)));
+
+    REQUIRE(scheduler.trySubmit(gatedJob(gate, ran)).status == SubmitStatus::Full);
+    REQUIRE_FALSE(scheduler.submit(gatedJob(gate, ran)));
+    std::vector<std::shared_ptr<Job>> batch{gatedJob(gate, ran), gatedJob(gate, ran)};
+    REQUIRE(scheduler.submitBatch(batch) == 0);
+    REQUIRE(scheduler.trySubmit(nullptr).status == SubmitStatus::Invalid);
+
+    QueuePressure pressure = scheduler.getQueuePressure();
+    REQUIRE(pressure.level == PressureLevel::Saturated);
+    REQUIRE(pressure.outstanding == 4);
+    REQUIRE(pressure.capacity == 4);
+    REQUIRE(pressure.accepted == 4);
+    REQUIRE(pressure.rejected == 4);
+
+    gate = true;
+    REQUIRE(scheduler.waitForIdle(milliseconds(5000)));
+    REQUIRE(ran.load() == 4);
+    REQUIRE(scheduler.getQueuePressure().level == PressureLevel::Normal);
+    REQUIRE(scheduler.trySubmit(gatedJob(gate, ran)));
+    scheduler.shutdown();
+
+    options.admission.rate_limits["bad"] = RateLimit{0, 1};
+    REQUIRE_THROWS_AS(JobScheduler(1, options), std::invalid_argument);
+}
+
+TEST_CASE("Admission blocks submitters until room frees up", "[Admission]") {
+    SchedulerOptions options;
+    options.admission.max_pending = 2;
+    JobScheduler scheduler(2, options);
+    scheduler.start();
+
+    std::atomic<bool> gate{false};
+    std::atomic<int> ran{0};
+    scheduler.submit(gatedJob(gate, ran));
+    scheduler.submit(gatedJob(gate, ran));
+
+    std::atomic<bool> submitted{false};
+    std::thread producer([&]() {
+        scheduler.submit(gatedJob(gate, ran));
+        submitted = true;
+    });
+    while (scheduler.getQueuePressure().blocked_submitters == 0) {
+        std::this_thread::sleep_for(milliseconds(1));
+    }
+    REQUIRE_FALSE(submitted.load());
+    REQUIRE(scheduler.trySubmit(gatedJob(gate, ran)).status == SubmitStatus::Full);
+    gate = true;
+    producer.join();
+    REQUIRE(submitted.load());
+
+    // A batch larger than max_pending drains through in parts.
+    std::vector<std::shared_ptr<Job>> batch;
+    for (int i = 0; i < 50; ++i) {
+        batch.push_back(gatedJob(gate, ran));
+    }
+    REQUIRE(scheduler.submitBatch(std::move(batch)) == 50);
+    REQUIRE(scheduler.waitForIdle(milliseconds(5000)));
+    REQUIRE(ran.load() == 53);
+    REQUIRE(scheduler.getQueuePressure().blocked >= 1);
+    scheduler.shutdown();
+
+    // With max_block, a submit gives up.
+    options.admission.max_block = milliseconds(20);
+    JobScheduler bounded(1, options);
+    bounded.start();
+    gate = false;
+    bounded.submit(gatedJob(gate, ran));
+    bounded.submit(gatedJob(gate, ran));
+    auto start = steady_clock::now();
+    REQUIRE_FALSE(bounded.submit(gatedJob(gate, ran)));
+    REQUIRE(steady_clock::now() - start >= milliseconds(20));
+    gate = true;
+    bounded.shutdown();
+}
+
+TEST_CASE("Admission sheds the newest queued job of the lowest priority", "[Admission]") {
+    SchedulerOptions options;
+    options.dispatch = DispatchMode::Direct;
+    options.admission.max_pending = 3;
+    options.admission.policy = OverloadPolicy::ShedLowestPriority;
+    JobScheduler scheduler(1, options);
+    scheduler.start();
+
+    std::atomic<bool> gate{false};
+    std::atomic<int> ran{0};
+    auto first = gatedJob(gate, ran);
+    scheduler.submit(first);
+    while (first->getState() != JobState::Running) {
+        std::this_thread::sleep_for(milliseconds(1));
+    }
+    auto older = gatedJob(gate, ran, JobPriority::Low);
+    auto newer = gatedJob(gate, ran, JobPriority::Low);
+    REQUIRE(scheduler.submit(older));
+    REQUIRE(scheduler.submit(newer));
+
+    // A job of the same priority finds nothing to shed.
+    REQUIRE(scheduler.trySubmit(gatedJob(gate, ran, JobPriority::Low)).status == SubmitStatus::Full);
+    REQUIRE(scheduler.submit(gatedJob(gate, ran, JobPriority::High)));
+    REQUIRE(newer->getState() == JobState::Cancelled);
+    REQUIRE(older->getState() == JobState::Queued);
+    REQUIRE(scheduler.getQueuePressure().shed == 1);
+
+    gate = true;
+    REQUIRE(scheduler.waitForIdle(milliseconds(5000)));
+    REQUIRE(ran.load() == 3);
+    scheduler.shutdown();
+}
+
+TEST_CASE("Admission rate-limits jobs by tag", "[Admission]") {
+    SchedulerOptions options;
+    options.admission.policy = OverloadPolicy::Reject;
+    options.admission.rate_limits["tenant"] = RateLimit{50, 2};
+    JobScheduler scheduler(1, options);
+    scheduler.start();
+
+    std::atomic<int> ran{0};
+    auto tagged = [&ran](const char* tag) {
+        auto job = Job::create("", [&ran]() { ++ran; }, nullptr, milliseconds(0), 0);
+        job->setTag(tag);
+        return job;
+    };
+    REQUIRE(scheduler.trySubmit(tagged("tenant")));
+    REQUIRE(scheduler.trySubmit(tagged("tenant")));
+    REQUIRE(scheduler.trySubmit(tagged("tenant")).status == SubmitStatus::RateLimited);
+    REQUIRE(scheduler.trySubmit(tagged("other")));
+    REQUIRE(scheduler.trySubmit(tagged("")));
+    std::this_thread::sleep_for(milliseconds(40));  // two tokens at 50/s
+    REQUIRE(scheduler.trySubmit(tagged("tenant")));
+    REQUIRE(scheduler.getQueuePressure().rate_limited == 1);
+    REQUIRE(scheduler.waitForIdle(milliseconds(5000)));
+    REQUIRE(ran.load() == 5);
+    scheduler.shutdown();
+
+    // Under Block, a tagged producer is paced to the rate instead.
+    options.admission.policy = OverloadPolicy::Block;
+    JobScheduler paced(1, options);
+    paced.start();
+    std::vector<std::shared_ptr<Job>> batch;
+    for (int i = 0; i < 7; ++i) {
+        batch.push_back(tagged("tenant"));
+    }
+    auto start = steady_clock::now();
+    REQUIRE(paced.submitBatch(std::move(batch)) == 7);
+    REQUIRE(steady_clock::now() - start >= milliseconds(90));  // 5 jobs beyond the burst at 50/s
+    REQUIRE(paced.waitForIdle(milliseconds(5000)));
+    paced.shutdown();
+}
@@ -0,0 +1,122 @@
+#include "CpuTopology.hpp"
+#include "JobScheduler.hpp"
+#include "ThreadPool.hpp"
+#include <catch2/catch_test_macros.hpp>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+using namespace scheduleit;
+using namespace std::chrono;
+
+TEST_CASE("CpuTopology parses CPU lists and lays out workers", "[CpuTopology]") {
+    REQUIRE(CpuTopology::parseCpuList("0-3,8,10-11\n") == std::vector<int>{0, 1, 2, 3, 8, 10, 11});
+    REQUIRE_THROWS_AS(CpuTopology::parseCpuList("3-1"), std::invalid_argument);
+    REQUIRE_THROWS_AS(CpuTopology::parseCpuList("0,,2"), std::invalid_argument);
+    REQUIRE_THROWS_AS(CpuTopology::fromCpuList(""), std::invalid_argument);
+
+    CpuTopology topology = CpuTopology::simulated(2, 2);
+    REQUIRE(topology.getNodeCount() == 2);
+    REQUIRE(topology.getCpus(1) == std::vector<int>{2, 3});
+    // Round-robin over the nodes first, then over each node's CPUs.
+    REQUIRE(topology.getCpuForWorker(0) == 0);
+    REQUIRE(topology.getCpuForWorker(1) == 2);
+    REQUIRE(topology.getCpuForWorker(2) == 1);
+    REQUIRE(topology.getCpuForWorker(5) == 2);
+
+    // A node without CPUs is left out but the others keep their ids.
+    CpuTopology sparse({{0, 1}, {}, {2, 3}});
+    REQUIRE(sparse.getNodeCount() == 2);
+    REQUIRE(sparse.getNodeId(1) == 2);
+    REQUIRE(sparse.getCpus(1) == std::vector<int>{2, 3});
+    REQUIRE(sparse.findNode(2) == 1);
+    REQUIRE(sparse.findNode(1) == CpuTopology::kAnyNode);
+
+    CpuTopology detected = CpuTopology::detect();
+    REQUIRE(detected.getNodeCount() >= 1);
+    REQUIRE(detected.getCpuCount() >= 1);
+    REQUIRE(CpuTopology::pinCurrentThread(-1) == false);
+}
+
+TEST_CASE("A NUMA-aware pool runs hinted tasks on their node and drains every queue", "[CpuTopology]") {
+    ThreadPoolOptions options;
+    options.topology = std::make_shared<CpuTopology>(CpuTopology::simulated(2, 2));
+    ThreadPool pool(4, options);
+    REQUIRE(pool.getNodeCount() == 2);
+    REQUIRE(ThreadPool::currentNode() == CpuTopology::kAnyNode);
+
+    // Every hinted task runs on its node unless a worker of the other node took it, and each
+    // such take is counted as a remote steal.
+    std::atomic<int> ran{0};
+    std::atomic<int> off_node{0};
+    auto hinted = [&](size_t node) {
+        return [&ran, &off_node, node]() {
+            off_node += ThreadPool::currentNode() == node ? 0 : 1;
+            ++ran;
+        };
+    };
+    for (int i = 0; i < 1000; ++i) {
+        pool.submitDetachedToNode(i % 2, hinted(i % 2));
+    }
+    std::vector<UniqueFunction<void()>> tasks;
+    for (int i = 0; i < 1000; ++i) {
+        tasks.emplace_back(hinted(1));
+    }
+    pool.submitBulkToNode(1, tasks.begin(), tasks.end());
+
+    auto give_up = steady_clock::now() + seconds(5);
+    while (ran.load() < 2000 && steady_clock::now() < give_up) {
+        std::this_thread::sleep_for(milliseconds(1));
+    }
+    REQUIRE(ran.load() == 2000);
+    REQUIRE(static_cast<uint64_t>(off_node.load()) == pool.getRemoteSteals());
+    REQUIRE(pool.getPinnedWorkers() <= 4);
+    pool.shutdown();
+}
+
+TEST_CASE("A NUMA-aware pool takes node ids, not indices, as hints", "[CpuTopology]") {
+    ThreadPoolOptions options;
+    options.topology = std::make_shared<CpuTopology>(std::vector<std::vector<int>>{{0}, {}, {1}});
+    ThreadPool pool(2, options);
+    REQUIRE(pool.getNodeCount() == 2);
+
+    std::atomic<int> ran{0};
+    std::atomic<int> off_node{0};
+    for (int i = 0; i < 100; ++i) {
+        pool.submitDetachedToNode(2, [&ran, &off_node]() {
+            off_node += ThreadPool::currentNode() == 2 ? 0 : 1;
+            ++ran;
+        });
+    }
+    REQUIRE_THROWS_AS(pool.submitDetachedToNode(1, []() {}), std::invalid_argument);
+
+    auto give_up = steady_clock::now() + seconds(5);
+    while (ran.load() < 100 && steady_clock::now() < give_up) {
+        std::this_thread::sleep_for(milliseconds(1));
+    }
+    REQUIRE(ran.load() == 100);
+    REQUIRE(static_cast<uint64_t>(off_node.load()) == pool.getRemoteSteals());
+    pool.shutdown();
+}
+
+TEST_CASE("A scheduler with a topology runs jobs with and without a preferred node", "[CpuTopology]") {
+    SchedulerOptions options;
+    options.topology = std::make_shared<CpuTopology>(CpuTopology::simulated(2, 1));
+    JobScheduler scheduler(2, options);
+    scheduler.start();
+
+    std::atomic<int> ran{0};
+    std::vector<std::shared_ptr<Job>> jobs;
+    for (int i = 0; i < 200; ++i) {
+        auto job = Job::create("", [&ran]() { ++ran; }, nullptr, milliseconds(0), 0);
+        job->setPreferredNode(i % 3 == 0 ? CpuTopology::kAnyNode : static_cast<size_t>(i % 2));
+        jobs.push_back(std::move(job));
+    }
+    scheduler.submitBatch(std::move(jobs));
+    REQUIRE(scheduler.waitForIdle(milliseconds(5000)));
+    REQUIRE(ran.load() == 200);
+    scheduler.shutdown();
+}
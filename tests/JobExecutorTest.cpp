@@ -6,6 +6,8 @@
 #include <catch2/catch_test_macros.hpp>
 #include <memory>
 #include <atomic>
+#include <chrono>
+#include <thread>
 
 using namespace scheduleit;
 
@@ -14,6 +16,7 @@ class CountingObserver : public Observer {
 public:
     std::atomic<int> success_count{0};
     std::atomic<int> failure_count{0};
+    std::atomic<int> expired_count{0};
 
     void onJobFailed(const Job& job, int attempt) override {
         ++failure_count;
@@ -22,6 +25,10 @@ public:
     void onJobSuccess(const Job& job) override {
         ++success_count;
     }
+
+    void onJobExpired(const Job& job) override {
+        ++expired_count;
+    }
 };
 }
 
@@ -49,4 +56,158 @@ TEST_CASE("JobExecutor retries a failing job up to maxRetries", "[JobExecutor]")
     executor.run(job);
 
     REQUIRE(observer->success_count == 0);
-}
\ No newline at end of file
+}
+
+TEST_CASE("JobExecutor re-enqueues retries without blocking the worker", "[JobExecutor]") {
+    auto job_queue = std::make_shared<JobQueue>();
+    JobExecutor executor(job_queue);
+
+    auto strategy = std::make_shared<FixedRetryStrategy>(std::chrono::milliseconds(500));
+    auto job = std::make_shared<Job>(
+        "backoff-job",
+        []() { throw std::runtime_error("fail"); },
+        strategy,
+        std::chrono::milliseconds(0),
+        3
+    );
+
+    auto start = std::chrono::system_clock::now();
+    executor.run(job);
+    auto elapsed = std::chrono::system_clock::now() - start;
+
+    REQUIRE(elapsed < std::chrono::milliseconds(250));
+    REQUIRE(job_queue->size() == 1);
+    REQUIRE(executor.getPendingRetryCount() == 1);
+    REQUIRE(executor.getRetriesScheduled() == 1);
+    REQUIRE(job->getScheduledTime() >= start + std::chrono::milliseconds(500));
+
+    // The retry fails again and schedules the next attempt, so one retry is still pending.
+    executor.run(job_queue->dequeueReady());
+    REQUIRE(executor.getPendingRetryCount() == 1);
+    REQUIRE(executor.getRetriesScheduled() == 2);
+}
+
+TEST_CASE("JobExecutor honours a job's retry hook", "[JobExecutor]") {
+    auto job_queue = std::make_shared<JobQueue>();
+    JobExecutor executor(job_queue);
+
+    auto strategy = std::make_shared<FixedRetryStrategy>(std::chrono::milliseconds(1));
+    auto job = std::make_shared<Job>(
+        "vetoed-job",
+        []() { throw std::runtime_error("fail"); },
+        strategy,
+        std::chrono::milliseconds(0),
+        3
+    );
+    int seen_attempt = -1;
+    job->setRetryHook([&seen_attempt](const Job&, int attempt) {
+        seen_attempt = attempt;
+        return false;
+    });
+
+    executor.run(job);
+
+    REQUIRE(seen_attempt == 1);
+    REQUIRE(job_queue->empty());
+    REQUIRE(executor.getPendingRetryCount() == 0);
+    REQUIRE(executor.getRetriesCancelled() == 1);
+}
+
+TEST_CASE("JobExecutor counts a retry once when the retried attempt suspends", "[JobExecutor]") {
+    auto job_queue = std::make_shared<JobQueue>();
+    JobExecutor executor(job_queue);
+
+    auto strategy = std::make_shared<FixedRetryStrategy>(std::chrono::milliseconds(1));
+    int runs = 0;
+    auto job = std::make_shared<Job>(
+        "retry-then-sleep",
+        [&runs]() {
+            ++runs;
+            if (runs == 1) {
+                throw std::runtime_error("fail");
+            }
+            if (runs == 2) {
+                Job::current()->suspendFor(std::chrono::milliseconds(1));
+            }
+        },
+        strategy,
+        std::chrono::milliseconds(0),
+        3
+    );
+
+    executor.run(job);
+    REQUIRE(executor.getPendingRetryCount() == 1);
+    executor.run(job_queue->dequeueReady());  // the retry, which suspends
+    REQUIRE(executor.getPendingRetryCount() == 0);
+    executor.run(job_queue->dequeueReady());  // the resumed attempt, which succeeds
+    REQUIRE(runs == 3);
+    REQUIRE(job->getState() == JobState::Finished);
+    REQUIRE(executor.getPendingRetryCount() == 0);
+    REQUIRE(job->getFiringCount() == 1);
+}
+
+TEST_CASE("JobExecutor drops an attempt that starts past its job's deadline", "[JobExecutor]") {
+    auto job_queue = std::make_shared<JobQueue>();
+    JobExecutor executor(job_queue);
+    auto observer = std::make_shared<CountingObserver>();
+    executor.registerObserver(observer);
+
+    std::atomic<int> ran{0};
+    auto late = std::make_shared<Job>("late", [&ran]() { ++ran; }, nullptr, std::chrono::milliseconds(0), 0);
+    late->setDeadline(std::chrono::system_clock::now() - std::chrono::milliseconds(1));
+    auto on_time = std::make_shared<Job>("on-time", [&ran]() { ++ran; }, nullptr, std::chrono::milliseconds(0), 0);
+    on_time->setDeadline(std::chrono::system_clock::now() + std::chrono::hours(1));
+    REQUIRE(late->hasDeadline());
+    REQUIRE_FALSE(std::make_shared<Job>("", []() {}, nullptr)->hasDeadline());
+
+    executor.run(late);
+    executor.run(on_time);
+    REQUIRE(ran.load() == 1);
+    REQUIRE(late->getState() == JobState::Expired);
+    REQUIRE(observer->expired_count == 1);
+    REQUIRE(observer->success_count == 1);
+    REQUIRE(executor.getJobsExpired() == 1);
+}
+
+TEST_CASE("JobExecutor drops an attempt that cannot finish within its expected run time", "[JobExecutor]") {
+    auto job_queue = std::make_shared<JobQueue>();
+    JobExecutor executor(job_queue);
+    auto observer = std::make_shared<CountingObserver>();
+    executor.registerObserver(observer);
+
+    std::atomic<int> ran{0};
+    auto now = std::chrono::system_clock::now();
+    auto too_slow = std::make_shared<Job>("too-slow", [&ran]() { ++ran; }, nullptr, std::chrono::milliseconds(0), 0);
+    too_slow->setDeadline(now + std::chrono::minutes(1), std::chrono::hours(1));
+    auto fits = std::make_shared<Job>("fits", [&ran]() { ++ran; }, nullptr, std::chrono::milliseconds(0), 0);
+    fits->setDeadline(now + std::chrono::hours(1), std::chrono::minutes(1));
+    REQUIRE(fits->getLatestStart() == now + std::chrono::minutes(59));
+
+    executor.run(too_slow);
+    executor.run(fits);
+    REQUIRE(ran.load() == 1);
+    REQUIRE(too_slow->getState() == JobState::Expired);
+    REQUIRE(fits->getState() == JobState::Finished);
+    REQUIRE(observer->expired_count == 1);
+}
+
+TEST_CASE("JobExecutor keeps running deadline jobs after a slow one", "[JobExecutor]") {
+    auto job_queue = std::make_shared<JobQueue>();
+    JobExecutor executor(job_queue);
+
+    // A slow job must not make later jobs with less slack than its run time look late.
+    auto slow = std::make_shared<Job>("slow", []() {
+        std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    }, nullptr, std::chrono::milliseconds(0), 0);
+    slow->setDeadline(std::chrono::system_clock::now() + std::chrono::hours(1));
+    executor.run(slow);
+
+    std::atomic<int> ran{0};
+    for (int i = 0; i < 100; ++i) {
+        auto job = std::make_shared<Job>("", [&ran]() { ++ran; }, nullptr, std::chrono::milliseconds(0), 0);
+        job->setDeadline(std::chrono::system_clock::now() + std::chrono::milliseconds(10));
+        executor.run(job);
+    }
+    REQUIRE(ran.load() == 100);
+    REQUIRE(executor.getJobsExpired() == 0);
+}
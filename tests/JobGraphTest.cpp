@@ -0,0 +1,248 @@
+#include "JobScheduler.hpp"
+#include "JobGraph.hpp"
+#include "Job.hpp"
+#include "FixedRetryStrategy.hpp"
+#include "Observer.hpp"
+#include "Utils.hpp"
+#include <catch2/catch_test_macros.hpp>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace scheduleit;
+using namespace std::chrono;
+
+namespace {
+
+std::shared_ptr<Job> makeNode(Job::Task task, int max_retries = 0) {
+    auto retry = std::make_shared<FixedRetryStrategy>(milliseconds(5));
+    return Job::create("", std::move(task), retry, milliseconds(0), max_retries);
+}
+
+class CancelCounter : public Observer {
+public:
+    void onJobFailed(const Job&, int) override {}
+    void onJobSuccess(const Job&) override {}
+    void onJobCancelled(const Job&) override {
+        ++cancelled;
+    }
+    std::atomic<int> cancelled{0};
+};
+
+class OrderLog {
+public:
+    Job::Task record(const std::string& name) {
+        return [this, name]() {
+            std::lock_guard<std::mutex> lock(mutex_);
+            order_.push_back(name);
+        };
+    }
+    size_t position(const std::string& name) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return static_cast<size_t>(std::find(order_.begin(), order_.end(), name) - order_.begin());
+    }
+    size_t size() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return order_.size();
+    }
+
+private:
+    std::mutex mutex_;
+    std::vector<std::string> order_;
+};
+
+}
+
+TEST_CASE("Graph nodes run after all of their predecessors", "[JobGraph]") {
+    for (auto mode : {DispatchMode::Dispatcher, DispatchMode::Direct}) {
+        SchedulerOptions options;
+        options.dispatch = mode;
+        JobScheduler scheduler(4, options);
+        scheduler.start();
+
+        OrderLog log;
+        JobGraph graph;
+        auto a = graph.add(makeNode(log.record("a")));
+        auto b = graph.add(makeNode(log.record("b")));
+        auto c = graph.add(makeNode(log.record("c")));
+        auto d = graph.add(makeNode(log.record("d")));
+        graph.addEdge(a, b);
+        graph.addEdge(a, c);
+        graph.addEdge(b, d);
+        graph.addEdge(c, d);
+        scheduler.submitGraph(std::move(graph));
+
+        REQUIRE(scheduler.waitForIdle(milliseconds(2000)));
+        scheduler.shutdown();
+        REQUIRE(log.size() == 4);
+        REQUIRE(log.position("a") < log.position("b"));
+        REQUIRE(log.position("a") < log.position("c"));
+        REQUIRE(log.position("b") < log.position("d"));
+        REQUIRE(log.position("c") < log.position("d"));
+    }
+}
+
+TEST_CASE("Independent graph branches do not wait for each other", "[JobGraph]") {
+    JobScheduler scheduler(2);
+    scheduler.start();
+
+    std::atomic<bool> slow_done{false};
+    std::atomic<bool> fast_done_first{false};
+    JobGraph graph;
+    auto slow = graph.add(makeNode([&]() {
+        utils::sleepForMillis(milliseconds(200));
+        slow_done = true;
+    }));
+    graph.addEdge(slow, graph.add(makeNode([]() {})));
+    auto previous = graph.add(makeNode([]() {}));
+    for (int i = 0; i < 5; ++i) {
+        auto next = graph.add(makeNode([]() {}));
+        graph.addEdge(previous, next);
+        previous = next;
+    }
+    graph.addEdge(previous, graph.add(makeNode([&]() { fast_done_first = !slow_done.load(); })));
+    scheduler.submitGraph(std::move(graph));
+
+    REQUIRE(scheduler.waitForIdle(milliseconds(2000)));
+    scheduler.shutdown();
+    REQUIRE(fast_done_first.load());
+}
+
+TEST_CASE("A node fails only after its retries are used up", "[JobGraph]") {
+    JobScheduler scheduler(2);
+    auto observer = std::make_shared<CancelCounter>();
+    scheduler.getExecutor()->registerObserver(observer);
+    scheduler.start();
+
+    std::atomic<int> flaky_runs{0};
+    std::atomic<int> broken_runs{0};
+    std::atomic<int> after_flaky{0};
+    std::atomic<int> after_broken{0};
+    JobGraph graph;
+    auto flaky = graph.add(makeNode([&]() {
+        if (flaky_runs++ == 0) {
+            throw std::runtime_error("first attempt fails");
+        }
+    }, 1));
+    auto broken = graph.add(makeNode([&]() {
+        ++broken_runs;
+        throw std::runtime_error("always fails");
+    }, 2));
+    graph.addEdge(flaky, graph.add(makeNode([&]() { ++after_flaky; })));
+    // A two-level tail below the broken node: both levels are cancelled.
+    auto child = graph.add(makeNode([&]() { ++after_broken; }));
+    graph.addEdge(broken, child);
+    graph.addEdge(child, graph.add(makeNode([&]() { ++after_broken; })));
+    auto shared = graph.add(makeNode([&]() { ++after_broken; }));
+    graph.addEdge(flaky, shared);
+    graph.addEdge(broken, shared);
+    auto cancelled_job = graph.getJob(child);
+    scheduler.submitGraph(std::move(graph));
+
+    REQUIRE(scheduler.waitForIdle(milliseconds(2000)));
+    scheduler.shutdown();
+    REQUIRE(flaky_runs.load() == 2);
+    REQUIRE(after_flaky.load() == 1);
+    REQUIRE(broken_runs.load() == 3);
+    REQUIRE(after_broken.load() == 0);
+    REQUIRE(observer->cancelled.load() == 3);
+    REQUIRE(cancelled_job->getState() == JobState::Cancelled);
+}
+
+TEST_CASE("Graph failure policies", "[JobGraph]") {
+    SECTION("RunDependents lets successors of a failed node run") {
+        JobScheduler scheduler(2);
+        scheduler.start();
+        std::atomic<int> runs{0};
+        JobGraph graph;
+        graph.setFailurePolicy(GraphFailurePolicy::RunDependents);
+        auto failing = graph.add(makeNode([]() { throw std::runtime_error("fail"); }));
+        graph.addEdge(failing, graph.add(makeNode([&]() { ++runs; })));
+        scheduler.submitGraph(std::move(graph));
+        REQUIRE(scheduler.waitForIdle(milliseconds(2000)));
+        scheduler.shutdown();
+        REQUIRE(runs.load() == 1);
+    }
+    SECTION("CancelGraph withdraws every node that has not started") {
+        JobScheduler scheduler(1);
+        scheduler.start();
+        std::atomic<int> runs{0};
+        JobGraph graph;
+        graph.setFailurePolicy(GraphFailurePolicy::CancelGraph);
+        graph.add(makeNode([]() { throw std::runtime_error("fail"); }));
+        // An unrelated root that is queued but not due, and a node waiting for it.
+        auto retry = std::make_shared<FixedRetryStrategy>(milliseconds(5));
+        auto later = graph.add(Job::create("", [&runs]() { ++runs; }, retry, milliseconds(300)));
+        graph.addEdge(later, graph.add(makeNode([&]() { ++runs; })));
+        scheduler.submitGraph(std::move(graph));
+        REQUIRE(scheduler.waitForIdle(milliseconds(200)));
+        scheduler.shutdown();
+        REQUIRE(runs.load() == 0);
+        REQUIRE(scheduler.getExecutor()->getJobsCancelled() == 2);
+    }
+}
+
+TEST_CASE("Cancelling a queued graph node cancels its successors", "[JobGraph]") {
+    JobScheduler scheduler(1);
+    scheduler.start();
+    std::atomic<int> runs{0};
+    auto retry = std::make_shared<FixedRetryStrategy>(milliseconds(5));
+    auto root = Job::create("", [&runs]() { ++runs; }, retry, milliseconds(3600000));
+    JobGraph graph;
+    auto previous = graph.add(root);
+    // Long enough that a recursive cascade would overflow the stack.
+    for (int i = 0; i < 200000; ++i) {
+        auto next = graph.add(makeNode([&runs]() { ++runs; }));
+        graph.addEdge(previous, next);
+        previous = next;
+    }
+    scheduler.submitGraph(std::move(graph));
+    REQUIRE(scheduler.cancel(root));
+    REQUIRE(scheduler.waitForIdle(milliseconds(2000)));
+    scheduler.shutdown();
+    REQUIRE(runs.load() == 0);
+    REQUIRE(scheduler.getExecutor()->getJobsCancelled() == 200001);
+}
+
+TEST_CASE("Wide fan-in runs the join node exactly once", "[JobGraph]") {
+    JobScheduler scheduler(4);
+    scheduler.start();
+    std::atomic<int> parents_done{0};
+    std::atomic<int> join_runs{0};
+    std::atomic<int> seen_at_join{0};
+    JobGraph graph;
+    auto join = graph.add(makeNode([&]() {
+        ++join_runs;
+        seen_at_join = parents_done.load();
+    }));
+    for (int i = 0; i < 2000; ++i) {
+        graph.addEdge(graph.add(makeNode([&]() { ++parents_done; })), join);
+    }
+    scheduler.submitGraph(std::move(graph));
+    REQUIRE(scheduler.waitForIdle(milliseconds(5000)));
+    scheduler.shutdown();
+    REQUIRE(join_runs.load() == 1);
+    REQUIRE(seen_at_join.load() == 2000);
+}
+
+TEST_CASE("JobGraph rejects cycles and bad edges", "[JobGraph]") {
+    JobGraph graph;
+    auto a = graph.add(makeNode([]() {}));
+    auto b = graph.add(makeNode([]() {}));
+    REQUIRE_THROWS_AS(graph.addEdge(a, a), std::invalid_argument);
+    REQUIRE_THROWS_AS(graph.addEdge(a, 7), std::invalid_argument);
+    REQUIRE_THROWS_AS(graph.add(nullptr), std::invalid_argument);
+    graph.addEdge(a, b);
+    graph.addEdge(b, a);
+
+    JobScheduler scheduler(1);
+    scheduler.start();
+    REQUIRE_THROWS_AS(scheduler.submitGraph(std::move(graph)), std::invalid_argument);
+    REQUIRE(scheduler.getOutstandingCount() == 0);
+    scheduler.shutdown();
+}
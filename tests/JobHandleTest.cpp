@@ -0,0 +1,164 @@
+#include "JobScheduler.hpp"
+#include "JobQueue.hpp"
+#include "Job.hpp"
+#include "FixedRetryStrategy.hpp"
+#include "Observer.hpp"
+#include "Utils.hpp"
+#include <catch2/catch_test_macros.hpp>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+using namespace scheduleit;
+
+namespace {
+
+std::shared_ptr<Job> makeJob(std::atomic<int>& runs, std::chrono::milliseconds delay, int max_retries = 0) {
+    auto retry = std::make_shared<FixedRetryStrategy>(std::chrono::milliseconds(10));
+    return Job::create("", [&runs]() { ++runs; }, retry, delay, max_retries);
+}
+
+class CancelCounter : public Observer {
+public:
+    void onJobFailed(const Job&, int) override {}
+    void onJobSuccess(const Job&) override {}
+    void onJobCancelled(const Job&) override {
+        ++cancelled;
+    }
+    std::atomic<int> cancelled{0};
+};
+
+}
+
+TEST_CASE("JobHandle cancel keeps a queued job from running", "[JobHandle]") {
+    JobScheduler scheduler(2);
+    auto observer = std::make_shared<CancelCounter>();
+    scheduler.getExecutor()->registerObserver(observer);
+    scheduler.start();
+
+    std::atomic<int> runs{0};
+    auto handle = scheduler.submit(makeJob(runs, std::chrono::milliseconds(200)));
+    REQUIRE(handle.getState() == JobState::Queued);
+    REQUIRE(handle.cancel());
+    REQUIRE_FALSE(handle.cancel());
+    REQUIRE(handle.getState() == JobState::Cancelled);
+
+    // A cancelled job counts as finished, so waiting does not block on its deadline.
+    REQUIRE(scheduler.waitForIdle(std::chrono::milliseconds(100)));
+    utils::sleepForMillis(std::chrono::milliseconds(300));
+    scheduler.shutdown();
+    REQUIRE(runs.load() == 0);
+    REQUIRE(observer->cancelled.load() == 1);
+    REQUIRE(scheduler.getExecutor()->getJobsCancelled() == 1);
+}
+
+TEST_CASE("JobHandle cannot cancel a job that already ran", "[JobHandle]") {
+    JobScheduler scheduler(1);
+    scheduler.start();
+    std::atomic<int> runs{0};
+    auto handle = scheduler.submit(makeJob(runs, std::chrono::milliseconds(0)));
+    scheduler.waitForIdle();
+    REQUIRE(handle.getState() == JobState::Finished);
+    REQUIRE_FALSE(handle.cancel());
+    REQUIRE_FALSE(handle.reschedule(std::chrono::milliseconds(10)));
+    REQUIRE_FALSE(JobHandle().cancel());
+    scheduler.shutdown();
+    REQUIRE(runs.load() == 1);
+}
+
+TEST_CASE("JobHandle reschedule moves a job earlier or later", "[JobHandle]") {
+    for (auto backend : {QueueBackend::Heap, QueueBackend::TimingWheel}) {
+        SchedulerOptions options;
+        options.queue.backend = backend;
+        JobScheduler scheduler(2, options);
+        scheduler.start();
+
+        std::atomic<int> early_runs{0};
+        std::atomic<int> late_runs{0};
+        auto early = scheduler.submit(makeJob(early_runs, std::chrono::hours(1)));
+        auto late = scheduler.submit(makeJob(late_runs, std::chrono::milliseconds(20)));
+        REQUIRE(early.reschedule(std::chrono::milliseconds(0)));
+        REQUIRE(late.reschedule(std::chrono::milliseconds(300)));
+
+        utils::sleepForMillis(std::chrono::milliseconds(150));
+        REQUIRE(early_runs.load() == 1);
+        REQUIRE(late_runs.load() == 0);
+        REQUIRE(scheduler.waitForIdle(std::chrono::milliseconds(2000)));
+        scheduler.shutdown();
+        REQUIRE(early_runs.load() == 1);
+        REQUIRE(late_runs.load() == 1);
+    }
+}
+
+TEST_CASE("JobHandle cancels a job waiting for its retry", "[JobHandle]") {
+    JobScheduler scheduler(1);
+    scheduler.start();
+    std::atomic<int> runs{0};
+    auto retry = std::make_shared<FixedRetryStrategy>(std::chrono::milliseconds(5000));
+    auto handle = scheduler.submit(Job::create("", [&runs]() {
+        ++runs;
+        throw std::runtime_error("fail");
+    }, retry, std::chrono::milliseconds(0), 3));
+
+    while (scheduler.getExecutor()->getPendingRetryCount() == 0) {
+        utils::sleepForMillis(std::chrono::milliseconds(1));
+    }
+    REQUIRE(handle.cancel());
+    REQUIRE(scheduler.waitForIdle(std::chrono::milliseconds(500)));
+    REQUIRE(scheduler.getExecutor()->getPendingRetryCount() == 0);
+    scheduler.shutdown();
+    REQUIRE(runs.load() == 1);
+}
+
+TEST_CASE("JobQueue compacts the entries of cancelled jobs", "[JobHandle]") {
+    QueueOptions sharded;
+    sharded.shards = 4;
+    QueueOptions wheel;
+    wheel.backend = QueueBackend::TimingWheel;
+    QueueOptions priority;
+    priority.priority_policy = PriorityPolicy::WeightedFair;
+
+    for (const auto& options : {QueueOptions(), sharded, wheel, priority}) {
+        JobQueue queue(options);
+        std::atomic<int> runs{0};
+        std::vector<std::shared_ptr<Job>> jobs;
+        for (int i = 0; i < 5000; ++i) {
+            jobs.push_back(makeJob(runs, std::chrono::milliseconds(i % 2 == 0 ? 0 : 3600000)));
+            queue.enqueue(jobs.back());
+        }
+        for (size_t i = 0; i + 10 < jobs.size(); ++i) {
+            REQUIRE(queue.cancel(*jobs[i]));
+        }
+        REQUIRE(queue.size() == 10);
+        // Only the last ten survive; the five due ones among them come out first.
+        for (size_t i = jobs.size() - 10; i < jobs.size(); i += 2) {
+            auto job = queue.dequeueReady();
+            REQUIRE(job == jobs[i]);
+            REQUIRE(job->getState() == JobState::Running);
+        }
+        REQUIRE(queue.size() == 5);
+    }
+}
+
+TEST_CASE("JobQueue hands out a rescheduled job exactly once", "[JobHandle]") {
+    QueueOptions wheel;
+    wheel.backend = QueueBackend::TimingWheel;
+    for (const auto& options : {QueueOptions(), wheel}) {
+        JobQueue queue(options);
+        std::atomic<int> runs{0};
+        auto job = makeJob(runs, std::chrono::milliseconds(0));
+        queue.enqueue(job);
+        REQUIRE(queue.reschedule(job, utils::now() + std::chrono::milliseconds(30)));
+        REQUIRE(queue.reschedule(job, utils::now()));
+        REQUIRE(queue.size() == 1);
+
+        auto first = queue.dequeueReady();
+        REQUIRE(first == job);
+        REQUIRE_FALSE(queue.reschedule(job, utils::now()));
+        utils::sleepForMillis(std::chrono::milliseconds(50));
+        REQUIRE(queue.dequeueReady() == nullptr);
+        REQUIRE(queue.empty());
+    }
+}
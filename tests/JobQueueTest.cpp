@@ -2,7 +2,11 @@
 #include "Job.hpp"
 #include <catch2/catch_test_macros.hpp>
 #include <chrono>
+#include <memory>
+#include <string>
+#include <atomic>
 #include <thread>
+#include <vector>
 
 using namespace scheduleit;
 
@@ -34,4 +38,162 @@ TEST_CASE("JobQueue blocks until job is ready", "[JobQueue]") {
 
     REQUIRE(dequeued->getId() == "delayed");
     REQUIRE(end - start >= std::chrono::milliseconds(90));
-}
\ No newline at end of file
+}
+
+TEST_CASE("JobQueue waitDequeue waits for work and returns null once closed", "[JobQueue]") {
+    JobQueue queue;
+
+    std::thread producer([&queue]() {
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        queue.enqueue(std::make_shared<Job>("late", [] {}, nullptr));
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        queue.close();
+    });
+
+    auto job = queue.waitDequeue();
+    REQUIRE(job != nullptr);
+    REQUIRE(job->getId() == "late");
+    REQUIRE(queue.waitDequeue() == nullptr);
+    producer.join();
+}
+
+TEST_CASE("JobQueue enqueueBatch keeps time order for small and large batches", "[JobQueue]") {
+    JobQueue queue;
+    std::vector<std::shared_ptr<Job>> batch;
+
+    // A large batch triggers a heap rebuild; the small one afterwards is sifted in.
+    for (int i = 0; i < 200; ++i) {
+        batch.push_back(std::make_shared<Job>("", [] {}, nullptr, std::chrono::milliseconds(-((i * 37) % 200) - 1)));
+    }
+    queue.enqueueBatch(batch);
+    REQUIRE(batch.empty());
+    for (int i = 0; i < 3; ++i) {
+        batch.push_back(std::make_shared<Job>("", [] {}, nullptr, std::chrono::milliseconds(-500 + i)));
+    }
+    queue.enqueueBatch(batch);
+    REQUIRE(queue.size() == 203);
+
+    std::vector<std::shared_ptr<Job>> taken;
+    REQUIRE(queue.waitDequeueBatch(taken, 1000) == 203);
+    for (size_t i = 1; i < taken.size(); ++i) {
+        REQUIRE(taken[i - 1]->getScheduledTime() <= taken[i]->getScheduledTime());
+    }
+}
+
+TEST_CASE("JobQueue enqueueBatch wakes enough idle waiters for the due jobs", "[JobQueue]") {
+    JobQueue queue;
+    std::atomic<int> received{0};
+    std::vector<std::thread> waiters;
+    for (int i = 0; i < 4; ++i) {
+        waiters.emplace_back([&queue, &received] {
+            while (queue.waitDequeue()) {
+                ++received;
+            }
+        });
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+
+    std::vector<std::shared_ptr<Job>> batch;
+    for (int i = 0; i < 8; ++i) {
+        batch.push_back(std::make_shared<Job>("", [] {}, nullptr, std::chrono::milliseconds(i < 4 ? 0 : 30)));
+    }
+    queue.enqueueBatch(batch);
+
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+    while (received.load() < 8 && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    queue.close();
+    for (auto& waiter : waiters) {
+        waiter.join();
+    }
+    REQUIRE(received.load() == 8);
+}
+
+TEST_CASE("Sharded JobQueue returns the globally earliest due job across shards", "[JobQueue]") {
+    QueueOptions options;
+    options.shards = 4;
+    JobQueue queue(options);
+
+    // Each producer thread lands on its own shard.
+    std::vector<std::thread> producers;
+    for (int p = 0; p < 4; ++p) {
+        producers.emplace_back([&queue, p] {
+            for (int i = 0; i < 25; ++i) {
+                int age = 1000 - (i * 4 + p) * 5;  // distinct, all in the past
+                queue.enqueue(std::make_shared<Job>("", [] {}, nullptr, std::chrono::milliseconds(-age)));
+            }
+        });
+    }
+    for (auto& producer : producers) {
+        producer.join();
+    }
+    REQUIRE(queue.size() == 100);
+
+    auto previous = Job::TimePoint::min();
+    for (int i = 0; i < 100; ++i) {
+        auto job = queue.dequeueReady();
+        REQUIRE(job != nullptr);
+        REQUIRE(job->getScheduledTime() >= previous);
+        previous = job->getScheduledTime();
+    }
+    REQUIRE(queue.empty());
+    REQUIRE(queue.dequeueReady() == nullptr);
+}
+
+TEST_CASE("Sharded JobQueue delivers every job once and never early", "[JobQueue]") {
+    for (auto selection : {ShardSelection::SubmittingThread, ShardSelection::JobIdHash}) {
+        QueueOptions options;
+        options.shards = 3;
+        options.shard_selection = selection;
+        options.shard_skew = std::chrono::milliseconds(2);
+        JobQueue queue(options);
+
+        constexpr int kProducers = 3;
+        constexpr int kJobsEach = 300;
+        std::atomic<int> received{0};
+        std::atomic<int> early{0};
+        std::vector<std::thread> consumers;
+        for (int c = 0; c < 3; ++c) {
+            consumers.emplace_back([&] {
+                while (auto job = queue.waitDequeue()) {
+                    if (job->getScheduledTime() > std::chrono::system_clock::now()) {
+                        ++early;
+                    }
+                    ++received;
+                }
+            });
+        }
+
+        std::vector<std::thread> producers;
+        for (int p = 0; p < kProducers; ++p) {
+            producers.emplace_back([&queue, p] {
+                std::vector<std::shared_ptr<Job>> batch;
+                for (int i = 0; i < kJobsEach; ++i) {
+                    auto job = std::make_shared<Job>(std::to_string(p * kJobsEach + i), [] {}, nullptr,
+                                                     std::chrono::milliseconds(i % 40));
+                    if (i % 2 == 0) {
+                        queue.enqueue(std::move(job));
+                    } else {
+                        batch.push_back(std::move(job));
+                    }
+                }
+                queue.enqueueBatch(batch);
+            });
+        }
+        for (auto& producer : producers) {
+            producer.join();
+        }
+
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+        while (received.load() < kProducers * kJobsEach && std::chrono::steady_clock::now() < deadline) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        queue.close();
+        for (auto& consumer : consumers) {
+            consumer.join();
+        }
+        REQUIRE(received.load() == kProducers * kJobsEach);
+        REQUIRE(early.load() == 0);
+    }
+}
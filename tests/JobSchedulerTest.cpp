@@ -7,9 +7,12 @@
 #include "Utils.hpp"
 #include <catch2/catch_test_macros.hpp>
 #include <memory>
+#include <mutex>
+#include <set>
 #include <chrono>
 #include <atomic>
 #include <thread>
+#include <vector>
 
 using namespace scheduleit;
 
@@ -56,4 +59,174 @@ TEST_CASE("JobScheduler handles null job submission safely", "[JobScheduler]") {
     scheduler.submit(nullptr);  // Should not crash
     scheduler.shutdown();
     SUCCEED("Null job submission did not crash");
-}
\ No newline at end of file
+}
+
+TEST_CASE("JobScheduler in direct dispatch mode runs jobs and retries", "[JobScheduler]") {
+    SchedulerOptions options;
+    options.dispatch = DispatchMode::Direct;
+    JobScheduler scheduler(2, options);
+    scheduler.start();
+
+    auto retry_strategy = std::make_shared<FixedRetryStrategy>(std::chrono::milliseconds(10));
+    std::atomic<int> plain_runs{0};
+    std::atomic<int> flaky_runs{0};
+
+    for (int i = 0; i < 10; ++i) {
+        scheduler.submit(std::make_shared<Job>("plain", [&plain_runs]() { ++plain_runs; }, retry_strategy));
+    }
+    scheduler.submit(std::make_shared<Job>(
+        "flaky",
+        [&flaky_runs]() {
+            if (++flaky_runs < 3) {
+                throw std::runtime_error("fail");
+            }
+        },
+        retry_strategy,
+        std::chrono::milliseconds(20),
+        3));
+
+    // shutdown() drains queued and retried jobs before the workers exit.
+    scheduler.shutdown();
+
+    REQUIRE(plain_runs == 10);
+    REQUIRE(flaky_runs == 3);
+}
+
+TEST_CASE("JobScheduler runs blocking jobs and their retries on a separate pool", "[JobScheduler]") {
+    for (DispatchMode mode : {DispatchMode::Dispatcher, DispatchMode::Direct}) {
+        SchedulerOptions options;
+        options.dispatch = mode;
+        options.blocking.workers = 2;
+        JobScheduler scheduler(1, options);
+        scheduler.start();
+
+        std::mutex mutex;
+        std::set<std::thread::id> compute_threads;
+        std::set<std::thread::id> blocking_threads;
+        auto record = [&](std::set<std::thread::id>& threads) {
+            std::lock_guard<std::mutex> lock(mutex);
+            threads.insert(std::this_thread::get_id());
+        };
+
+        // Two slow jobs fill the blocking pool; a third fails once and retries behind them.
+        std::atomic<int> flaky_runs{0};
+        for (int i = 0; i < 2; ++i) {
+            auto slow = Job::create("slow", [&]() {
+                record(blocking_threads);
+                std::this_thread::sleep_for(std::chrono::milliseconds(300));
+            }, nullptr, std::chrono::milliseconds(0), 0);
+            slow->setExecutionClass(ExecutionClass::Blocking);
+            scheduler.submit(slow);
+        }
+        auto flaky = std::make_shared<Job>("flaky", [&]() {
+            record(blocking_threads);
+            if (++flaky_runs < 2) {
+                throw std::runtime_error("fail");
+            }
+        }, std::make_shared<FixedRetryStrategy>(std::chrono::milliseconds(1)), std::chrono::milliseconds(0), 2);
+        flaky->setExecutionClass(ExecutionClass::Blocking);
+        scheduler.submit(flaky);
+
+        // Compute jobs are not stuck behind them.
+        std::atomic<int> compute_runs{0};
+        auto start = std::chrono::steady_clock::now();
+        std::vector<std::string> ids;
+        for (int i = 0; i < 50; ++i) {
+            ids.push_back("compute" + std::to_string(i));
+            scheduler.submit(Job::create(ids.back(), [&]() {
+                record(compute_threads);
+                ++compute_runs;
+            }, nullptr, std::chrono::milliseconds(0), 0));
+        }
+        REQUIRE(scheduler.waitForJobs(ids, std::chrono::milliseconds(5000)));
+        REQUIRE(std::chrono::steady_clock::now() - start < std::chrono::milliseconds(250));
+        REQUIRE(scheduler.waitForIdle(std::chrono::milliseconds(5000)));
+
+        REQUIRE(compute_runs.load() == 50);
+        REQUIRE(flaky_runs.load() == 2);
+        REQUIRE(compute_threads.size() == 1);
+        REQUIRE(blocking_threads.size() <= 2);
+        REQUIRE(blocking_threads.count(*compute_threads.begin()) == 0);
+        REQUIRE(scheduler.getMetrics(ExecutionClass::Compute).execution.count == 50);
+        REQUIRE(scheduler.getMetrics(ExecutionClass::Blocking).execution.count == 4);
+        REQUIRE(scheduler.getMetrics().execution.count == 54);
+        scheduler.shutdown();
+    }
+}
+
+TEST_CASE("JobScheduler waitForIdle returns as soon as the last job finishes", "[JobScheduler]") {
+    JobScheduler scheduler(2);
+    scheduler.start();
+
+    std::atomic<int> runs{0};
+    auto start = std::chrono::steady_clock::now();
+    scheduler.submit(std::make_shared<Job>("quick", [&runs]() { ++runs; }, nullptr));
+    scheduler.waitForIdle();
+    auto elapsed = std::chrono::steady_clock::now() - start;
+
+    REQUIRE(runs == 1);
+    REQUIRE(scheduler.getOutstandingCount() == 0);
+    REQUIRE(elapsed < std::chrono::milliseconds(200));
+    scheduler.shutdown();
+}
+
+TEST_CASE("JobScheduler waitForIdle and waitForJobs honour timeouts and id subsets", "[JobScheduler]") {
+    JobScheduler scheduler(2);
+    scheduler.start();
+
+    scheduler.submit(std::make_shared<Job>("slow", [] {}, nullptr, std::chrono::milliseconds(300)));
+    scheduler.submit(std::make_shared<Job>("fast", [] {}, nullptr));
+
+    REQUIRE(scheduler.waitForJobs({"fast"}, std::chrono::milliseconds(200)));
+    REQUIRE_FALSE(scheduler.waitForIdle(std::chrono::milliseconds(20)));
+    REQUIRE_FALSE(scheduler.waitForJobs({"fast", "slow"}, std::chrono::milliseconds(20)));
+    REQUIRE(scheduler.waitForIdle(std::chrono::milliseconds(2000)));
+    scheduler.shutdown();
+}
+
+TEST_CASE("JobScheduler submitBatch runs every job in both dispatch modes", "[JobScheduler]") {
+    for (auto mode : {DispatchMode::Dispatcher, DispatchMode::Direct}) {
+        SchedulerOptions options;
+        options.dispatch = mode;
+        JobScheduler scheduler(2, options);
+        scheduler.start();
+
+        std::atomic<int> counter{0};
+        std::vector<std::shared_ptr<Job>> batch;
+        for (int i = 0; i < 1000; ++i) {
+            batch.push_back(Job::create("", [&counter] { ++counter; }, nullptr,
+                                        std::chrono::milliseconds(i % 3 == 0 ? 20 : 0), 0));
+        }
+        batch.push_back(nullptr);
+        scheduler.submitBatch(std::move(batch));
+
+        REQUIRE(scheduler.waitForIdle(std::chrono::milliseconds(5000)));
+        REQUIRE(counter.load() == 1000);
+        scheduler.shutdown();
+    }
+}
+
+TEST_CASE("JobScheduler runs jobs and retries on a sharded queue", "[JobScheduler]") {
+    SchedulerOptions options;
+    options.dispatch = DispatchMode::Direct;
+    options.queue.shards = 4;
+    JobScheduler scheduler(3, options);
+    scheduler.start();
+
+    auto retry_strategy = std::make_shared<FixedRetryStrategy>(std::chrono::milliseconds(5));
+    std::atomic<int> runs{0};
+    std::atomic<int> flaky_runs{0};
+    for (int i = 0; i < 200; ++i) {
+        scheduler.submit(Job::create("", [&runs] { ++runs; }, nullptr, std::chrono::milliseconds(i % 10), 0));
+    }
+    scheduler.submit(Job::create("flaky", [&flaky_runs] {
+        if (++flaky_runs < 3) {
+            throw std::runtime_error("fail");
+        }
+    }, retry_strategy, std::chrono::milliseconds(0), 3));
+
+    REQUIRE(scheduler.waitForIdle(std::chrono::milliseconds(5000)));
+    REQUIRE(runs.load() == 200);
+    REQUIRE(flaky_runs.load() == 3);
+    scheduler.shutdown();
+}
@@ -0,0 +1,323 @@
+#include "JobScheduler.hpp"
+#include "Journal.hpp"
+#include "TaskRegistry.hpp"
+#include "FixedRetryStrategy.hpp"
+#include "Utils.hpp"
+#include <catch2/catch_test_macros.hpp>
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace scheduleit;
+using namespace std::chrono;
+namespace fs = std::filesystem;
+
+namespace {
+
+struct TempDir {
+    explicit TempDir(const std::string& name)
+        : path((fs::temp_directory_path() / ("scheduleit-journal-" + name)).string()) {
+        fs::remove_all(path);
+    }
+    ~TempDir() {
+        fs::remove_all(path);
+    }
+    size_t segmentCount() const {
+        size_t count = 0;
+        for (const auto& entry : fs::directory_iterator(path)) {
+            count += entry.path().extension() == ".log";
+        }
+        return count;
+    }
+    std::string path;
+};
+
+std::shared_ptr<TaskRegistry> makeRegistry(std::atomic<int>& sum) {
+    auto registry = std::make_shared<TaskRegistry>();
+    registry->add("add", [&sum](const std::string& payload) -> Job::Task {
+        int amount = std::stoi(payload);
+        return [&sum, amount]() { sum += amount; };
+    }, std::make_shared<FixedRetryStrategy>(hours(1)));
+    registry->add("fail", [](const std::string&) -> Job::Task {
+        return []() { throw std::runtime_error("always fails"); };
+    }, std::make_shared<FixedRetryStrategy>(hours(1)));
+    return registry;
+}
+
+JournalOptions optionsFor(const TempDir& dir) {
+    JournalOptions options;
+    options.directory = dir.path;
+    options.commit_interval = microseconds(200);
+    return options;
+}
+
+}
+
+TEST_CASE("Journal brings pending jobs back after a restart", "[Journal]") {
+    TempDir dir("restart");
+    std::atomic<int> sum{0};
+    auto registry = makeRegistry(sum);
+    {
+        // Never started, so shutdown does not wait and the jobs are left pending.
+        SchedulerOptions options;
+        options.journal = std::make_shared<Journal>(optionsFor(dir), registry);
+        JobScheduler scheduler(1, options);
+        scheduler.submit(registry->create("add", "1"));
+        auto high = registry->create("add", "10", milliseconds(20), 3, "high");
+        high->setPriority(JobPriority::High);
+        high->setExecutionClass(ExecutionClass::Blocking);
+        scheduler.submitBatch({high, registry->create("add", "100")});
+        scheduler.submit(Job::create("", [&sum]() { sum += 1000; }, nullptr));  // not durable
+    }
+
+    {
+        SchedulerOptions options;
+        options.journal = std::make_shared<Journal>(optionsFor(dir), registry);
+        options.blocking.workers = 1;
+        JobScheduler scheduler(1, options);
+        const auto& stats = options.journal->getRecoveryStats();
+        REQUIRE(stats.recovered == 3);
+        REQUIRE(stats.records == 3);
+        REQUIRE(scheduler.getOutstandingCount() == 3);
+        scheduler.start();
+        REQUIRE(scheduler.waitForJobs({"high"}, milliseconds(2000)));
+        REQUIRE(scheduler.waitForIdle(milliseconds(2000)));
+        REQUIRE(scheduler.getMetrics(ExecutionClass::Blocking).execution.count == 1);
+        scheduler.shutdown();
+        REQUIRE(sum.load() == 111);
+    }
+
+    // Everything completed, so a third start finds nothing and the old segments are gone.
+    {
+        Journal journal(optionsFor(dir), registry);
+        REQUIRE(journal.recover().empty());
+        REQUIRE_THROWS_AS(journal.recover(), std::runtime_error);
+    }
+    REQUIRE(dir.segmentCount() == 0);
+}
+
+TEST_CASE("Journal restores a job waiting for its retry", "[Journal]") {
+    TempDir dir("retry");
+    std::atomic<int> sum{0};
+    auto registry = makeRegistry(sum);
+    SchedulerOptions options;
+    options.journal = std::make_shared<Journal>(optionsFor(dir), registry);
+    JobScheduler scheduler(1, options);
+    scheduler.start();
+    auto failing = scheduler.submit(registry->create("fail", "", milliseconds(0), 3, "f"));
+    while (scheduler.getExecutor()->getPendingRetryCount() == 0) {
+        utils::sleepForMillis(milliseconds(1));
+    }
+    options.journal->sync();
+
+    // Read the journal as a restarted process would, while this one still runs.
+    {
+        Journal restarted(optionsFor(dir), registry);
+        auto jobs = restarted.recover();
+        REQUIRE(jobs.size() == 1);
+        REQUIRE(jobs[0]->getId() == "f");
+        REQUIRE(jobs[0]->getAttempt() == 1);
+        REQUIRE(jobs[0]->getScheduledTime() == failing.getJob()->getScheduledTime());
+        REQUIRE(jobs[0]->getDurableTask()->name == "fail");
+    }
+    REQUIRE(failing.cancel());
+    scheduler.shutdown();
+}
+
+TEST_CASE("Journal cuts a torn tail and drops unknown tasks", "[Journal]") {
+    TempDir dir("torn");
+    std::atomic<int> sum{0};
+    auto registry = makeRegistry(sum);
+    {
+        Journal journal(optionsFor(dir), registry);
+        journal.recover();
+        for (int i = 0; i < 5; ++i) {
+            auto job = registry->create("add", std::to_string(i), hours(1));
+            journal.recordSubmit(job);
+        }
+        auto orphan = registry->create("fail", "");
+        journal.recordSubmit(orphan);
+    }
+    std::string segment;
+    for (const auto& entry : fs::directory_iterator(dir.path)) {
+        segment = entry.path().string();
+    }
+    auto intact = fs::file_size(segment);
+    {
+        std::ofstream out(segment, std::ios::binary | std::ios::app);
+        out << "half a record";
+    }
+
+    auto registry_without_fail = std::make_shared<TaskRegistry>();
+    registry_without_fail->add("add", [](const std::string&) -> Job::Task { return []() {}; });
+    Journal journal(optionsFor(dir), registry_without_fail);
+    auto jobs = journal.recover();
+    const auto& stats = journal.getRecoveryStats();
+    REQUIRE(jobs.size() == 5);
+    REQUIRE(stats.unknown_task == 1);
+    REQUIRE(stats.torn_bytes == 13);
+    REQUIRE(fs::file_size(segment) == intact);
+    for (const auto& job : jobs) {
+        REQUIRE(job->getScheduledTime() > utils::now() + minutes(59));
+    }
+}
+
+TEST_CASE("Journal deletes segments whose jobs have all completed", "[Journal]") {
+    TempDir dir("segments");
+    std::atomic<int> sum{0};
+    auto registry = makeRegistry(sum);
+    auto options = optionsFor(dir);
+    options.segment_bytes = 4096;
+    options.compact_ratio = 0;
+    Journal journal(options, registry);
+    journal.recover();
+
+    auto pinned = registry->create("add", "0", hours(1));
+    journal.recordSubmit(pinned);
+    std::vector<std::shared_ptr<Job>> jobs;
+    for (int i = 0; i < 2000; ++i) {
+        jobs.push_back(registry->create("add", std::to_string(i)));
+    }
+    journal.recordSubmitBatch(jobs);
+    journal.sync();  // otherwise the done records would cancel the full ones before they are written
+    for (const auto& job : jobs) {
+        journal.recordDone(job);
+    }
+    journal.sync();
+    // The first segment holds the pinned job, so nothing after it can go either.
+    REQUIRE(journal.getStats().segments_deleted == 0);
+
+    journal.recordDone(pinned);
+    journal.sync();
+    journal.recordDone(pinned);  // a second done record is ignored
+    auto stats = journal.getStats();
+    REQUIRE(stats.segments_deleted > 10);
+    REQUIRE(stats.segments_live == 1);
+    REQUIRE(stats.records == 4002);
+    REQUIRE(stats.commits >= 1);
+    journal.sync();
+    REQUIRE(dir.segmentCount() <= 1);
+}
+
+TEST_CASE("Journal compacts segments held by one long-pending job", "[Journal]") {
+    TempDir dir("compact");
+    std::atomic<int> sum{0};
+    auto registry = makeRegistry(sum);
+    auto options = optionsFor(dir);
+    options.segment_bytes = 4096;
+    {
+        Journal journal(options, registry);
+        journal.recover();
+        auto pinned = registry->create("add", "7", hours(1));
+        journal.recordSubmit(pinned);
+        for (int round = 0; round < 20; ++round) {
+            std::vector<std::shared_ptr<Job>> jobs;
+            for (int i = 0; i < 500; ++i) {
+                jobs.push_back(registry->create("add", std::to_string(i)));
+            }
+            journal.recordSubmitBatch(jobs);
+            journal.sync();
+            for (const auto& job : jobs) {
+                journal.recordDone(job);
+            }
+            journal.sync();
+            REQUIRE(journal.getStats().segments_live <= 4);
+            REQUIRE(dir.segmentCount() <= 4);
+        }
+        auto stats = journal.getStats();
+        REQUIRE(stats.segments_deleted > 100);
+        // A segment is compacted once fewer than a quarter of its records are live.
+        REQUIRE(stats.compacted > 0);
+        REQUIRE(stats.compacted < stats.records / 4);
+    }
+    Journal journal(options, registry);
+    auto jobs = journal.recover();
+    REQUIRE(jobs.size() == 1);
+    REQUIRE(jobs[0]->getDurableTask()->payload == "7");
+}
+
+TEST_CASE("Journal writes nothing for jobs that finish before their first commit", "[Journal]") {
+    TempDir dir("unwritten");
+    std::atomic<int> sum{0};
+    auto registry = makeRegistry(sum);
+    auto options = optionsFor(dir);
+    options.commit_interval = seconds(10);
+    {
+        Journal journal(options, registry);
+        journal.recover();
+        auto done = registry->create("add", "1", hours(1));
+        auto live = registry->create("add", "2", hours(1));
+        journal.recordSubmit(done);
+        journal.recordSubmit(live);
+        journal.recordDone(done);
+        journal.recordUpdate(done);  // lost the race to the done record
+        journal.sync();
+        auto stats = journal.getStats();
+        REQUIRE(stats.records == 1);
+        REQUIRE(stats.commits == 1);
+    }
+    Journal journal(optionsFor(dir), registry);
+    auto jobs = journal.recover();
+    REQUIRE(jobs.size() == 1);
+    REQUIRE(jobs[0]->getDurableTask()->payload == "2");
+}
+
+TEST_CASE("Journal fails sync() for good after a write error", "[Journal]") {
+    TempDir dir("failed");
+    std::atomic<int> sum{0};
+    auto registry = makeRegistry(sum);
+    Journal journal(optionsFor(dir), registry);
+    journal.recover();
+    // The first commit creates the first segment, which fails once the directory is gone.
+    fs::remove_all(dir.path);
+
+    auto job = registry->create("add", "1", hours(1));
+    journal.recordSubmit(job);
+    REQUIRE_THROWS_AS(journal.sync(), std::runtime_error);
+    REQUIRE(journal.getStats().commits == 0);
+
+    fs::create_directories(dir.path);
+    journal.recordSubmit(registry->create("add", "2", hours(1)));
+    journal.recordDone(job);
+    REQUIRE_THROWS_AS(journal.sync(), std::runtime_error);
+    REQUIRE(journal.getStats().records == 0);
+    REQUIRE(dir.segmentCount() == 0);
+}
+
+TEST_CASE("Journal restores a recurring job's schedule", "[Journal]") {
+    TempDir dir("recurring");
+    std::atomic<int> sum{0};
+    auto registry = makeRegistry(sum);
+    {
+        Journal journal(optionsFor(dir), registry);
+        journal.recover();
+        auto job = registry->create("add", "1", hours(1));
+        Recurrence recurrence;
+        recurrence.mode = RecurrenceMode::FixedDelay;
+        recurrence.period = milliseconds(250);
+        recurrence.max_firings = 9;
+        job->setRecurrence(recurrence);
+        journal.recordSubmit(job);
+    }
+    Journal journal(optionsFor(dir), registry);
+    auto jobs = journal.recover();
+    REQUIRE(jobs.size() == 1);
+    REQUIRE(jobs[0]->isRecurring());
+    REQUIRE(jobs[0]->getRecurrence().mode == RecurrenceMode::FixedDelay);
+    REQUIRE(jobs[0]->getRecurrence().period == milliseconds(250));
+    REQUIRE(jobs[0]->getRecurrence().max_firings == 9);
+}
+
+TEST_CASE("TaskRegistry rejects unknown names and empty factories", "[Journal]") {
+    TaskRegistry registry;
+    REQUIRE_THROWS_AS(registry.add("", [](const std::string&) -> Job::Task { return []() {}; }),
+                      std::invalid_argument);
+    REQUIRE_THROWS_AS(registry.add("x", nullptr), std::invalid_argument);
+    REQUIRE_THROWS_AS(registry.create("missing", ""), std::invalid_argument);
+    REQUIRE_FALSE(registry.contains("missing"));
+}
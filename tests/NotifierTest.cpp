@@ -0,0 +1,100 @@
+#include "Notifier.hpp"
+#include "JobScheduler.hpp"
+#include "FixedRetryStrategy.hpp"
+#include <catch2/catch_test_macros.hpp>
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace scheduleit;
+using namespace std::chrono;
+
+namespace {
+
+size_t lineCount(const std::ostringstream& stream) {
+    std::string text = stream.str();
+    return static_cast<size_t>(std::count(text.begin(), text.end(), '\n'));
+}
+
+}
+
+TEST_CASE("Notifier writes job events from a background thread", "[Notifier]") {
+    std::ostringstream out;
+    std::ostringstream err;
+    NotifierOptions options;
+    options.out = &out;
+    options.err = &err;
+    auto notifier = std::make_shared<Notifier>(options);
+
+    JobScheduler scheduler(2);
+    scheduler.getExecutor()->registerObserver(notifier);
+    scheduler.start();
+    auto retry = std::make_shared<FixedRetryStrategy>(milliseconds(1));
+    bool failed = false;
+    scheduler.submit(Job::create("flaky", [&failed]() {
+        if (!failed) {
+            failed = true;
+            throw std::runtime_error("first attempt fails");
+        }
+    }, retry, milliseconds(0), 2));
+    scheduler.submit(Job::create(std::string(60, 'x'), []() {}, retry));
+    REQUIRE(scheduler.waitForIdle(milliseconds(2000)));
+    notifier->flush();
+
+    REQUIRE(out.str().find("[Notifier] Job succeeded: flaky | Time: ") != std::string::npos);
+    REQUIRE(out.str().find("[Notifier] Job succeeded: " + std::string(48, 'x') + "... | Time: ") != std::string::npos);
+    REQUIRE(err.str().find("[Notifier] Job failed: flaky | Attempt: 0 | Time: ") != std::string::npos);
+    REQUIRE(lineCount(out) == 2);
+    REQUIRE(lineCount(err) == 1);
+    REQUIRE(notifier->getWrittenCount() == 3);
+    REQUIRE(notifier->getDroppedCount() == 0);
+    scheduler.shutdown();
+}
+
+TEST_CASE("Notifier drops and counts events once a ring is full", "[Notifier]") {
+    std::ostringstream out;
+    NotifierOptions options;
+    options.ring_capacity = 4;
+    options.flush_interval = seconds(10);
+    options.out = &out;
+    Notifier notifier(options);
+    auto job = Job::create("j", []() {}, nullptr);
+    for (int i = 0; i < 10000; ++i) {
+        notifier.onJobSuccess(*job);
+    }
+    notifier.flush();
+    REQUIRE(notifier.getDroppedCount() > 0);
+    REQUIRE(notifier.getWrittenCount() + notifier.getDroppedCount() == 10000);
+    REQUIRE(lineCount(out) == notifier.getWrittenCount());
+}
+
+TEST_CASE("Notifier with the Block policy loses nothing", "[Notifier]") {
+    std::ostringstream out;
+    {
+        NotifierOptions options;
+        options.ring_capacity = 4;
+        options.drop_policy = NotifierDropPolicy::Block;
+        options.out = &out;
+        Notifier notifier(options);
+        auto job = Job::create("j", []() {}, nullptr);
+        std::vector<std::thread> producers;
+        for (int t = 0; t < 2; ++t) {
+            producers.emplace_back([&]() {
+                for (int i = 0; i < 5000; ++i) {
+                    notifier.onJobSuccess(*job);
+                }
+            });
+        }
+        for (auto& producer : producers) {
+            producer.join();
+        }
+        REQUIRE(notifier.getDroppedCount() == 0);
+    }
+    // The destructor writes whatever was still buffered.
+    REQUIRE(lineCount(out) == 10000);
+}
@@ -0,0 +1,145 @@
+#include "ObserverRegistry.hpp"
+#include "JobScheduler.hpp"
+#include "FixedRetryStrategy.hpp"
+#include "Utils.hpp"
+#include <catch2/catch_test_macros.hpp>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+using namespace scheduleit;
+using namespace std::chrono;
+
+namespace {
+
+class CountingObserver : public Observer {
+public:
+    void onJobFailed(const Job&, int) override {
+        ++failed;
+    }
+    void onJobSuccess(const Job&) override {
+        ++succeeded;
+    }
+    void onJobCancelled(const Job&) override {
+        ++cancelled;
+    }
+    std::atomic<int> succeeded{0};
+    std::atomic<int> failed{0};
+    std::atomic<int> cancelled{0};
+};
+
+class RecordingBatchObserver : public BatchObserver {
+public:
+    void onJobEvents(const JobEvent* events, size_t count) override {
+        std::lock_guard<std::mutex> lock(mutex);
+        ++calls;
+        largest_batch = std::max(largest_batch, count);
+        for (size_t i = 0; i < count; ++i) {
+            ++by_kind[static_cast<int>(events[i].kind)];
+        }
+    }
+    std::mutex mutex;
+    size_t calls = 0;
+    size_t largest_batch = 0;
+    int by_kind[3] = {0, 0, 0};
+};
+
+}
+
+TEST_CASE("Observers can be added and removed while jobs run", "[Observer]") {
+    JobScheduler scheduler(2);
+    scheduler.start();
+    std::atomic<bool> stop{false};
+    std::thread producer([&]() {
+        while (!stop) {
+            scheduler.submit(Job::create("", []() {}, nullptr, milliseconds(0), 0));
+            std::this_thread::yield();
+        }
+    });
+
+    auto observer = std::make_shared<CountingObserver>();
+    std::weak_ptr<CountingObserver> weak = observer;
+    for (int round = 0; round < 20; ++round) {
+        scheduler.getExecutor()->registerObserver(observer);
+        utils::sleepForMillis(milliseconds(1));
+        REQUIRE(scheduler.getExecutor()->unregisterObserver(observer));
+        int seen = observer->succeeded.load();
+        utils::sleepForMillis(milliseconds(1));
+        REQUIRE(observer->succeeded.load() == seen);  // no callback after remove returned
+    }
+    stop = true;
+    producer.join();
+    REQUIRE(scheduler.waitForIdle(milliseconds(5000)));
+    REQUIRE(observer->succeeded.load() > 0);
+    REQUIRE_FALSE(scheduler.getExecutor()->unregisterObserver(observer));
+
+    // The registry kept no copy once the grace period was over.
+    observer.reset();
+    REQUIRE(weak.expired());
+    scheduler.shutdown();
+}
+
+TEST_CASE("BatchObserver receives every event in per-worker spans", "[Observer]") {
+    JobScheduler scheduler(2);
+    auto batch = std::make_shared<RecordingBatchObserver>();
+    auto counting = std::make_shared<CountingObserver>();
+    scheduler.getExecutor()->registerBatchObserver(batch);
+    scheduler.getExecutor()->registerObserver(counting);
+
+    auto retry = std::make_shared<FixedRetryStrategy>(milliseconds(1));
+    std::vector<std::shared_ptr<Job>> jobs;
+    for (int i = 0; i < 2000; ++i) {
+        jobs.push_back(Job::create("", []() {}, retry, milliseconds(0), 0));
+    }
+    scheduler.submitBatch(std::move(jobs));
+    scheduler.submit(Job::create("", []() { throw std::runtime_error("fails"); }, retry, milliseconds(0), 1));
+    auto handle = scheduler.submit(Job::create("", []() {}, retry, hours(1), 0));
+    REQUIRE(handle.cancel());
+    scheduler.start();
+    REQUIRE(scheduler.waitForIdle(milliseconds(5000)));
+    scheduler.getExecutor()->flushObservers();
+
+    std::lock_guard<std::mutex> lock(batch->mutex);
+    REQUIRE(batch->by_kind[static_cast<int>(JobEventKind::Succeeded)] == 2000);
+    REQUIRE(batch->by_kind[static_cast<int>(JobEventKind::Failed)] == 2);
+    REQUIRE(batch->by_kind[static_cast<int>(JobEventKind::Cancelled)] == 1);
+    REQUIRE(counting->succeeded.load() == 2000);
+    REQUIRE(counting->failed.load() == 2);
+    REQUIRE(counting->cancelled.load() == 1);
+    REQUIRE(batch->calls < 2003);
+    REQUIRE(batch->largest_batch > 1);
+    scheduler.shutdown();
+}
+
+TEST_CASE("An observer can remove itself from its own callback", "[Observer]") {
+    class OneShot : public Observer {
+    public:
+        explicit OneShot(JobExecutor* executor) : executor_(executor) {}
+        void onJobFailed(const Job&, int) override {}
+        void onJobSuccess(const Job&) override {
+            ++calls;
+            executor_->unregisterObserver(self.lock());
+        }
+        std::weak_ptr<Observer> self;
+        std::atomic<int> calls{0};
+
+    private:
+        JobExecutor* executor_;
+    };
+
+    JobScheduler scheduler(1);
+    auto observer = std::make_shared<OneShot>(scheduler.getExecutor());
+    observer->self = observer;
+    scheduler.getExecutor()->registerObserver(observer);
+    for (int i = 0; i < 10; ++i) {
+        scheduler.submit(Job::create("", []() {}, nullptr, milliseconds(0), 0));
+    }
+    scheduler.start();
+    REQUIRE(scheduler.waitForIdle(milliseconds(2000)));
+    REQUIRE(observer->calls.load() == 1);
+    scheduler.shutdown();
+}
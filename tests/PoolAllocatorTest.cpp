@@ -0,0 +1,54 @@
+#include "Job.hpp"
+#include "PoolAllocator.hpp"
+#include <catch2/catch_test_macros.hpp>
+#include <algorithm>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+using namespace scheduleit;
+
+TEST_CASE("Job::create builds a usable pooled job", "[PoolAllocator]") {
+    bool ran = false;
+    auto job = Job::create("pooled", [&ran] { ran = true; }, nullptr, std::chrono::milliseconds(0), 1);
+
+    REQUIRE(job->getId() == "pooled");
+    job->execute();
+    REQUIRE(ran);
+
+    std::weak_ptr<Job> weak = job;
+    job.reset();
+    REQUIRE(weak.expired());
+}
+
+TEST_CASE("PoolAllocator reuses freed blocks, including ones freed on another thread", "[PoolAllocator]") {
+    using Pool = BlockPool<64, 8>;
+
+    void* first = Pool::allocate();
+    Pool::deallocate(first);
+    REQUIRE(Pool::allocate() == first);
+    Pool::deallocate(first);
+
+    std::vector<void*> blocks;
+    for (int i = 0; i < 4096; ++i) {
+        blocks.push_back(Pool::allocate());
+    }
+    std::thread releaser([&blocks] {
+        for (void* block : blocks) {
+            Pool::deallocate(block);
+        }
+    });
+    releaser.join();
+
+    // The exiting thread handed its blocks back, so they are served again here.
+    std::vector<void*> again;
+    for (int i = 0; i < 4096; ++i) {
+        again.push_back(Pool::allocate());
+    }
+    size_t reused = 0;
+    for (void* block : again) {
+        reused += std::find(blocks.begin(), blocks.end(), block) != blocks.end();
+        Pool::deallocate(block);
+    }
+    REQUIRE(reused == again.size());
+}
@@ -0,0 +1,117 @@
+#include "PriorityJobStore.hpp"
+#include "HeapJobStore.hpp"
+#include "JobQueue.hpp"
+#include <catch2/catch_test_macros.hpp>
+#include <array>
+#include <chrono>
+#include <memory>
+
+using namespace scheduleit;
+
+namespace {
+
+std::shared_ptr<Job> makeJob(JobPriority priority, std::chrono::milliseconds delay) {
+    auto job = std::make_shared<Job>("", [] {}, nullptr, delay, 0);
+    job->setPriority(priority);
+    return job;
+}
+
+std::unique_ptr<PriorityJobStore> makeStore(PriorityPolicy policy, std::chrono::milliseconds aging) {
+    return std::make_unique<PriorityJobStore>(std::make_unique<HeapJobStore>(), policy,
+                                              std::array<unsigned, kJobPriorityCount>{{8, 4, 2, 1}}, aging);
+}
+
+}
+
+TEST_CASE("PriorityJobStore weighted-fair serves classes in proportion to weight", "[PriorityJobStore]") {
+    auto store = makeStore(PriorityPolicy::WeightedFair, std::chrono::milliseconds(100));
+
+    // The low-priority flood is due first, yet critical jobs get 8 of every 9 dequeues.
+    for (int i = 0; i < 90; ++i) {
+        store->push(makeJob(JobPriority::Low, std::chrono::milliseconds(-1000)));
+    }
+    for (int i = 0; i < 90; ++i) {
+        store->push(makeJob(JobPriority::Critical, std::chrono::milliseconds(-10)));
+    }
+
+    auto now = std::chrono::system_clock::now();
+    int critical = 0;
+    for (int i = 0; i < 45; ++i) {
+        auto job = store->popReady(now);
+        REQUIRE(job != nullptr);
+        critical += job->getPriority() == JobPriority::Critical;
+    }
+    REQUIRE(critical == 40);
+    REQUIRE(store->size() == 135);
+}
+
+TEST_CASE("PriorityJobStore strict policy serves aged lower classes", "[PriorityJobStore]") {
+    auto now = std::chrono::system_clock::now();
+
+    auto fresh = makeStore(PriorityPolicy::StrictWithAging, std::chrono::hours(1));
+    fresh->push(makeJob(JobPriority::Low, std::chrono::milliseconds(-500)));
+    fresh->push(makeJob(JobPriority::High, std::chrono::milliseconds(-1)));
+    REQUIRE(fresh->popReady(now)->getPriority() == JobPriority::High);
+    REQUIRE(fresh->popReady(now)->getPriority() == JobPriority::Low);
+
+    auto aged = makeStore(PriorityPolicy::StrictWithAging, std::chrono::milliseconds(100));
+    aged->push(makeJob(JobPriority::Low, std::chrono::milliseconds(-500)));
+    aged->push(makeJob(JobPriority::High, std::chrono::milliseconds(-1)));
+    REQUIRE(aged->popReady(now)->getPriority() == JobPriority::Low);
+
+    // Jobs that are not yet due are never released, whatever their class.
+    aged->push(makeJob(JobPriority::Critical, std::chrono::milliseconds(1000)));
+    REQUIRE(aged->popReady(now)->getPriority() == JobPriority::High);
+    REQUIRE(aged->popReady(now) == nullptr);
+}
+
+TEST_CASE("JobQueue reports per-class depth and wait counters", "[PriorityJobStore]") {
+    QueueOptions options;
+    options.priority_policy = PriorityPolicy::WeightedFair;
+    JobQueue queue(options);
+
+    queue.enqueue(makeJob(JobPriority::High, std::chrono::milliseconds(-20)));
+    queue.enqueue(makeJob(JobPriority::High, std::chrono::milliseconds(-20)));
+    queue.enqueue(makeJob(JobPriority::Low, std::chrono::milliseconds(60000)));
+
+    REQUIRE(queue.dequeueReady() != nullptr);
+    auto stats = queue.getPriorityStats();
+    auto high = static_cast<size_t>(JobPriority::High);
+    auto low = static_cast<size_t>(JobPriority::Low);
+    REQUIRE(stats[high].queued == 1);
+    REQUIRE(stats[high].ready == 1);
+    REQUIRE(stats[high].dequeued == 1);
+    REQUIRE(stats[high].max_wait >= std::chrono::milliseconds(20));
+    REQUIRE(stats[low].queued == 1);
+    REQUIRE(stats[low].ready == 0);
+}
+
+TEST_CASE("PriorityJobStore earliest-deadline-first orders due jobs by deadline", "[PriorityJobStore]") {
+    auto now = std::chrono::system_clock::now();
+    auto store = makeStore(PriorityPolicy::EarliestDeadlineFirst, std::chrono::milliseconds(100));
+
+    auto withDeadline = [&](JobPriority priority, std::chrono::milliseconds delay, std::chrono::milliseconds due) {
+        auto job = makeJob(priority, delay);
+        job->setDeadline(now + due);
+        return job;
+    };
+    auto late = withDeadline(JobPriority::Critical, std::chrono::milliseconds(-30), std::chrono::milliseconds(300));
+    auto soon = withDeadline(JobPriority::Low, std::chrono::milliseconds(-10), std::chrono::milliseconds(20));
+    auto none_old = makeJob(JobPriority::High, std::chrono::milliseconds(-50));
+    auto none_new = makeJob(JobPriority::High, std::chrono::milliseconds(-5));
+    auto future = withDeadline(JobPriority::Low, std::chrono::milliseconds(1000), std::chrono::milliseconds(1));
+    for (const auto& job : {none_new, late, future, none_old, soon}) {
+        store->push(job);
+    }
+
+    // Classes are ignored; jobs without a deadline come last, oldest first.
+    REQUIRE(store->popReady(now) == soon);
+    REQUIRE(store->stats()[static_cast<size_t>(JobPriority::High)].ready == 2);
+    REQUIRE(store->nextWakeTime() <= now);
+    REQUIRE(store->popReady(now) == late);
+    REQUIRE(store->popReady(now) == none_old);
+    REQUIRE(store->popReady(now) == none_new);
+    REQUIRE(store->popReady(now) == nullptr);
+    REQUIRE(store->nextWakeTime() == future->getScheduledTime());
+    REQUIRE(store->stats()[static_cast<size_t>(JobPriority::Critical)].dequeued == 1);
+}
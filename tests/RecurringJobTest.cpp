@@ -0,0 +1,208 @@
+#include "JobScheduler.hpp"
+#include "Job.hpp"
+#include "FixedRetryStrategy.hpp"
+#include "Utils.hpp"
+#include <catch2/catch_test_macros.hpp>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <vector>
+
+using namespace scheduleit;
+using namespace std::chrono;
+
+namespace {
+
+std::shared_ptr<Job> makeRecurring(Job::Task task, const Recurrence& recurrence,
+                                   milliseconds delay = milliseconds(0), int max_retries = 0) {
+    auto retry = std::make_shared<FixedRetryStrategy>(milliseconds(5));
+    auto job = Job::create("", std::move(task), retry, delay, max_retries);
+    job->setRecurrence(recurrence);
+    return job;
+}
+
+}
+
+TEST_CASE("Fixed-rate job fires on its grid with the same Job object", "[Recurring]") {
+    JobScheduler scheduler(2);
+    scheduler.start();
+
+    std::mutex mutex;
+    std::vector<Job::TimePoint> starts;
+    Recurrence recurrence;
+    recurrence.period = milliseconds(40);
+    recurrence.max_firings = 5;
+    auto job = makeRecurring([&]() {
+        std::lock_guard<std::mutex> lock(mutex);
+        starts.push_back(utils::now());
+    }, recurrence);
+    auto first = job->getScheduledTime();
+    scheduler.submit(job);
+
+    REQUIRE(scheduler.waitForIdle(milliseconds(2000)));
+    scheduler.shutdown();
+    REQUIRE(starts.size() == 5);
+    REQUIRE(job->getFiringCount() == 5);
+    REQUIRE(job->getState() == JobState::Finished);
+    REQUIRE(scheduler.getExecutor()->getFiringsScheduled() == 4);
+    for (size_t i = 0; i < starts.size(); ++i) {
+        // Never early, and lateness does not accumulate from one firing to the next.
+        auto nominal = first + recurrence.period * static_cast<int>(i);
+        REQUIRE(starts[i] >= nominal);
+        REQUIRE(starts[i] - nominal < milliseconds(35));
+    }
+}
+
+TEST_CASE("Fixed-delay job waits one period after each firing ends", "[Recurring]") {
+    JobScheduler scheduler(1);
+    scheduler.start();
+
+    std::vector<Job::TimePoint> starts;
+    Recurrence recurrence;
+    recurrence.mode = RecurrenceMode::FixedDelay;
+    recurrence.period = milliseconds(30);
+    recurrence.max_firings = 3;
+    scheduler.submit(makeRecurring([&]() {
+        starts.push_back(utils::now());
+        utils::sleepForMillis(milliseconds(20));
+    }, recurrence));
+
+    REQUIRE(scheduler.waitForIdle(milliseconds(2000)));
+    scheduler.shutdown();
+    REQUIRE(starts.size() == 3);
+    for (size_t i = 1; i < starts.size(); ++i) {
+        REQUIRE(starts[i] - starts[i - 1] >= milliseconds(50));
+    }
+}
+
+TEST_CASE("Missed firings are caught up or skipped", "[Recurring]") {
+    for (auto policy : {MissedFiringPolicy::CatchUp, MissedFiringPolicy::Skip}) {
+        JobScheduler scheduler(1);
+        scheduler.start();
+
+        std::atomic<int> runs{0};
+        Recurrence recurrence;
+        recurrence.period = milliseconds(50);
+        recurrence.missed = policy;
+        recurrence.max_firings = 4;
+        // The first firing overruns three and a half periods.
+        auto job = makeRecurring([&runs]() {
+            if (runs++ == 0) {
+                utils::sleepForMillis(milliseconds(175));
+            }
+        }, recurrence);
+        auto first = job->getScheduledTime();
+        scheduler.submit(job);
+
+        REQUIRE(scheduler.waitForIdle(milliseconds(3000)));
+        auto finished = utils::now();
+        scheduler.shutdown();
+        REQUIRE(runs.load() == 4);
+        if (policy == MissedFiringPolicy::CatchUp) {
+            // Slots 50, 100 and 150 run back to back right after the overrun.
+            REQUIRE(finished - first < milliseconds(260));
+        } else {
+            // They are dropped; the series resumes at slots 200, 250 and 300.
+            REQUIRE(finished - first >= milliseconds(300));
+        }
+    }
+}
+
+TEST_CASE("Cancelling a recurring job ends its series", "[Recurring]") {
+    JobScheduler scheduler(2);
+    scheduler.start();
+
+    std::atomic<int> idle_runs{0};
+    std::atomic<int> busy_runs{0};
+    Recurrence recurrence;
+    recurrence.period = milliseconds(10);
+    auto idle = scheduler.submit(makeRecurring([&idle_runs]() { ++idle_runs; }, recurrence));
+    auto busy = scheduler.submit(makeRecurring([&busy_runs]() {
+        ++busy_runs;
+        utils::sleepForMillis(milliseconds(30));
+    }, recurrence));
+
+    utils::sleepForMillis(milliseconds(100));
+    REQUIRE(idle.cancel());
+    REQUIRE(busy.cancel());
+    REQUIRE_FALSE(busy.cancel());
+    REQUIRE(scheduler.waitForIdle(milliseconds(1000)));
+    int idle_seen = idle_runs.load();
+    int busy_seen = busy_runs.load();
+    utils::sleepForMillis(milliseconds(60));
+    scheduler.shutdown();
+    REQUIRE(idle_seen > 1);
+    REQUIRE(busy_seen > 1);
+    REQUIRE(idle_runs.load() == idle_seen);
+    REQUIRE(busy_runs.load() == busy_seen);
+}
+
+TEST_CASE("A failing firing is retried before the next one is planned", "[Recurring]") {
+    JobScheduler scheduler(1);
+    scheduler.start();
+
+    std::atomic<int> runs{0};
+    Recurrence recurrence;
+    recurrence.period = milliseconds(20);
+    recurrence.max_firings = 3;
+    auto job = makeRecurring([&runs]() {
+        if (runs++ % 2 == 0) {
+            throw std::runtime_error("every first attempt fails");
+        }
+    }, recurrence, milliseconds(0), 1);
+    scheduler.submit(job);
+
+    REQUIRE(scheduler.waitForIdle(milliseconds(2000)));
+    scheduler.shutdown();
+    REQUIRE(runs.load() == 6);
+    REQUIRE(job->getFiringCount() == 3);
+    REQUIRE(scheduler.getExecutor()->getRetriesScheduled() == 3);
+}
+
+TEST_CASE("Shutdown stops recurring jobs instead of waiting for them", "[Recurring]") {
+    for (auto mode : {DispatchMode::Dispatcher, DispatchMode::Direct}) {
+        SchedulerOptions options;
+        options.dispatch = mode;
+        JobScheduler scheduler(2, options);
+        scheduler.start();
+        Recurrence recurrence;
+        recurrence.period = milliseconds(5);
+        scheduler.submit(makeRecurring([]() {}, recurrence));
+        scheduler.submit(makeRecurring([]() {}, recurrence, milliseconds(3600000)));
+        utils::sleepForMillis(milliseconds(30));
+
+        auto start = steady_clock::now();
+        scheduler.shutdown();
+        REQUIRE(steady_clock::now() - start < milliseconds(500));
+    }
+}
+
+TEST_CASE("A recurring job's deadline moves with each firing", "[Recurring]") {
+    JobScheduler scheduler(1);
+    scheduler.start();
+
+    std::atomic<int> fired{0};
+    Recurrence recurrence;
+    recurrence.period = milliseconds(30);
+    recurrence.max_firings = 3;
+    auto job = makeRecurring([&fired]() { ++fired; }, recurrence);
+    job->setDeadline(job->getScheduledTime() + milliseconds(500));
+    auto first_deadline = job->getDeadline();
+    scheduler.submit(job);
+
+    REQUIRE(scheduler.waitForIdle(milliseconds(2000)));
+    scheduler.shutdown();
+    REQUIRE(fired.load() == 3);
+    REQUIRE(job->getDeadline() == first_deadline + milliseconds(60));
+    REQUIRE(scheduler.getExecutor()->getJobsExpired() == 0);
+}
+
+TEST_CASE("Recurrence rejects a negative period", "[Recurring]") {
+    auto job = Job::create("", []() {}, nullptr);
+    Recurrence recurrence;
+    recurrence.period = milliseconds(-1);
+    REQUIRE_THROWS_AS(job->setRecurrence(recurrence), std::invalid_argument);
+    REQUIRE_FALSE(job->isRecurring());
+}
@@ -1,7 +1,9 @@
 #include "ExponentialBackoffStrategy.hpp"
 #include "FixedRetryStrategy.hpp"
+#include "JitterRetryStrategy.hpp"
 #include <catch2/catch_test_macros.hpp>
 #include <chrono>
+#include <memory>
 
 using namespace scheduleit;
 
@@ -26,4 +28,19 @@ TEST_CASE("ExponentialBackoffStrategy computes exponential delays", "[RetryStrat
     REQUIRE(strategy.getBackoffDelay(3) == std::chrono::milliseconds(800));
     REQUIRE(strategy.getBackoffDelay(4) == std::chrono::milliseconds(1000)); // capped
     REQUIRE(strategy.getBackoffDelay(5) == std::chrono::milliseconds(1000)); // capped
+}
+
+TEST_CASE("JitterRetryStrategy keeps delays within the jitter window", "[RetryStrategy]") {
+    auto base = std::make_shared<FixedRetryStrategy>(std::chrono::milliseconds(1000));
+    JitterRetryStrategy strategy(base, 0.5);
+
+    REQUIRE(strategy.shouldRetry(0));
+    bool varied = false;
+    for (int i = 0; i < 100; ++i) {
+        auto delay = strategy.getBackoffDelay(i);
+        REQUIRE(delay >= std::chrono::milliseconds(500));
+        REQUIRE(delay <= std::chrono::milliseconds(1000));
+        varied = varied || delay != std::chrono::milliseconds(1000);
+    }
+    REQUIRE(varied);
 }
\ No newline at end of file
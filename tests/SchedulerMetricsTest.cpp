@@ -0,0 +1,128 @@
+#include "JobScheduler.hpp"
+#include "LatencyHistogram.hpp"
+#include "SchedulerMetrics.hpp"
+#include "FixedRetryStrategy.hpp"
+#include "Utils.hpp"
+#include <catch2/catch_test_macros.hpp>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+using namespace scheduleit;
+using namespace std::chrono;
+
+TEST_CASE("LatencyHistogram buckets are exact for small values and within 1/16 above", "[Metrics]") {
+    for (uint64_t value = 0; value < 32; ++value) {
+        REQUIRE(LatencyHistogram::bucketUpperBound(LatencyHistogram::bucketFor(value)) == value);
+    }
+    for (uint64_t value : {32ull, 33ull, 1000ull, 123456789ull, 1ull << 40, ~0ull}) {
+        size_t bucket = LatencyHistogram::bucketFor(value);
+        REQUIRE(bucket < LatencyHistogram::kBucketCount);
+        uint64_t upper = LatencyHistogram::bucketUpperBound(bucket);
+        REQUIRE(upper >= value);
+        REQUIRE(upper - value <= value / 16);
+        REQUIRE(LatencyHistogram::bucketFor(upper) == bucket);
+    }
+    REQUIRE(LatencyHistogram::bucketFor(~0ull) == LatencyHistogram::kBucketCount - 1);
+}
+
+TEST_CASE("HistogramSnapshot merges and answers percentiles", "[Metrics]") {
+    LatencyHistogram low;
+    LatencyHistogram high;
+    for (uint64_t value = 1; value <= 500; ++value) {
+        low.record(value * 1000);
+        high.record((value + 500) * 1000);
+    }
+    HistogramSnapshot snapshot;
+    low.snapshotInto(snapshot);
+    HistogramSnapshot other;
+    high.snapshotInto(other);
+    snapshot.merge(other);
+
+    REQUIRE(snapshot.count == 1000);
+    REQUIRE(snapshot.max == 1000000);
+    REQUIRE(snapshot.mean() == 500500.0);
+    REQUIRE(snapshot.percentile(100) == 1000000);
+    uint64_t median = snapshot.percentile(50);
+    REQUIRE(median >= 500000);
+    REQUIRE(median <= 500000 + 500000 / 16);
+    uint64_t p99 = snapshot.percentile(99);
+    REQUIRE(p99 >= 990000);
+    REQUIRE(p99 <= 1000000);
+    REQUIRE(HistogramSnapshot().percentile(99) == 0);
+}
+
+TEST_CASE("JobScheduler records wait, lag, execution time and retries of every run", "[Metrics]") {
+    JobScheduler scheduler(2);
+    scheduler.start();
+    auto retry = std::make_shared<FixedRetryStrategy>(milliseconds(1));
+    std::vector<std::shared_ptr<Job>> jobs;
+    for (int i = 0; i < 20; ++i) {
+        jobs.push_back(Job::create("", []() {}, retry, milliseconds(0), 0));
+    }
+    scheduler.submitBatch(std::move(jobs));
+    auto failures = std::make_shared<std::atomic<int>>(0);
+    scheduler.submit(Job::create("", [failures]() {
+        if (failures->fetch_add(1) == 0) {
+            throw std::runtime_error("first attempt fails");
+        }
+    }, retry, milliseconds(0), 3));
+    scheduler.submit(Job::create("", []() { utils::sleepForMillis(milliseconds(5)); }, retry, milliseconds(50), 0));
+    REQUIRE(scheduler.waitForIdle(milliseconds(5000)));
+
+    auto metrics = scheduler.getMetrics();
+    REQUIRE(metrics.execution.count == 23);   // 21 jobs plus the failed first attempt
+    REQUIRE(metrics.dispatch_lag.count == 23);
+    REQUIRE(metrics.queue_wait.count == 23);
+    REQUIRE(metrics.retries.count == 22);     // once per job, when it stops being retried
+    REQUIRE(metrics.retries.max == 1);
+    REQUIRE(metrics.queue_wait.max >= static_cast<uint64_t>(nanoseconds(milliseconds(49)).count()));
+    REQUIRE(metrics.execution.max >= static_cast<uint64_t>(nanoseconds(milliseconds(5)).count()));
+
+    MetricsSnapshot merged;
+    for (const auto& worker : scheduler.getWorkerMetrics()) {
+        merged.merge(worker);
+    }
+    REQUIRE(merged.execution.count == metrics.execution.count);
+    REQUIRE(merged.retries.sum == metrics.retries.sum);
+    scheduler.shutdown();
+}
+
+TEST_CASE("SchedulerMetrics can be read while workers record", "[Metrics]") {
+    SchedulerMetrics metrics;
+    std::atomic<bool> done{false};
+    bool monotonic = true;
+    std::vector<std::thread> workers;
+    for (int t = 0; t < 3; ++t) {
+        workers.emplace_back([&metrics]() {
+            for (int i = 0; i < 20000; ++i) {
+                metrics.recordExecution(nanoseconds(i));
+            }
+        });
+    }
+    std::thread reader([&]() {
+        uint64_t last = 0;
+        while (!done) {
+            uint64_t count = metrics.snapshot().execution.count;
+            monotonic = monotonic && count >= last;
+            last = count;
+        }
+    });
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    done = true;
+    reader.join();
+    REQUIRE(monotonic);
+    REQUIRE(metrics.snapshotWorkers().size() == 3);
+    REQUIRE(metrics.snapshot().execution.count == 60000);
+
+    SchedulerOptions options;
+    options.collect_metrics = false;
+    JobScheduler scheduler(1, options);
+    REQUIRE(scheduler.getMetrics().execution.count == 0);
+    REQUIRE(scheduler.getWorkerMetrics().empty());
+}
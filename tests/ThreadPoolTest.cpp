@@ -3,6 +3,9 @@
 #include "ThreadPool.hpp"
 #include <atomic>
 #include <chrono>
+#include <functional>
+#include <memory>
+#include <stdexcept>
 #include <thread>
 #include <vector>
 
@@ -47,4 +50,220 @@ TEST_CASE("ThreadPool enforces max queue size if specified", "[threadpool][queue
 
     pool.shutdown();
     REQUIRE(counter == 4);
-}
\ No newline at end of file
+}
+
+TEST_CASE("Work-stealing ThreadPool runs nested submissions", "[threadpool][stealing]") {
+    ThreadPoolOptions options;
+    options.work_stealing = true;
+    ThreadPool pool(4, options);
+
+    std::atomic<int> counter{0};
+    std::vector<std::future<void>> futures;
+    for (int i = 0; i < 8; ++i) {
+        futures.emplace_back(pool.submit([&pool, &counter]() {
+            // Children land on this worker's deque and may be stolen by idle workers.
+            for (int j = 0; j < 100; ++j) {
+                pool.submit([&counter]() { ++counter; });
+            }
+        }));
+    }
+    for (auto& fut : futures) {
+        fut.wait();
+    }
+
+    pool.shutdown();
+    REQUIRE(counter == 800);
+}
+
+TEST_CASE("Work-stealing ThreadPool enforces max queue size", "[threadpool][stealing]") {
+    ThreadPoolOptions options;
+    options.work_stealing = true;
+    options.max_queue_size = 2;
+    ThreadPool pool(2, options);
+
+    // Occupy both workers so that nothing leaves the queue.
+    std::atomic<bool> gate{false};
+    std::atomic<int> started{0};
+    std::atomic<int> counter{0};
+    auto blocker = [&gate, &started, &counter]() {
+        ++started;
+        while (!gate.load()) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        ++counter;
+    };
+    std::vector<std::future<void>> futures;
+    futures.emplace_back(pool.submit(blocker));
+    futures.emplace_back(pool.submit(blocker));
+    while (started.load() < 2) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    // Two more fill the queue; a third from a non-worker thread must wait for room.
+    futures.emplace_back(pool.submit([&counter]() { ++counter; }));
+    futures.emplace_back(pool.submit([&counter]() { ++counter; }));
+    std::atomic<bool> submitted{false};
+    std::thread producer([&]() {
+        pool.submitDetached([&counter]() { ++counter; });
+        submitted = true;
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    REQUIRE_FALSE(submitted.load());
+    REQUIRE(counter == 0);
+
+    gate = true;
+    producer.join();
+    REQUIRE(submitted.load());
+    for (auto& fut : futures) {
+        fut.wait();
+    }
+
+    pool.shutdown();
+    REQUIRE(counter == 5);
+}
+
+TEST_CASE("ThreadPool submitDetached runs move-only tasks without a future", "[threadpool]") {
+    for (bool stealing : {false, true}) {
+        ThreadPoolOptions options;
+        options.work_stealing = stealing;
+        ThreadPool pool(2, options);
+
+        std::atomic<int> sum{0};
+        for (int i = 1; i <= 100; ++i) {
+            auto value = std::make_unique<int>(i);
+            pool.submitDetached([&sum, value = std::move(value)]() { sum += *value; });
+        }
+        pool.submitDetached([&sum](int extra) { sum += extra; }, 1000);
+        pool.submitDetached([]() { throw std::runtime_error("ignored"); });
+
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+        while (sum.load() != 6050 && std::chrono::steady_clock::now() < deadline) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        pool.shutdown();
+        REQUIRE(sum.load() == 6050);
+    }
+}
+
+TEST_CASE("ThreadPool submitBulk fills a bounded queue without deadlocking", "[threadpool][queue]") {
+    for (bool stealing : {false, true}) {
+        ThreadPoolOptions options;
+        options.max_queue_size = 4;
+        options.work_stealing = stealing;
+        ThreadPool pool(2, options);
+
+        std::atomic<int> counter{0};
+        std::vector<std::function<void()>> tasks(100, [&counter]() { ++counter; });
+        pool.submitBulk(tasks.begin(), tasks.end());
+
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+        while (counter.load() != 100 && std::chrono::steady_clock::now() < deadline) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        pool.shutdown();
+        REQUIRE(counter.load() == 100);
+    }
+}
+
+TEST_CASE("Work-stealing ThreadPool keeps the bound under mixed concurrent submissions", "[threadpool][stealing]") {
+    ThreadPoolOptions options;
+    options.work_stealing = true;
+    options.max_queue_size = 8;
+    ThreadPool pool(3, options);
+
+    std::atomic<int> done{0};
+    std::atomic<size_t> most_queued{0};
+    auto sample = [&pool, &most_queued]() {
+        size_t queued = pool.getQueuedTasks();
+        size_t most = most_queued.load();
+        while (queued > most && !most_queued.compare_exchange_weak(most, queued)) {
+        }
+    };
+    auto leaf = [&done, &sample]() {
+        sample();
+        ++done;
+    };
+    // Workers push onto their own deques, one task at a time and in bulk, while two outside
+    // threads inject in bulk; every path has to respect the same bound.
+    auto parent = [&pool, &leaf, &done]() {
+        for (int i = 0; i < 3; ++i) {
+            pool.submitDetached(leaf);
+        }
+        std::vector<std::function<void()>> batch(3, leaf);
+        pool.submitBulk(batch.begin(), batch.end());
+        ++done;
+    };
+    std::thread parents([&]() {
+        std::vector<std::function<void()>> batch(2000, parent);
+        pool.submitBulk(batch.begin(), batch.end());
+    });
+    std::thread leaves([&]() {
+        for (int i = 0; i < 2000; ++i) {
+            std::vector<std::function<void()>> batch(5, leaf);
+            pool.submitBulk(batch.begin(), batch.end());
+        }
+    });
+
+    constexpr int kTotal = 2000 + 2000 * 6 + 2000 * 5;
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    while (done.load() != kTotal && std::chrono::steady_clock::now() < deadline) {
+        sample();
+        std::this_thread::yield();
+    }
+    parents.join();
+    leaves.join();
+    pool.shutdown();
+    REQUIRE(done.load() == kTotal);
+    REQUIRE(most_queued.load() <= 8);
+    REQUIRE(pool.getQueuedTasks() == 0);
+}
+
+TEST_CASE("Elastic ThreadPool grows for blocking tasks and shrinks when idle", "[threadpool][elastic]") {
+    ThreadPoolOptions options;
+    options.elastic.min_threads = 1;
+    options.elastic.max_threads = 16;
+    options.elastic.interval = std::chrono::milliseconds(2);
+    options.elastic.grow_after = std::chrono::milliseconds(4);
+    options.elastic.shrink_after = std::chrono::milliseconds(40);
+    ThreadPool pool(2, options);
+
+    // Sleeping tasks use no CPU, so the controller adds workers while they queue up.
+    std::atomic<int> counter{0};
+    for (int i = 0; i < 200; ++i) {
+        pool.submitDetached([&counter]() {
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+            ++counter;
+        });
+    }
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    while (counter.load() != 200 && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    REQUIRE(counter.load() == 200);
+    ElasticStats grown = pool.getElasticStats();
+    REQUIRE(grown.grow_decisions > 0);
+    REQUIRE(grown.peak_workers > 2);
+    REQUIRE(grown.peak_workers <= 16);
+
+    // Idle now: back down to the minimum, one decision at a time.
+    while (pool.getElasticStats().workers > 1 && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    ElasticStats shrunk = pool.getElasticStats();
+    REQUIRE(shrunk.workers == 1);
+    REQUIRE(shrunk.shrink_decisions > 0);
+
+    // The remaining worker still runs tasks.
+    REQUIRE(pool.submit([]() { return 7; }).get() == 7);
+    pool.shutdown();
+}
+
+TEST_CASE("Elastic ThreadPool rejects bounds it cannot honour", "[threadpool][elastic]") {
+    ThreadPoolOptions options;
+    options.elastic.min_threads = 2;
+    options.elastic.max_threads = 4;
+    REQUIRE_THROWS_AS(ThreadPool(1, options), std::invalid_argument);
+    REQUIRE_THROWS_AS(ThreadPool(5, options), std::invalid_argument);
+    options.work_stealing = true;
+    REQUIRE_THROWS_AS(ThreadPool(2, options), std::invalid_argument);
+}
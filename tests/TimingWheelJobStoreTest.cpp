@@ -0,0 +1,54 @@
+#include "TimingWheelJobStore.hpp"
+#include "JobQueue.hpp"
+#include "Job.hpp"
+#include "Utils.hpp"
+#include <catch2/catch_test_macros.hpp>
+#include <chrono>
+#include <memory>
+#include <vector>
+
+using namespace scheduleit;
+
+TEST_CASE("TimingWheelJobStore never releases a job before its scheduled time", "[TimingWheel]") {
+    auto origin = utils::now();
+    TimingWheelJobStore store(std::chrono::milliseconds(1), 2, origin);
+
+    // Spans level 0, level 1 and the overflow list (2 levels cover 65536 ticks).
+    std::vector<long> delays_ms = {0, 3, 255, 256, 1000, 65535, 70000, 500000};
+    for (auto delay : delays_ms) {
+        store.push(std::make_shared<Job>(std::to_string(delay), [] {}, nullptr,
+                                         std::chrono::milliseconds(delay)));
+    }
+    REQUIRE(store.size() == delays_ms.size());
+
+    std::vector<std::string> released;
+    for (long ms = 0; ms <= 600000; ms += 7) {
+        auto now = origin + std::chrono::milliseconds(ms);
+        while (auto job = store.popReady(now)) {
+            REQUIRE(job->getScheduledTime() <= now);
+            REQUIRE(job->getScheduledTime() > now - std::chrono::milliseconds(8));
+            released.push_back(job->getId());
+        }
+    }
+
+    REQUIRE(store.empty());
+    REQUIRE(released.size() == delays_ms.size());
+    for (size_t i = 0; i < delays_ms.size(); ++i) {
+        REQUIRE(released[i] == std::to_string(delays_ms[i]));
+    }
+}
+
+TEST_CASE("JobQueue with timing wheel backend orders and blocks like the heap", "[TimingWheel]") {
+    QueueOptions options;
+    options.backend = QueueBackend::TimingWheel;
+    JobQueue queue(options);
+
+    queue.enqueue(std::make_shared<Job>("job1", [] {}, nullptr, std::chrono::milliseconds(100)));
+    queue.enqueue(std::make_shared<Job>("job2", [] {}, nullptr, std::chrono::milliseconds(10)));
+
+    auto start = std::chrono::system_clock::now();
+    REQUIRE(queue.dequeueReady()->getId() == "job2");
+    REQUIRE(queue.dequeueReady()->getId() == "job1");
+    REQUIRE(std::chrono::system_clock::now() - start >= std::chrono::milliseconds(90));
+    REQUIRE(queue.dequeueReady() == nullptr);
+}
@@ -0,0 +1,58 @@
+#include "UniqueFunction.hpp"
+#include "Job.hpp"
+#include <catch2/catch_test_macros.hpp>
+#include <array>
+#include <functional>
+#include <chrono>
+#include <memory>
+
+using namespace scheduleit;
+
+TEST_CASE("UniqueFunction holds move-only targets of any size", "[UniqueFunction]") {
+    auto value = std::make_unique<int>(41);
+    UniqueFunction<int(int)> small([value = std::move(value)](int delta) { return *value + delta; });
+    REQUIRE(small(1) == 42);
+
+    std::array<int, 64> large{};
+    large[63] = 7;
+    UniqueFunction<int()> big([large]() { return large[63]; });
+    REQUIRE(big() == 7);
+
+    // Moving transfers the target in both the inline and the heap case.
+    UniqueFunction<int(int)> moved_small = std::move(small);
+    UniqueFunction<int()> moved_big = std::move(big);
+    REQUIRE_FALSE(small);
+    REQUIRE_FALSE(big);
+    REQUIRE(moved_small(2) == 43);
+    REQUIRE(moved_big() == 7);
+}
+
+TEST_CASE("UniqueFunction treats null targets as empty and destroys captures once", "[UniqueFunction]") {
+    void (*no_function)() = nullptr;
+    UniqueFunction<void()> from_null_pointer(no_function);
+    UniqueFunction<void()> from_empty_function(std::function<void()>{});
+    REQUIRE_FALSE(from_null_pointer);
+    REQUIRE_FALSE(from_empty_function);
+    REQUIRE_THROWS_AS(from_null_pointer(), std::bad_function_call);
+
+    auto tracker = std::make_shared<int>(0);
+    {
+        UniqueFunction<void()> first([tracker]() {});
+        UniqueFunction<void()> second = std::move(first);
+        REQUIRE(tracker.use_count() == 2);
+        second = nullptr;
+        REQUIRE(tracker.use_count() == 1);
+    }
+    REQUIRE(tracker.use_count() == 1);
+}
+
+TEST_CASE("Job accepts tasks with move-only captures", "[UniqueFunction]") {
+    auto payload = std::make_unique<int>(0);
+    int* raw = payload.get();
+    Job job("move-only", [payload = std::move(payload)]() { ++*payload; }, nullptr,
+            std::chrono::milliseconds(0), 0);
+
+    job.execute();
+    job.execute();
+    REQUIRE(*raw == 2);
+}
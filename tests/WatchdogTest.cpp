@@ -0,0 +1,130 @@
+#include "Watchdog.hpp"
+#include "FixedRetryStrategy.hpp"
+#include "JobScheduler.hpp"
+#include "ThreadPool.hpp"
+#include "Utils.hpp"
+#include <catch2/catch_test_macros.hpp>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <thread>
+#include <vector>
+
+using namespace scheduleit;
+using namespace std::chrono;
+
+namespace {
+
+class TimeoutObserver : public Observer {
+public:
+    void onJobFailed(const Job&, int) override {
+        ++failed;
+    }
+    void onJobSuccess(const Job&) override {
+        ++succeeded;
+    }
+    void onJobTimedOut(const Job&, int attempt) override {
+        ++timed_out;
+        last_attempt = attempt;
+    }
+    std::atomic<int> succeeded{0};
+    std::atomic<int> failed{0};
+    std::atomic<int> timed_out{0};
+    std::atomic<int> last_attempt{-1};
+};
+
+}
+
+TEST_CASE("Watchdog times out only work that is still running", "[Watchdog]") {
+    Watchdog watchdog;
+    std::atomic<int> callbacks{0};
+    std::vector<std::shared_ptr<CancellationState>> states;
+    for (int i = 0; i < 100; ++i) {
+        states.push_back(std::make_shared<CancellationState>());
+        watchdog.watch(states.back(), Watchdog::Clock::now() + milliseconds(20 + i % 10), [&]() { ++callbacks; });
+    }
+    // Half finish in time, one is cancelled by hand.
+    for (int i = 0; i < 100; i += 2) {
+        REQUIRE(states[i]->finish());
+    }
+    CancellationSource source;
+    watchdog.watch(source.getState(), Watchdog::Clock::now() + milliseconds(20));
+    REQUIRE(source.cancel());
+
+    for (int i = 1; i < 100; i += 2) {
+        states[i]->waitForExpiry();
+        REQUIRE(states[i]->getReason() == CancellationReason::TimedOut);
+        REQUIRE_FALSE(states[i]->finish());
+    }
+    REQUIRE(callbacks.load() == 50);
+    REQUIRE(watchdog.getExpiredCount() == 50);
+    REQUIRE(states[0]->getReason() == CancellationReason::None);
+    REQUIRE(source.getToken().getReason() == CancellationReason::Cancelled);
+    REQUIRE_THROWS_AS(source.getToken().throwIfCancelled(), TaskCancelledError);
+}
+
+TEST_CASE("An overrunning job is reported, counted as failed and retried", "[Watchdog]") {
+    JobScheduler scheduler(1);
+    auto observer = std::make_shared<TimeoutObserver>();
+    scheduler.getExecutor()->registerObserver(observer);
+    scheduler.start();
+
+    // Polls its token and gives up once the watchdog flags it; always overruns.
+    auto cooperative = Job::create("cooperative", []() {
+        CancellationToken token = Job::current()->getCancellationToken();
+        auto give_up = steady_clock::now() + seconds(5);
+        while (steady_clock::now() < give_up) {
+            token.throwIfCancelled();
+            std::this_thread::sleep_for(milliseconds(1));
+        }
+    }, std::make_shared<FixedRetryStrategy>(milliseconds(1)), milliseconds(0), 2);
+    cooperative->setTimeout(milliseconds(20));
+
+    // Ignores its token but returns late: still a failure.
+    auto stubborn = Job::create("stubborn", []() { utils::sleepForMillis(milliseconds(40)); }, nullptr,
+                                milliseconds(0), 0);
+    stubborn->setTimeout(milliseconds(10));
+
+    // Finishes in time: the timeout never shows.
+    auto quick = Job::create("quick", []() {}, nullptr, milliseconds(0), 0);
+    quick->setTimeout(milliseconds(1000));
+
+    auto start = steady_clock::now();
+    scheduler.submit(cooperative);
+    scheduler.submit(stubborn);
+    scheduler.submit(quick);
+    REQUIRE(scheduler.waitForIdle(milliseconds(5000)));
+    REQUIRE(steady_clock::now() - start < seconds(2));
+
+    REQUIRE(observer->timed_out.load() == 4);  // three attempts of one job, one of the other
+    REQUIRE(observer->failed.load() == 4);
+    REQUIRE(observer->succeeded.load() == 1);
+    REQUIRE(cooperative->getAttempt() == 2);
+    REQUIRE(scheduler.getExecutor()->getTimeouts() == 4);
+    scheduler.shutdown();
+}
+
+TEST_CASE("ThreadPool::submitWithTimeout hands the task a token instead of a thread", "[Watchdog]") {
+    ThreadPool pool(1);
+    std::atomic<bool> stopped{false};
+    std::atomic<bool> ran_on_worker{false};
+    std::thread::id caller = std::this_thread::get_id();
+    pool.submitWithTimeout([&](CancellationToken token) {
+        ran_on_worker = std::this_thread::get_id() != caller;
+        auto give_up = steady_clock::now() + seconds(5);
+        while (!token.isCancelled() && steady_clock::now() < give_up) {
+            std::this_thread::sleep_for(milliseconds(1));
+        }
+        stopped = token.getReason() == CancellationReason::TimedOut;
+    }, milliseconds(20));
+
+    std::atomic<int> plain{0};
+    pool.submitWithTimeout([&]() { ++plain; }, milliseconds(1000));
+    pool.submitWithTimeout([&]() { ++plain; }, milliseconds(0));
+    auto done = pool.submit([]() {});
+    REQUIRE(done.wait_for(seconds(2)) == std::future_status::ready);
+    REQUIRE(stopped.load());
+    REQUIRE(ran_on_worker.load());
+    REQUIRE(plain.load() == 2);
+    pool.shutdown();
+}
@@ -0,0 +1,164 @@
+#if defined(__cpp_impl_coroutine)
+
+#include "Workflow.hpp"
+#include "JobScheduler.hpp"
+#include "Utils.hpp"
+#include <catch2/catch_test_macros.hpp>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+using namespace scheduleit;
+using namespace std::chrono;
+
+namespace {
+
+class CountingObserver : public Observer {
+public:
+    void onJobFailed(const Job&, int) override {
+        ++failed;
+    }
+    void onJobSuccess(const Job&) override {
+        ++succeeded;
+    }
+    void onJobCancelled(const Job&) override {
+        ++cancelled;
+    }
+    std::atomic<int> succeeded{0};
+    std::atomic<int> failed{0};
+    std::atomic<int> cancelled{0};
+};
+
+Workflow sleeper(JobScheduler& scheduler, int steps, milliseconds pause, std::atomic<int>& done_steps) {
+    for (int i = 0; i < steps; ++i) {
+        co_await scheduler.sleep(pause);
+        ++done_steps;
+    }
+}
+
+Workflow awaiter(std::shared_ptr<Job> child, std::atomic<int>& result) {
+    bool ok = co_await child;
+    result = ok ? 1 : 0;
+}
+
+Workflow thrower(JobScheduler& scheduler) {
+    co_await scheduler.sleep(milliseconds(1));
+    throw std::runtime_error("step failed");
+}
+
+}
+
+TEST_CASE("A sleeping workflow does not hold its worker", "[Workflow]") {
+    JobScheduler scheduler(1);
+    auto observer = std::make_shared<CountingObserver>();
+    scheduler.getExecutor()->registerObserver(observer);
+    scheduler.start();
+
+    std::atomic<int> steps{0};
+    auto start = steady_clock::now();
+    scheduler.submit(sleeper(scheduler, 3, milliseconds(30), steps).intoJob("sleeper"));
+    // With the only worker free between steps, plain jobs finish long before the workflow.
+    std::atomic<int> plain{0};
+    for (int i = 0; i < 10; ++i) {
+        scheduler.submit(Job::create("", [&]() { ++plain; }, nullptr, milliseconds(0), 0));
+    }
+    while (plain.load() < 10 && steady_clock::now() - start < seconds(2)) {
+        utils::sleepForMillis(milliseconds(1));
+    }
+    REQUIRE(plain.load() == 10);
+    REQUIRE(steps.load() < 3);
+
+    REQUIRE(scheduler.waitForIdle(milliseconds(2000)));
+    REQUIRE(steps.load() == 3);
+    REQUIRE(steady_clock::now() - start >= milliseconds(90));
+    REQUIRE(scheduler.getExecutor()->getSuspensions() == 3);
+    REQUIRE(observer->succeeded.load() == 11);  // the workflow counts once, when it returns
+    scheduler.shutdown();
+}
+
+TEST_CASE("A workflow can await another job", "[Workflow]") {
+    JobScheduler scheduler(2);
+    scheduler.start();
+
+    SECTION("that succeeds later") {
+        auto child = Job::create("child", []() { utils::sleepForMillis(milliseconds(20)); }, nullptr,
+                                 milliseconds(10), 0);
+        std::atomic<int> result{-1};
+        scheduler.submit(awaiter(child, result).intoJob());
+        scheduler.submit(child);
+        REQUIRE(scheduler.waitForIdle(milliseconds(2000)));
+        REQUIRE(result.load() == 1);
+    }
+
+    SECTION("that fails") {
+        auto child = Job::create("child", []() { throw std::runtime_error("boom"); }, nullptr, milliseconds(0), 0);
+        std::atomic<int> result{-1};
+        scheduler.submit(child);
+        scheduler.submit(awaiter(child, result).intoJob());
+        REQUIRE(scheduler.waitForIdle(milliseconds(2000)));
+        REQUIRE(result.load() == 0);
+    }
+
+    SECTION("that has already finished") {
+        auto child = Job::create("child", []() {}, nullptr, milliseconds(0), 0);
+        scheduler.submit(child);
+        REQUIRE(scheduler.waitForIdle(milliseconds(2000)));
+        std::atomic<int> result{-1};
+        scheduler.submit(awaiter(child, result).intoJob());
+        REQUIRE(scheduler.waitForIdle(milliseconds(2000)));
+        REQUIRE(result.load() == 1);
+        REQUIRE(scheduler.getExecutor()->getSuspensions() == 0);
+    }
+
+    SECTION("that is another workflow") {
+        std::atomic<int> steps{0};
+        auto child = sleeper(scheduler, 2, milliseconds(5), steps).intoJob();
+        std::atomic<int> result{-1};
+        scheduler.submit(awaiter(child, result).intoJob());
+        scheduler.submit(child);
+        REQUIRE(scheduler.waitForIdle(milliseconds(2000)));
+        REQUIRE(steps.load() == 2);
+        REQUIRE(result.load() == 1);
+    }
+    scheduler.shutdown();
+}
+
+TEST_CASE("Thousands of workflows share two workers", "[Workflow]") {
+    JobScheduler scheduler(2);
+    scheduler.start();
+    constexpr int kWorkflows = 10000;
+    std::atomic<int> steps{0};
+    std::vector<std::shared_ptr<Job>> jobs;
+    for (int i = 0; i < kWorkflows; ++i) {
+        jobs.push_back(sleeper(scheduler, 2, milliseconds(1 + i % 20), steps).intoJob());
+    }
+    scheduler.submitBatch(std::move(jobs));
+    REQUIRE(scheduler.waitForIdle(milliseconds(10000)));
+    REQUIRE(steps.load() == 2 * kWorkflows);
+    REQUIRE(scheduler.getExecutor()->getSuspensions() == 2 * kWorkflows);
+    scheduler.shutdown();
+}
+
+TEST_CASE("A workflow that throws fails once, and a sleeping one can be cancelled", "[Workflow]") {
+    JobScheduler scheduler(1);
+    auto observer = std::make_shared<CountingObserver>();
+    scheduler.getExecutor()->registerObserver(observer);
+    scheduler.start();
+
+    scheduler.submit(thrower(scheduler).intoJob("thrower"));
+    std::atomic<int> steps{0};
+    auto handle = scheduler.submit(sleeper(scheduler, 1, hours(1), steps).intoJob("long"));
+    while (scheduler.getExecutor()->getSuspensions() < 2) {  // both have taken their first step
+        utils::sleepForMillis(milliseconds(1));
+    }
+    REQUIRE(handle.cancel());
+    REQUIRE(scheduler.waitForIdle(milliseconds(2000)));
+    REQUIRE(observer->failed.load() == 1);
+    REQUIRE(observer->cancelled.load() == 1);
+    REQUIRE(steps.load() == 0);
+    scheduler.shutdown();
+}
+
+#endif